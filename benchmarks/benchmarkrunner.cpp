@@ -0,0 +1,174 @@
+#include "benchmarkrunner.h"
+#include "syntheticrepository.h"
+#include "branchlistmodel.h"
+#include "commitstore.h"
+#include "gitmanager.h"
+#include "repositorybrowser.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QJsonArray>
+#include <QTreeView>
+#include <algorithm>
+
+namespace {
+
+const int FirstPaintTimeoutMs = 10 * 60 * 1000;
+const int HistoryLimit = 1000;
+
+class FirstPaintWatcher : public QObject
+{
+public:
+    explicit FirstPaintWatcher(QTreeView *view)
+        : m_view(view)
+        , m_painted(false)
+    {
+        m_view->viewport()->installEventFilter(this);
+    }
+    
+    bool painted() const { return m_painted; }
+    
+    bool eventFilter(QObject *watched, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint && m_view->model() && m_view->model()->rowCount() > 0) {
+            m_painted = true;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+
+private:
+    QTreeView *m_view;
+    bool m_painted;
+};
+
+double elapsedMs(const QElapsedTimer &timer)
+{
+    return timer.nsecsElapsed() / 1000000.0;
+}
+
+}
+
+BenchmarkRunner::BenchmarkRunner(int iterations)
+    : m_iterations(qMax(1, iterations))
+{
+}
+
+QJsonObject BenchmarkRunner::run(const SyntheticRepository &repository)
+{
+    const QString path = repository.path();
+    QJsonObject metrics;
+    
+    QList<double> firstPaint;
+    for (int i = 0; i < m_iterations; ++i) {
+        firstPaint << measureOpenToFirstPaint(path);
+    }
+    metrics["openToFirstPaint"] = summarize(firstPaint);
+    
+    GitManager gitManager;
+    gitManager.openRepository(path);
+    
+    auto cold = [&gitManager]() { gitManager.notifyRepositoryChanged(); };
+    auto none = []() {};
+    
+    metrics["fileStatus"] = sample(none, [&gitManager]() {
+        gitManager.getFileStatus();
+    });
+    metrics["commitHistory"] = sample(none, [&path]() {
+        CommitStore store;
+        GitManager::loadCommitStore(path, HistoryLimit, store);
+    });
+    metrics["commitHistoryFromGraph"] = sample(cold, [&gitManager]() {
+        gitManager.getCommitHistory(HistoryLimit);
+    });
+    metrics["fileDiff"] = sample(none, [&gitManager]() {
+        gitManager.getFileDiff(SyntheticRepository::largeDiffFile());
+    });
+    metrics["branchListing"] = sample(cold, [&gitManager]() {
+        gitManager.getBranchRefs();
+    });
+    
+    const QList<GitBranchRef> branches = gitManager.getBranchRefs();
+    metrics["branchModelPopulation"] = sample(none, [&path, &branches]() {
+        BranchListModel model;
+        model.setBranches(path, branches);
+        for (int row = 0; row < model.rowCount(); ++row) {
+            model.data(model.index(row, BranchListModel::NameColumn));
+            model.data(model.index(row, BranchListModel::DateColumn));
+            model.data(model.index(row, BranchListModel::SubjectColumn));
+        }
+    });
+    
+    QJsonObject result = repository.spec().toJson();
+    result["path"] = path;
+    result["reused"] = repository.wasReused();
+    result["generationMs"] = repository.generationMs();
+    result["iterations"] = m_iterations;
+    result["metrics"] = metrics;
+    return result;
+}
+
+QJsonObject BenchmarkRunner::sample(const std::function<void()> &setup, const std::function<void()> &operation) const
+{
+    QList<double> samples;
+    for (int i = 0; i < m_iterations; ++i) {
+        setup();
+        QElapsedTimer timer;
+        timer.start();
+        operation();
+        samples << elapsedMs(timer);
+    }
+    return summarize(samples);
+}
+
+double BenchmarkRunner::measureOpenToFirstPaint(const QString &path) const
+{
+    GitManager gitManager;
+    RepositoryBrowser browser(&gitManager);
+    browser.resize(1024, 768);
+    browser.show();
+    QApplication::processEvents();
+    
+    QTreeView *view = browser.findChild<QTreeView *>();
+    if (!view) {
+        return -1;
+    }
+    FirstPaintWatcher watcher(view);
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    if (!gitManager.openRepository(path)) {
+        return -1;
+    }
+    browser.refresh();
+    
+    while (!watcher.painted() && timer.elapsed() < FirstPaintTimeoutMs) {
+        QApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    
+    return watcher.painted() ? elapsedMs(timer) : -1;
+}
+
+QJsonObject BenchmarkRunner::summarize(const QList<double> &samples)
+{
+    QList<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    
+    QJsonArray values;
+    double total = 0;
+    for (double value : samples) {
+        values.append(value);
+        total += value;
+    }
+    
+    QJsonObject summary;
+    if (!sorted.isEmpty()) {
+        const int middle = sorted.size() / 2;
+        summary["medianMs"] = sorted.size() % 2 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+        summary["minMs"] = sorted.first();
+        summary["maxMs"] = sorted.last();
+        summary["meanMs"] = total / sorted.size();
+    }
+    summary["samplesMs"] = values;
+    return summary;
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <functional>
+
+class SyntheticRepository;
+
+class BenchmarkRunner
+{
+public:
+    explicit BenchmarkRunner(int iterations);
+    
+    QJsonObject run(const SyntheticRepository &repository);
+
+private:
+    QJsonObject sample(const std::function<void()> &setup, const std::function<void()> &operation) const;
+    double measureOpenToFirstPaint(const QString &path) const;
+    
+    static QJsonObject summarize(const QList<double> &samples);
+    
+    int m_iterations;
+};
+
+#endif // BENCHMARKRUNNER_H
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSysInfo>
+#include <QTextStream>
+#include "benchmarkrunner.h"
+#include "syntheticrepository.h"
+#include "gitmanager.h"
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    
+    QApplication app(argc, argv);
+    app.setApplicationName("srikok-bench");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("Srikoksoft");
+    
+    QStringList scaleNames;
+    for (const SyntheticRepositorySpec &spec : SyntheticRepository::builtinSpecs()) {
+        scaleNames << spec.name;
+    }
+    
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates synthetic repositories and times core Srikok Git operations.");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption scaleOption({"s", "scale"}, "Scale to run (" + scaleNames.join(", ") + "); repeatable.", "name");
+    QCommandLineOption iterationsOption({"n", "iterations"}, "Samples per measurement.", "count", "5");
+    QCommandLineOption workDirOption({"w", "work-dir"}, "Directory for the generated repositories.", "path",
+                                     QDir::temp().filePath("srikok-bench"));
+    QCommandLineOption outputOption({"o", "output"}, "JSON results file.", "file", "benchmark-results.json");
+    QCommandLineOption regenerateOption("regenerate", "Regenerate repositories even if an up-to-date copy exists.");
+    parser.addOption(scaleOption);
+    parser.addOption(iterationsOption);
+    parser.addOption(workDirOption);
+    parser.addOption(outputOption);
+    parser.addOption(regenerateOption);
+    parser.process(app);
+    
+    QStringList selected = parser.values(scaleOption);
+    if (selected.isEmpty()) {
+        selected << "small" << "medium";
+    }
+    
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    
+    QList<SyntheticRepositorySpec> specs;
+    for (const QString &name : selected) {
+        bool found = false;
+        for (const SyntheticRepositorySpec &spec : SyntheticRepository::builtinSpecs()) {
+            if (spec.name == name) {
+                specs << spec;
+                found = true;
+            }
+        }
+        if (!found) {
+            err << "Unknown scale: " << name << Qt::endl;
+            return 1;
+        }
+    }
+    
+    QString gitVersion;
+    GitManager::runGitCommand(QDir::currentPath(), {"--version"}, gitVersion);
+    
+    QJsonObject host;
+    host["os"] = QSysInfo::prettyProductName();
+    host["kernel"] = QSysInfo::kernelVersion();
+    host["cpu"] = QSysInfo::currentCpuArchitecture();
+    host["hostname"] = QSysInfo::machineHostName();
+    
+    QJsonObject report;
+    report["application"] = app.applicationName();
+    report["version"] = app.applicationVersion();
+    report["qtVersion"] = QString(qVersion());
+    report["gitVersion"] = gitVersion.trimmed();
+    report["timestamp"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    report["host"] = host;
+    
+    BenchmarkRunner runner(parser.value(iterationsOption).toInt());
+    QJsonArray scenarios;
+    
+    for (const SyntheticRepositorySpec &spec : specs) {
+        out << "Preparing " << spec.name << " (" << spec.files << " files, " << spec.commits << " commits, "
+            << spec.branches << " branches)..." << Qt::endl;
+        
+        SyntheticRepository repository(spec);
+        if (!repository.prepare(QDir(parser.value(workDirOption)).filePath(spec.name), !parser.isSet(regenerateOption))) {
+            err << "Failed to prepare " << spec.name << ": " << repository.lastError() << Qt::endl;
+            return 1;
+        }
+        
+        out << "Running " << spec.name << "..." << Qt::endl;
+        QJsonObject scenario = runner.run(repository);
+        const QJsonObject metrics = scenario["metrics"].toObject();
+        for (auto it = metrics.begin(); it != metrics.end(); ++it) {
+            out << "  " << it.key() << ": " << it.value().toObject()["medianMs"].toDouble() << " ms" << Qt::endl;
+        }
+        scenarios.append(scenario);
+    }
+    report["scenarios"] = scenarios;
+    
+    QFile file(parser.value(outputOption));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        err << "Cannot write " << file.fileName() << Qt::endl;
+        return 1;
+    }
+    file.write(QJsonDocument(report).toJson());
+    out << "Results written to " << QFileInfo(file).absoluteFilePath() << Qt::endl;
+    
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include "syntheticrepository.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QTemporaryFile>
+
+namespace {
+
+const int BlobCount = 64;
+const qint64 BaseTimestamp = 1600000000;
+const char *MarkerFile = "srikok-benchmark.json";
+
+class StreamWriter
+{
+public:
+    explicit StreamWriter(QFile &file) : m_file(file) {}
+    ~StreamWriter() { flush(); }
+    
+    StreamWriter &operator<<(const QByteArray &data)
+    {
+        m_buffer += data;
+        if (m_buffer.size() >= 1024 * 1024) {
+            flush();
+        }
+        return *this;
+    }
+    
+    StreamWriter &operator<<(const char *data) { return *this << QByteArray(data); }
+    StreamWriter &operator<<(qint64 value) { return *this << QByteArray::number(value); }
+    
+    void data(const QByteArray &content)
+    {
+        *this << "data " << qint64(content.size()) << "\n" << content << "\n";
+    }
+    
+    bool flush()
+    {
+        bool ok = m_file.write(m_buffer) == m_buffer.size();
+        m_buffer.clear();
+        return ok;
+    }
+
+private:
+    QFile &m_file;
+    QByteArray m_buffer;
+};
+
+}
+
+SyntheticRepositorySpec::SyntheticRepositorySpec()
+    : files(0)
+    , commits(0)
+    , branches(0)
+    , diffLines(0)
+{
+}
+
+QJsonObject SyntheticRepositorySpec::toJson() const
+{
+    QJsonObject object;
+    object["name"] = name;
+    object["files"] = files;
+    object["commits"] = commits;
+    object["branches"] = branches;
+    object["diffLines"] = diffLines;
+    return object;
+}
+
+SyntheticRepository::SyntheticRepository(const SyntheticRepositorySpec &spec)
+    : m_spec(spec)
+    , m_generationMs(0)
+    , m_reused(false)
+{
+}
+
+bool SyntheticRepository::prepare(const QString &path, bool reuseExisting)
+{
+    m_path = QDir(path).absolutePath();
+    m_reused = false;
+    m_generationMs = 0;
+    
+    if (reuseExisting && isUpToDate()) {
+        m_reused = true;
+        return runGit({"reset", "-q", "--hard", "main"})
+            && runGit({"clean", "-q", "-fd"})
+            && dirtyWorkingTree();
+    }
+    
+    QDir dir(m_path);
+    if (dir.exists() && !dir.removeRecursively()) {
+        m_lastError = "Cannot remove " + m_path;
+        return false;
+    }
+    if (!QDir().mkpath(m_path)) {
+        m_lastError = "Cannot create " + m_path;
+        return false;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    QTemporaryFile stream(QDir::temp().filePath("srikok-bench-XXXXXX.fi"));
+    if (!stream.open()) {
+        m_lastError = "Cannot create fast-import stream";
+        return false;
+    }
+    stream.close();
+    
+    if (!runGit({"init", "-q", "-b", "main"})
+        || !runGit({"config", "gc.auto", "0"})
+        || !runGit({"config", "maintenance.auto", "false"})
+        || !writeFastImportStream(stream.fileName())
+        || !runGit({"fast-import", "--quiet"}, stream.fileName())
+        || !runGit({"reset", "-q", "--hard", "main"})) {
+        return false;
+    }
+    
+    QFile marker(QDir(m_path).filePath(".git/" + QString(MarkerFile)));
+    if (marker.open(QIODevice::WriteOnly)) {
+        marker.write(QJsonDocument(m_spec.toJson()).toJson(QJsonDocument::Compact));
+    }
+    
+    if (!dirtyWorkingTree()) {
+        return false;
+    }
+    
+    m_generationMs = timer.elapsed();
+    return true;
+}
+
+const SyntheticRepositorySpec &SyntheticRepository::spec() const
+{
+    return m_spec;
+}
+
+QString SyntheticRepository::path() const
+{
+    return m_path;
+}
+
+QString SyntheticRepository::lastError() const
+{
+    return m_lastError;
+}
+
+qint64 SyntheticRepository::generationMs() const
+{
+    return m_generationMs;
+}
+
+bool SyntheticRepository::wasReused() const
+{
+    return m_reused;
+}
+
+QString SyntheticRepository::largeDiffFile()
+{
+    return "large-diff.txt";
+}
+
+QList<SyntheticRepositorySpec> SyntheticRepository::builtinSpecs()
+{
+    auto spec = [](const QString &name, int files, int commits, int branches, int diffLines) {
+        SyntheticRepositorySpec s;
+        s.name = name;
+        s.files = files;
+        s.commits = commits;
+        s.branches = branches;
+        s.diffLines = diffLines;
+        return s;
+    };
+    
+    return {
+        spec("small", 10000, 1000, 100, 2000),
+        spec("medium", 100000, 100000, 1000, 20000),
+        spec("large", 1000000, 1000000, 10000, 200000),
+        spec("branches", 10000, 10000, 50000, 2000),
+        spec("diff", 1000, 100, 10, 1000000)
+    };
+}
+
+bool SyntheticRepository::isUpToDate() const
+{
+    QFile marker(QDir(m_path).filePath(".git/" + QString(MarkerFile)));
+    if (!marker.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    return QJsonDocument::fromJson(marker.readAll()).object() == m_spec.toJson();
+}
+
+bool SyntheticRepository::writeFastImportStream(const QString &streamPath) const
+{
+    QFile file(streamPath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    
+    StreamWriter out(file);
+    
+    for (int blob = 0; blob < BlobCount; ++blob) {
+        QByteArray content;
+        for (int line = 0; line <= blob % 16; ++line) {
+            content += "synthetic blob " + QByteArray::number(blob) + " line " + QByteArray::number(line) + "\n";
+        }
+        out << "blob\nmark :" << qint64(blob + 1) << "\n";
+        out.data(content);
+    }
+    
+    QByteArray largeFile;
+    for (int line = 0; line < m_spec.diffLines; ++line) {
+        largeFile += "line " + QByteArray::number(line) + " of the original large file\n";
+    }
+    
+    const qint64 firstCommitMark = BlobCount + 1;
+    for (int commit = 0; commit < m_spec.commits; ++commit) {
+        out << "commit refs/heads/main\nmark :" << firstCommitMark + commit << "\n";
+        out << "committer Benchmark <benchmark@example.com> " << BaseTimestamp + qint64(commit) * 60 << " +0000\n";
+        out.data("Synthetic commit " + QByteArray::number(commit));
+        
+        if (commit == 0) {
+            for (int index = 0; index < m_spec.files; ++index) {
+                out << "M 100644 :" << qint64(index % BlobCount + 1) << " " << filePath(index).toUtf8() << "\n";
+            }
+            out << "M 100644 inline " << largeDiffFile().toUtf8() << "\n";
+            out.data(largeFile);
+        } else if (m_spec.files > 0) {
+            const int index = int((qint64(commit) * 7919) % m_spec.files);
+            out << "M 100644 inline " << filePath(index).toUtf8() << "\n";
+            out.data("revision " + QByteArray::number(commit) + "\n");
+        }
+        out << "\n";
+    }
+    
+    for (int branch = 0; branch < m_spec.branches && m_spec.commits > 0; ++branch) {
+        const qint64 commit = qint64(branch) * m_spec.commits / qMax(1, m_spec.branches);
+        out << "reset refs/heads/branch-" << QString::number(branch).rightJustified(6, '0').toUtf8() << "\n";
+        out << "from :" << firstCommitMark + commit << "\n\n";
+    }
+    
+    return out.flush();
+}
+
+bool SyntheticRepository::dirtyWorkingTree()
+{
+    QFile largeFile(QDir(m_path).filePath(largeDiffFile()));
+    if (!largeFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_lastError = "Cannot write " + largeFile.fileName();
+        return false;
+    }
+    
+    QByteArray content;
+    for (int line = 0; line < m_spec.diffLines; ++line) {
+        if (line % 3 == 0) {
+            content += "line " + QByteArray::number(line) + " changed by the benchmark\n";
+        } else {
+            content += "line " + QByteArray::number(line) + " of the original large file\n";
+        }
+    }
+    largeFile.write(content);
+    largeFile.close();
+    
+    const int modified = qMin(m_spec.files, 100);
+    for (int i = 0; i < modified; ++i) {
+        QFile file(QDir(m_path).filePath(filePath(i * qMax(1, m_spec.files / modified))));
+        if (file.open(QIODevice::Append)) {
+            file.write("benchmark modification\n");
+        }
+    }
+    
+    QDir().mkpath(QDir(m_path).filePath("untracked"));
+    for (int i = 0; i < 100; ++i) {
+        QFile file(QDir(m_path).filePath(QString("untracked/new-%1.txt").arg(i)));
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write("untracked\n");
+        }
+    }
+    
+    return true;
+}
+
+bool SyntheticRepository::runGit(const QStringList &args, const QString &inputFile)
+{
+    QProcess process;
+    process.setWorkingDirectory(m_path);
+    process.setProcessChannelMode(QProcess::ForwardedOutputChannel);
+    if (!inputFile.isEmpty()) {
+        process.setStandardInputFile(inputFile);
+    }
+    
+    process.start("git", args);
+    if (!process.waitForFinished(-1) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        m_lastError = "git " + args.join(' ') + " failed: " + QString::fromUtf8(process.readAllStandardError()).trimmed();
+        return false;
+    }
+    
+    return true;
+}
+
+QString SyntheticRepository::filePath(int index) const
+{
+    return QString("src/d%1/f%2.txt")
+        .arg(index / 1000, 4, 10, QChar('0'))
+        .arg(index, 7, 10, QChar('0'));
+}
\ No newline at end of file
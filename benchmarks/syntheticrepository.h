@@ -0,0 +1,49 @@
+#ifndef SYNTHETICREPOSITORY_H
+#define SYNTHETICREPOSITORY_H
+
+#include <QString>
+#include <QStringList>
+#include <QJsonObject>
+
+struct SyntheticRepositorySpec {
+    QString name;
+    int files;
+    int commits;
+    int branches;
+    int diffLines;
+    
+    SyntheticRepositorySpec();
+    QJsonObject toJson() const;
+};
+
+class SyntheticRepository
+{
+public:
+    explicit SyntheticRepository(const SyntheticRepositorySpec &spec);
+    
+    bool prepare(const QString &path, bool reuseExisting);
+    
+    const SyntheticRepositorySpec &spec() const;
+    QString path() const;
+    QString lastError() const;
+    qint64 generationMs() const;
+    bool wasReused() const;
+    
+    static QString largeDiffFile();
+    static QList<SyntheticRepositorySpec> builtinSpecs();
+
+private:
+    bool isUpToDate() const;
+    bool writeFastImportStream(const QString &streamPath) const;
+    bool dirtyWorkingTree();
+    bool runGit(const QStringList &args, const QString &inputFile = QString());
+    QString filePath(int index) const;
+    
+    SyntheticRepositorySpec m_spec;
+    QString m_path;
+    QString m_lastError;
+    qint64 m_generationMs;
+    bool m_reused;
+};
+
+#endif // SYNTHETICREPOSITORY_H
\ No newline at end of file
@@ -0,0 +1,428 @@
+#include "clirunner.h"
+#include "gittracer.h"
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+const char *UsageText =
+    "Usage: srikok-cli [-C <path>] [--json] [--timing] <command> [options]\n"
+    "\n"
+    "Commands:\n"
+    "  status                       Show the current branch and changed files\n"
+    "  log [-n <count>]             Show commit history (default 20)\n"
+    "  diff [<path>...]             Show working tree changes\n"
+    "  branch [-a | -r]             List local, all or remote branches\n"
+    "  search [--files] [-n <count>] <text>\n"
+    "                               Search commit messages, or tracked files with --files\n"
+    "\n"
+    "Options:\n"
+    "  -C <path>                    Run as if started in <path>\n"
+    "  --json                       Write machine-readable JSON to stdout\n"
+    "  --timing                     Report phase and git command timings on stderr\n";
+
+bool takeCount(const QStringList &args, int &index, int &count)
+{
+    const QString arg = args.at(index);
+    QString value;
+    if (arg == "-n" && index + 1 < args.size()) {
+        value = args.at(++index);
+    } else if (arg.startsWith("--max-count=")) {
+        value = arg.mid(12);
+    } else if (arg.startsWith("-n") && arg.size() > 2) {
+        value = arg.mid(2);
+    } else {
+        return false;
+    }
+    
+    bool ok = false;
+    count = value.toInt(&ok);
+    return ok && count > 0;
+}
+
+}
+
+CliRunner::CliRunner()
+    : m_out(stdout)
+    , m_err(stderr)
+    , m_json(false)
+    , m_timing(false)
+    , m_lastMarkUs(0)
+{
+    m_timer.start();
+}
+
+int CliRunner::run(const QStringList &arguments)
+{
+    QString path = QDir::currentPath();
+    QStringList rest;
+    
+    for (int i = 0; i < arguments.size(); ++i) {
+        const QString &arg = arguments.at(i);
+        if (arg == "--json") {
+            m_json = true;
+        } else if (arg == "--timing") {
+            m_timing = true;
+        } else if (arg == "-C" && rest.isEmpty()) {
+            if (i + 1 >= arguments.size()) {
+                return usage("-C requires a path");
+            }
+            path = QDir(path).absoluteFilePath(arguments.at(++i));
+        } else if ((arg == "-h" || arg == "--help") && rest.isEmpty()) {
+            m_out << UsageText;
+            return Success;
+        } else {
+            rest << arg;
+        }
+    }
+    
+    if (rest.isEmpty()) {
+        return usage();
+    }
+    
+    const QString command = rest.takeFirst();
+    if (!QStringList({"status", "log", "diff", "branch", "search"}).contains(command)) {
+        return usage("Unknown command: " + command);
+    }
+    
+    if (!openRepository(path)) {
+        return fail("Not a git repository: " + path);
+    }
+    mark("open");
+    
+    int result = Failure;
+    if (command == "status") {
+        result = runStatus(rest);
+    } else if (command == "log") {
+        result = runLog(rest);
+    } else if (command == "diff") {
+        result = runDiff(rest);
+    } else if (command == "branch") {
+        result = runBranch(rest);
+    } else {
+        result = runSearch(rest);
+    }
+    
+    m_out.flush();
+    printTiming();
+    return result;
+}
+
+bool CliRunner::openRepository(const QString &path)
+{
+    QString topLevel;
+    if (!GitManager::runGitCommand(path, {"rev-parse", "--show-toplevel"}, topLevel)) {
+        return false;
+    }
+    return m_gitManager.openRepository(topLevel.trimmed());
+}
+
+int CliRunner::runStatus(const QStringList &args)
+{
+    if (!args.isEmpty()) {
+        return usage("status takes no arguments");
+    }
+    
+    GitRepositorySummary summary;
+    QList<GitFileStatus> files;
+    QString error;
+    if (!GitManager::getRepositorySummary(m_gitManager.getRepositoryPath(), summary, &files, &error)) {
+        return fail("git status failed: " + error.trimmed());
+    }
+    mark("query");
+    
+    if (m_json) {
+        QJsonArray fileArray;
+        for (const GitFileStatus &file : files) {
+            QJsonObject object;
+            object["path"] = file.filePath;
+            object["status"] = file.status;
+            object["staged"] = file.isStaged;
+            object["modified"] = file.isModified;
+            object["untracked"] = file.isUntracked;
+            object["deleted"] = file.isDeleted;
+            fileArray.append(object);
+        }
+        
+        QJsonObject root;
+        root["repository"] = m_gitManager.getRepositoryPath();
+        root["branch"] = summary.branch;
+        root["upstream"] = summary.upstream;
+        root["ahead"] = summary.ahead;
+        root["behind"] = summary.behind;
+        root["files"] = fileArray;
+        writeJson(root);
+    } else {
+        m_out << "On branch " << summary.branch;
+        if (!summary.upstream.isEmpty()) {
+            m_out << " (" << summary.upstream << " +" << summary.ahead << " -" << summary.behind << ")";
+        }
+        m_out << "\n";
+        for (const GitFileStatus &file : files) {
+            m_out << file.status << " " << file.filePath << "\n";
+        }
+        if (files.isEmpty()) {
+            m_out << "Working tree clean\n";
+        }
+    }
+    mark("format");
+    
+    return Success;
+}
+
+int CliRunner::runLog(const QStringList &args)
+{
+    int limit = 20;
+    for (int i = 0; i < args.size(); ++i) {
+        if (!takeCount(args, i, limit)) {
+            return usage("Unknown log option: " + args.at(i));
+        }
+    }
+    
+    QString error;
+    const QList<GitCommit> commits = m_gitManager.getCommitHistory(limit, &error);
+    if (!error.isEmpty()) {
+        return fail("git log failed: " + error.trimmed());
+    }
+    mark("query");
+    
+    if (m_json) {
+        writeJson(commitsToJson(commits));
+    } else {
+        for (const GitCommit &commit : commits) {
+            m_out << commit.hash.left(10) << " " << commit.date << " " << commit.author << "  " << commit.message << "\n";
+        }
+    }
+    mark("format");
+    
+    return Success;
+}
+
+int CliRunner::runDiff(const QStringList &args)
+{
+    const QStringList paths = args.isEmpty() ? QStringList(".") : args;
+    
+    QJsonArray diffs;
+    QStringList texts;
+    for (const QString &path : paths) {
+        QString error;
+        const QString diff = m_gitManager.getFileDiff(path, &error);
+        if (!error.isEmpty()) {
+            return fail("git diff failed for " + path + ": " + error.trimmed());
+        }
+        texts << diff;
+        
+        QJsonObject object;
+        object["path"] = path;
+        object["diff"] = diff;
+        diffs.append(object);
+    }
+    mark("query");
+    
+    if (m_json) {
+        writeJson(diffs);
+    } else {
+        for (const QString &text : texts) {
+            m_out << text;
+        }
+    }
+    mark("format");
+    
+    return Success;
+}
+
+int CliRunner::runBranch(const QStringList &args)
+{
+    bool includeLocal = true;
+    bool includeRemote = false;
+    for (const QString &arg : args) {
+        if (arg == "-a" || arg == "--all") {
+            includeRemote = true;
+        } else if (arg == "-r" || arg == "--remotes") {
+            includeLocal = false;
+            includeRemote = true;
+        } else {
+            return usage("Unknown branch option: " + arg);
+        }
+    }
+    
+    QString error;
+    const QList<GitBranchRef> refs = m_gitManager.getBranchRefs(&error);
+    if (!error.isEmpty()) {
+        return fail("git for-each-ref failed: " + error.trimmed());
+    }
+    mark("query");
+    
+    QJsonArray branchArray;
+    for (const GitBranchRef &ref : refs) {
+        if ((ref.isRemote && !includeRemote) || (!ref.isRemote && !includeLocal)) {
+            continue;
+        }
+        
+        if (m_json) {
+            QJsonObject object;
+            object["name"] = ref.name;
+            object["ref"] = ref.refName;
+            object["upstream"] = ref.upstream;
+            object["commit"] = ref.commitHash;
+            object["subject"] = ref.subject;
+            object["commitTime"] = ref.commitTime;
+            object["remote"] = ref.isRemote;
+            object["current"] = ref.isCurrent;
+            branchArray.append(object);
+        } else {
+            m_out << (ref.isCurrent ? "* " : "  ") << ref.name << "\n";
+        }
+    }
+    
+    if (m_json) {
+        writeJson(branchArray);
+    }
+    mark("format");
+    
+    return Success;
+}
+
+int CliRunner::runSearch(const QStringList &args)
+{
+    bool files = false;
+    int limit = 100;
+    QStringList terms;
+    for (int i = 0; i < args.size(); ++i) {
+        const QString arg = args.at(i);
+        if (arg == "--files") {
+            files = true;
+        } else if (arg == "--commits") {
+            files = false;
+        } else if (arg.startsWith('-')) {
+            if (!takeCount(args, i, limit)) {
+                return usage("Unknown search option: " + arg);
+            }
+        } else {
+            terms << arg;
+        }
+    }
+    
+    const QString text = terms.join(' ');
+    if (text.isEmpty()) {
+        return usage("search requires text to look for");
+    }
+    
+    QString error;
+    if (files) {
+        const QList<GitSearchMatch> matches = m_gitManager.searchFiles(text, limit, &error);
+        if (!error.isEmpty()) {
+            return fail("git grep failed: " + error.trimmed());
+        }
+        mark("query");
+        
+        if (m_json) {
+            QJsonArray matchArray;
+            for (const GitSearchMatch &match : matches) {
+                QJsonObject object;
+                object["path"] = match.filePath;
+                object["line"] = match.lineNumber;
+                object["text"] = match.text;
+                matchArray.append(object);
+            }
+            writeJson(matchArray);
+        } else {
+            for (const GitSearchMatch &match : matches) {
+                m_out << match.filePath << ":" << match.lineNumber << ": " << match.text << "\n";
+            }
+        }
+    } else {
+        const QList<GitCommit> commits = m_gitManager.searchCommits(text, limit, &error);
+        if (!error.isEmpty()) {
+            return fail("git log failed: " + error.trimmed());
+        }
+        mark("query");
+        
+        if (m_json) {
+            writeJson(commitsToJson(commits));
+        } else {
+            for (const GitCommit &commit : commits) {
+                m_out << commit.hash.left(10) << " " << commit.date << " " << commit.author << "  " << commit.message << "\n";
+            }
+        }
+    }
+    mark("format");
+    
+    return Success;
+}
+
+void CliRunner::mark(const QString &phase)
+{
+    const qint64 nowUs = m_timer.nsecsElapsed() / 1000;
+    m_phases.append(qMakePair(phase, nowUs - m_lastMarkUs));
+    m_lastMarkUs = nowUs;
+}
+
+void CliRunner::printTiming()
+{
+    if (!m_timing) {
+        return;
+    }
+    
+    const QList<GitTraceEvent> events = GitTracer::instance()->events();
+    qint64 gitUs = 0;
+    for (const GitTraceEvent &event : events) {
+        gitUs += event.durationUs;
+    }
+    
+    m_err << QString("total %1 ms").arg(m_lastMarkUs / 1000.0, 0, 'f', 2);
+    for (const auto &phase : m_phases) {
+        m_err << QString(", %1 %2 ms").arg(phase.first).arg(phase.second / 1000.0, 0, 'f', 2);
+    }
+    m_err << QString("\ngit: %1 command(s), %2 ms\n").arg(events.size()).arg(gitUs / 1000.0, 0, 'f', 2);
+    
+    for (const GitTraceEvent &event : events) {
+        m_err << QString("  %1 ms (spawn %2 ms, %3 bytes, exit %4)  git %5\n")
+            .arg(event.durationUs / 1000.0, 8, 'f', 2)
+            .arg(event.spawnUs / 1000.0, 0, 'f', 2)
+            .arg(event.outputBytes)
+            .arg(event.exitCode)
+            .arg(event.arguments.join(' '));
+    }
+    m_err.flush();
+}
+
+int CliRunner::usage(const QString &message)
+{
+    if (!message.isEmpty()) {
+        m_err << "srikok-cli: " << message << "\n\n";
+    }
+    m_err << UsageText;
+    m_err.flush();
+    return UsageError;
+}
+
+int CliRunner::fail(const QString &message)
+{
+    m_err << "srikok-cli: " << message << "\n";
+    m_err.flush();
+    return Failure;
+}
+
+void CliRunner::writeJson(const QJsonValue &value)
+{
+    const QJsonDocument document = value.isArray() ? QJsonDocument(value.toArray()) : QJsonDocument(value.toObject());
+    m_out << document.toJson(QJsonDocument::Indented);
+}
+
+QJsonValue CliRunner::commitsToJson(const QList<GitCommit> &commits)
+{
+    QJsonArray commitArray;
+    for (const GitCommit &commit : commits) {
+        QJsonObject object;
+        object["hash"] = commit.hash;
+        object["author"] = commit.author;
+        object["date"] = commit.date;
+        object["subject"] = commit.message;
+        object["parents"] = QJsonArray::fromStringList(commit.parents);
+        commitArray.append(object);
+    }
+    return commitArray;
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#ifndef CLIRUNNER_H
+#define CLIRUNNER_H
+
+#include <QElapsedTimer>
+#include <QJsonValue>
+#include <QList>
+#include <QPair>
+#include <QStringList>
+#include <QTextStream>
+#include "gitmanager.h"
+
+class CliRunner
+{
+public:
+    enum ExitCode {
+        Success = 0,
+        Failure = 1,
+        UsageError = 2
+    };
+    
+    CliRunner();
+    
+    int run(const QStringList &arguments);
+
+private:
+    int runStatus(const QStringList &args);
+    int runLog(const QStringList &args);
+    int runDiff(const QStringList &args);
+    int runBranch(const QStringList &args);
+    int runSearch(const QStringList &args);
+    
+    bool openRepository(const QString &path);
+    void mark(const QString &phase);
+    void printTiming();
+    int usage(const QString &message = QString());
+    int fail(const QString &message);
+    void writeJson(const QJsonValue &value);
+    
+    static QJsonValue commitsToJson(const QList<GitCommit> &commits);
+    
+    GitManager m_gitManager;
+    QTextStream m_out;
+    QTextStream m_err;
+    bool m_json;
+    bool m_timing;
+    QElapsedTimer m_timer;
+    qint64 m_lastMarkUs;
+    QList<QPair<QString, qint64>> m_phases;
+};
+
+#endif // CLIRUNNER_H
\ No newline at end of file
@@ -0,0 +1,15 @@
+#include <QCoreApplication>
+#include "clirunner.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    app.setApplicationName("srikok-cli");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("Srikoksoft");
+    app.setOrganizationDomain("srikoksoft.com");
+    
+    CliRunner runner;
+    return runner.run(app.arguments().mid(1));
+}
\ No newline at end of file
@@ -0,0 +1,330 @@
+#include "fsmonitordaemon.h"
+#include "gitfsmonitor.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSet>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+
+const uint32_t WatchMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE
+    | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW;
+    
+}
+
+FsMonitorDaemon::FsMonitorDaemon(const QString &workTree, QObject *parent)
+    : QObject(parent)
+    , m_workTree(QDir(workTree).absolutePath())
+    , m_inotifyFd(-1)
+    , m_listenFd(-1)
+    , m_inotifyNotifier(nullptr)
+    , m_listenNotifier(nullptr)
+    , m_sequence(0)
+    , m_oldestSequence(0)
+    , m_degraded(false)
+{
+    m_instance = QByteArray::number(QCoreApplication::applicationPid()) + "."
+        + QByteArray::number(QDateTime::currentMSecsSinceEpoch());
+    
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(IdleTimeoutMs);
+    connect(&m_idleTimer, &QTimer::timeout, this, &FsMonitorDaemon::onIdleTimeout);
+}
+
+FsMonitorDaemon::~FsMonitorDaemon()
+{
+    if (m_listenFd >= 0) {
+        ::close(m_listenFd);
+        QFile::remove(m_socketPath);
+    }
+    if (m_inotifyFd >= 0) {
+        ::close(m_inotifyFd);
+    }
+}
+
+bool FsMonitorDaemon::start(QString *error)
+{
+    const QString gitDirectory = GitFsMonitor::resolveGitDirectory(m_workTree);
+    if (gitDirectory.isEmpty()) {
+        if (error) {
+            *error = m_workTree + " is not a git working tree";
+        }
+        return false;
+    }
+    
+    m_socketPath = GitFsMonitor::socketPath(gitDirectory);
+    QByteArray response;
+    if (GitFsMonitor::request(m_socketPath, "ping\n", response) && response.startsWith("ok")) {
+        if (error) {
+            *error = "A monitor is already running for " + m_workTree;
+        }
+        return false;
+    }
+    QFile::remove(m_socketPath);
+    
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd < 0) {
+        if (error) {
+            *error = QString("inotify_init1 failed: %1").arg(strerror(errno));
+        }
+        return false;
+    }
+    
+    m_listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    const QByteArray path = m_socketPath.toLocal8Bit();
+    memcpy(address.sun_path, path.constData(), size_t(qMin<int>(path.size(), sizeof(address.sun_path) - 1)));
+    
+    if (m_listenFd < 0
+        || bind(m_listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(m_listenFd, 16) != 0) {
+        if (error) {
+            *error = QString("Cannot listen on %1: %2").arg(m_socketPath, strerror(errno));
+        }
+        return false;
+    }
+    chmod(path.constData(), S_IRUSR | S_IWUSR);
+    
+    addWatchRecursive(QByteArray());
+    
+    m_inotifyNotifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+    connect(m_inotifyNotifier, &QSocketNotifier::activated, this, &FsMonitorDaemon::onInotifyReadable);
+    m_listenNotifier = new QSocketNotifier(m_listenFd, QSocketNotifier::Read, this);
+    connect(m_listenNotifier, &QSocketNotifier::activated, this, &FsMonitorDaemon::onConnectionPending);
+    
+    m_idleTimer.start();
+    return true;
+}
+
+void FsMonitorDaemon::addWatchRecursive(const QByteArray &relativeDirectory)
+{
+    QList<QByteArray> pending = {relativeDirectory};
+    const QByteArray root = QFile::encodeName(m_workTree);
+    
+    while (!pending.isEmpty()) {
+        const QByteArray relative = pending.takeLast();
+        const QByteArray absolute = relative.isEmpty() ? root : root + "/" + relative;
+        
+        const int wd = inotify_add_watch(m_inotifyFd, absolute.constData(), WatchMask);
+        if (wd < 0) {
+            if (errno == ENOSPC || errno == ENOMEM) {
+                m_degraded = true;
+                qWarning("srikok-fsmonitor: out of inotify watches, answering every query with a full rescan");
+                return;
+            }
+            continue;
+        }
+        m_watches.insert(wd, relative);
+        
+        DIR *dir = opendir(absolute.constData());
+        if (!dir) {
+            continue;
+        }
+        while (dirent *entry = readdir(dir)) {
+            const char *name = entry->d_name;
+            if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0) {
+                continue;
+            }
+            if (relative.isEmpty() && strcmp(name, ".git") == 0) {
+                continue;
+            }
+            
+            bool isDirectory = entry->d_type == DT_DIR;
+            if (entry->d_type == DT_UNKNOWN) {
+                struct stat info;
+                const QByteArray child = absolute + "/" + name;
+                isDirectory = lstat(child.constData(), &info) == 0 && S_ISDIR(info.st_mode);
+            }
+            if (isDirectory) {
+                pending.append(relative.isEmpty() ? QByteArray(name) : relative + "/" + name);
+            }
+        }
+        closedir(dir);
+    }
+}
+
+void FsMonitorDaemon::onInotifyReadable()
+{
+    drainEvents();
+}
+
+void FsMonitorDaemon::drainEvents()
+{
+    alignas(inotify_event) char buffer[64 * 1024];
+    
+    for (;;) {
+        const ssize_t length = read(m_inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length < 0 && errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        
+        for (char *cursor = buffer; cursor < buffer + length; ) {
+            const inotify_event *event = reinterpret_cast<const inotify_event*>(cursor);
+            cursor += sizeof(inotify_event) + event->len;
+            
+            if (event->mask & IN_Q_OVERFLOW) {
+                invalidateAll();
+                continue;
+            }
+            
+            const auto watch = m_watches.constFind(event->wd);
+            if (watch == m_watches.constEnd()) {
+                continue;
+            }
+            const QByteArray directory = watch.value();
+            
+            if (event->mask & IN_IGNORED) {
+                m_watches.remove(event->wd);
+                continue;
+            }
+            if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF)) {
+                if (directory.isEmpty()) {
+                    QCoreApplication::quit();
+                    return;
+                }
+                record(directory + "/");
+                continue;
+            }
+            if (event->len == 0) {
+                continue;
+            }
+            
+            const QByteArray name(event->name);
+            const QByteArray path = directory.isEmpty() ? name : directory + "/" + name;
+            if (event->mask & IN_ISDIR) {
+                record(path + "/");
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    addWatchRecursive(path);
+                }
+            } else {
+                record(path);
+            }
+        }
+    }
+}
+
+void FsMonitorDaemon::record(const QByteArray &path)
+{
+    m_journal.append({++m_sequence, path});
+    if (m_journal.size() > JournalCapacity) {
+        const int drop = m_journal.size() / 2;
+        m_oldestSequence = m_journal.at(drop - 1).sequence;
+        m_journal.remove(0, drop);
+    }
+}
+
+void FsMonitorDaemon::invalidateAll()
+{
+    m_journal.clear();
+    m_oldestSequence = ++m_sequence;
+}
+
+void FsMonitorDaemon::onConnectionPending()
+{
+    for (;;) {
+        const int fd = accept4(m_listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        handleConnection(fd);
+        ::close(fd);
+    }
+}
+
+void FsMonitorDaemon::handleConnection(int fd)
+{
+    QByteArray request;
+    char buffer[4096];
+    while (!request.contains('\n') && request.size() < int(sizeof(buffer))) {
+        pollfd descriptor = {fd, POLLIN, 0};
+        if (poll(&descriptor, 1, 1000) <= 0) {
+            return;
+        }
+        const ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) {
+            break;
+        }
+        request.append(buffer, int(n));
+    }
+    
+    const QByteArray line = request.left(request.indexOf('\n')).trimmed();
+    QByteArray response;
+    
+    if (line.startsWith("query")) {
+        m_idleTimer.start();
+        drainEvents();
+        response = answerQuery(line.mid(5).trimmed());
+    } else if (line == "ping") {
+        response = "ok " + currentToken() + " watches=" + QByteArray::number(m_watches.size())
+            + (m_degraded ? " degraded" : "") + "\n";
+    } else if (line == "stop") {
+        response = "ok\n";
+        QMetaObject::invokeMethod(qApp, &QCoreApplication::quit, Qt::QueuedConnection);
+    } else {
+        response = "error unknown request\n";
+    }
+    
+    qint64 written = 0;
+    while (written < response.size()) {
+        const ssize_t n = write(fd, response.constData() + written, size_t(response.size() - written));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        written += n;
+    }
+}
+
+QByteArray FsMonitorDaemon::answerQuery(const QByteArray &token)
+{
+    QByteArray response = currentToken();
+    response.append('\0');
+    
+    const QByteArray prefix = "srikok:" + m_instance + ":";
+    bool ok = false;
+    const quint64 since = token.startsWith(prefix) ? token.mid(prefix.size()).toULongLong(&ok) : 0;
+    
+    if (m_degraded || !ok || since < m_oldestSequence || since > m_sequence) {
+        response.append('/');
+        response.append('\0');
+        return response;
+    }
+    
+    QSet<QByteArray> reported;
+    for (auto it = m_journal.crbegin(); it != m_journal.crend() && it->sequence > since; ++it) {
+        if (!reported.contains(it->path)) {
+            reported.insert(it->path);
+            response.append(it->path);
+            response.append('\0');
+        }
+    }
+    return response;
+}
+
+QByteArray FsMonitorDaemon::currentToken() const
+{
+    return "srikok:" + m_instance + ":" + QByteArray::number(m_sequence);
+}
+
+void FsMonitorDaemon::onIdleTimeout()
+{
+    QCoreApplication::quit();
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef FSMONITORDAEMON_H
+#define FSMONITORDAEMON_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QSocketNotifier>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+class FsMonitorDaemon : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FsMonitorDaemon(const QString &workTree, QObject *parent = nullptr);
+    ~FsMonitorDaemon();
+    
+    bool start(QString *error = nullptr);
+
+private slots:
+    void onInotifyReadable();
+    void onConnectionPending();
+    void onIdleTimeout();
+
+private:
+    struct JournalEntry {
+        quint64 sequence;
+        QByteArray path;
+    };
+    
+    static const int JournalCapacity = 200000;
+    static const int IdleTimeoutMs = 60 * 60 * 1000;
+    
+    void addWatchRecursive(const QByteArray &relativeDirectory);
+    void drainEvents();
+    void record(const QByteArray &path);
+    void invalidateAll();
+    void handleConnection(int fd);
+    QByteArray answerQuery(const QByteArray &token);
+    QByteArray currentToken() const;
+    
+    QString m_workTree;
+    QString m_socketPath;
+    QByteArray m_instance;
+    int m_inotifyFd;
+    int m_listenFd;
+    QSocketNotifier *m_inotifyNotifier;
+    QSocketNotifier *m_listenNotifier;
+    QTimer m_idleTimer;
+    
+    QHash<int, QByteArray> m_watches;
+    QVector<JournalEntry> m_journal;
+    quint64 m_sequence;
+    quint64 m_oldestSequence;
+    bool m_degraded;
+};
+
+#endif // FSMONITORDAEMON_H
\ No newline at end of file
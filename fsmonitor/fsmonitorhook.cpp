@@ -0,0 +1,40 @@
+#include "fsmonitorhook.h"
+#include "gitfsmonitor.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <cstdio>
+
+int FsMonitorHook::run(const QStringList &args)
+{
+    if (args.size() < 2 || args.at(0).toInt() != GitFsMonitor::HookVersion) {
+        return 1;
+    }
+    
+    const QString workTree = QDir::currentPath();
+    const QString gitDirectory = GitFsMonitor::resolveGitDirectory(workTree);
+    if (gitDirectory.isEmpty()) {
+        return 1;
+    }
+    
+    QByteArray response;
+    const QByteArray request = "query " + args.at(1).toUtf8() + "\n";
+    if (GitFsMonitor::request(GitFsMonitor::socketPath(gitDirectory), request, response, 5000) && response.contains('\0')) {
+        writeResponse(response);
+        return 0;
+    }
+    
+    GitFsMonitor::startDaemon(workTree, QCoreApplication::applicationFilePath());
+    
+    response = "srikok:starting:0";
+    response.append('\0');
+    response.append('/');
+    response.append('\0');
+    writeResponse(response);
+    return 0;
+}
+
+void FsMonitorHook::writeResponse(const QByteArray &response)
+{
+    fwrite(response.constData(), 1, size_t(response.size()), stdout);
+    fflush(stdout);
+}
\ No newline at end of file
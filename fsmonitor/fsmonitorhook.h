@@ -0,0 +1,15 @@
+#ifndef FSMONITORHOOK_H
+#define FSMONITORHOOK_H
+
+#include <QStringList>
+
+class FsMonitorHook
+{
+public:
+    static int run(const QStringList &args);
+
+private:
+    static void writeResponse(const QByteArray &response);
+};
+
+#endif // FSMONITORHOOK_H
\ No newline at end of file
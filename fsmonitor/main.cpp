@@ -0,0 +1,53 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QTextStream>
+#include "fsmonitordaemon.h"
+#include "fsmonitorhook.h"
+#include "gitfsmonitor.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    
+    app.setApplicationName("srikok-fsmonitor");
+    app.setApplicationVersion("1.0.0");
+    app.setOrganizationName("Srikoksoft");
+    app.setOrganizationDomain("srikoksoft.com");
+    
+    const QStringList args = app.arguments().mid(1);
+    const QString mode = args.value(0);
+    QTextStream err(stderr);
+    
+    if (mode == "hook") {
+        return FsMonitorHook::run(args.mid(1));
+    }
+    
+    const QString workTree = QDir(args.value(1, QDir::currentPath())).absolutePath();
+    
+    if (mode == "daemon") {
+        FsMonitorDaemon daemon(workTree);
+        QString error;
+        if (!daemon.start(&error)) {
+            err << "srikok-fsmonitor: " << error << Qt::endl;
+            return 1;
+        }
+        return app.exec();
+    }
+    
+    if (mode == "stop" || mode == "status") {
+        QByteArray response;
+        const QString socketPath = GitFsMonitor::socketPath(GitFsMonitor::resolveGitDirectory(workTree));
+        if (!GitFsMonitor::request(socketPath, mode == "stop" ? "stop\n" : "ping\n", response)) {
+            err << "srikok-fsmonitor: no monitor is running for " << workTree << Qt::endl;
+            return 1;
+        }
+        QTextStream(stdout) << response;
+        return 0;
+    }
+    
+    err << "usage: srikok-fsmonitor daemon [<worktree>]\n"
+        << "       srikok-fsmonitor status [<worktree>]\n"
+        << "       srikok-fsmonitor stop [<worktree>]\n"
+        << "       srikok-fsmonitor hook <version> <token>" << Qt::endl;
+    return 2;
+}
\ No newline at end of file
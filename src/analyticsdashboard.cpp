@@ -0,0 +1,161 @@
+#include "analyticsdashboard.h"
+#include "gitmanager.h"
+#include "gittracer.h"
+#include "statschart.h"
+#include <QLocale>
+#include <algorithm>
+
+namespace {
+
+const int TopEntryCount = 25;
+
+enum Metric {
+    LinesChangedMetric,
+    CommitsMetric
+};
+
+}
+
+AnalyticsDashboard::AnalyticsDashboard(GitManager *gitManager, QWidget *parent)
+    : QWidget(parent)
+    , m_gitManager(gitManager)
+    , m_summaryLabel(nullptr)
+    , m_metricCombo(nullptr)
+    , m_refreshButton(nullptr)
+    , m_tabWidget(nullptr)
+    , m_activityChart(nullptr)
+    , m_authorChart(nullptr)
+    , m_fileChart(nullptr)
+    , m_directoryChart(nullptr)
+    , m_requestSerial(0)
+{
+    setupUI();
+}
+
+void AnalyticsDashboard::setupUI()
+{
+    setWindowTitle("Repository Analytics");
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    QHBoxLayout *headerLayout = new QHBoxLayout;
+    m_summaryLabel = new QLabel;
+    m_metricCombo = new QComboBox;
+    m_metricCombo->addItem("Lines changed", LinesChangedMetric);
+    m_metricCombo->addItem("Commits", CommitsMetric);
+    m_refreshButton = new QPushButton("Refresh");
+    m_refreshButton->setMaximumWidth(80);
+    
+    headerLayout->addWidget(m_summaryLabel);
+    headerLayout->addStretch();
+    headerLayout->addWidget(new QLabel("Rank by:"));
+    headerLayout->addWidget(m_metricCombo);
+    headerLayout->addWidget(m_refreshButton);
+    
+    m_activityChart = new StatsChart(StatsChart::Timeline);
+    m_authorChart = new StatsChart(StatsChart::RankedBars);
+    m_fileChart = new StatsChart(StatsChart::RankedBars);
+    m_directoryChart = new StatsChart(StatsChart::RankedBars);
+    
+    m_tabWidget = new QTabWidget;
+    m_tabWidget->addTab(m_activityChart, "Activity");
+    m_tabWidget->addTab(m_authorChart, "Authors");
+    m_tabWidget->addTab(m_fileChart, "Files");
+    m_tabWidget->addTab(m_directoryChart, "Directories");
+    
+    layout->addLayout(headerLayout);
+    layout->addWidget(m_tabWidget);
+    
+    connect(m_refreshButton, &QPushButton::clicked, this, &AnalyticsDashboard::refresh);
+    connect(m_metricCombo, &QComboBox::currentIndexChanged, this, &AnalyticsDashboard::updateCharts);
+}
+
+void AnalyticsDashboard::refresh()
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        m_summary = RepositoryStatsSummary();
+        m_summaryLabel->setText("No repository open");
+        updateCharts();
+        return;
+    }
+    
+    GitTraceAction action("Repository analytics");
+    
+    const quint64 serial = ++m_requestSerial;
+    m_refreshButton->setEnabled(false);
+    m_summaryLabel->setText("Collecting statistics...");
+    
+    m_gitManager->requestRepositoryStats(this, [this, serial](const RepositoryStatsSummary &summary) {
+        if (serial != m_requestSerial) {
+            return;
+        }
+        m_refreshButton->setEnabled(true);
+        showSummary(summary);
+    });
+}
+
+void AnalyticsDashboard::showSummary(const RepositoryStatsSummary &summary)
+{
+    m_summary = summary;
+    
+    if (!summary.success) {
+        m_summaryLabel->setText(summary.error.isEmpty() ? QString("Failed to collect repository statistics")
+                                : "Failed to collect repository statistics: " + summary.error);
+    } else {
+        const QLocale locale;
+        QString text = QString("%1 commits, %2 authors, %3 files")
+            .arg(locale.toString(summary.commitCount))
+            .arg(locale.toString(int(summary.authors.size())))
+            .arg(locale.toString(int(summary.files.size())));
+        if (summary.processedCommits > 0) {
+            text += QString(" (%1 new commits in %2 batches, %3 ms)")
+                .arg(locale.toString(summary.processedCommits))
+                .arg(summary.batchCount)
+                .arg(summary.elapsedMs);
+        } else {
+            text += QString(" (cached, %1 ms)").arg(summary.elapsedMs);
+        }
+        m_summaryLabel->setText(text);
+    }
+    
+    updateCharts();
+}
+
+void AnalyticsDashboard::updateCharts()
+{
+    QList<QPair<QString, double>> activity;
+    if (!m_summary.activity.isEmpty()) {
+        QDate month = m_summary.activity.firstKey();
+        const QDate last = m_summary.activity.lastKey();
+        while (month <= last) {
+            activity.append(qMakePair(month.toString("yyyy-MM"), double(m_summary.activity.value(month))));
+            month = month.addMonths(1);
+        }
+    }
+    m_activityChart->setEntries(activity, "commits");
+    
+    const QString unit = m_metricCombo->currentData().toInt() == CommitsMetric ? "commits" : "lines";
+    m_authorChart->setEntries(topEntries(m_summary.authors), unit);
+    m_fileChart->setEntries(topEntries(m_summary.files), unit);
+    m_directoryChart->setEntries(topEntries(m_summary.directories), unit);
+}
+
+QList<QPair<QString, double>> AnalyticsDashboard::topEntries(const QHash<QString, ChurnTotals> &totals) const
+{
+    const bool byCommits = m_metricCombo->currentData().toInt() == CommitsMetric;
+    
+    QList<QPair<QString, double>> entries;
+    entries.reserve(totals.size());
+    for (auto it = totals.constBegin(); it != totals.constEnd(); ++it) {
+        const double value = byCommits ? it.value().commits : double(it.value().added + it.value().deleted);
+        entries.append(qMakePair(it.key(), value));
+    }
+    
+    const int count = qMin(TopEntryCount, int(entries.size()));
+    std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+        [](const QPair<QString, double> &a, const QPair<QString, double> &b) {
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+    entries.erase(entries.begin() + count, entries.end());
+    return entries;
+}
\ No newline at end of file
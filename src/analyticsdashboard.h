@@ -0,0 +1,47 @@
+#ifndef ANALYTICSDASHBOARD_H
+#define ANALYTICSDASHBOARD_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QComboBox>
+#include <QTabWidget>
+#include "repositorystats.h"
+
+class GitManager;
+class StatsChart;
+
+class AnalyticsDashboard : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit AnalyticsDashboard(GitManager *gitManager, QWidget *parent = nullptr);
+    
+    void refresh();
+
+private slots:
+    void updateCharts();
+
+private:
+    void setupUI();
+    void showSummary(const RepositoryStatsSummary &summary);
+    QList<QPair<QString, double>> topEntries(const QHash<QString, ChurnTotals> &totals) const;
+    
+    GitManager *m_gitManager;
+    QLabel *m_summaryLabel;
+    QComboBox *m_metricCombo;
+    QPushButton *m_refreshButton;
+    QTabWidget *m_tabWidget;
+    StatsChart *m_activityChart;
+    StatsChart *m_authorChart;
+    StatsChart *m_fileChart;
+    StatsChart *m_directoryChart;
+    
+    RepositoryStatsSummary m_summary;
+    quint64 m_requestSerial;
+};
+
+#endif // ANALYTICSDASHBOARD_H
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "branchlistmodel.h"
+#include "gitcommandscheduler.h"
+#include "gittracer.h"
+#include <QBrush>
+#include <QColor>
+#include <QDateTime>
+#include <QFont>
+
+BranchListModel::BranchListModel(GitManager *gitManager, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_gitManager(gitManager)
+{
+}
+
+void BranchListModel::setBranches(const QString &repositoryPath, const QList<GitBranchRef> &branches)
+{
+    GitTraceSpan span("model", "BranchListModel::setBranches");
+    span.setItemCount(branches.size());
+    
+    beginResetModel();
+    
+    if (repositoryPath != m_repositoryPath) {
+        m_aheadBehindCache.clear();
+        for (quint64 requestId : std::as_const(m_pending)) {
+            m_gitManager->scheduler()->cancel(requestId);
+        }
+        m_pending.clear();
+    }
+    
+    m_repositoryPath = repositoryPath;
+    m_branches = branches;
+    m_rowByName.clear();
+    m_rowByName.reserve(m_branches.size());
+    for (int i = 0; i < m_branches.size(); ++i) {
+        m_rowByName.insert(m_branches[i].name, i);
+    }
+    
+    m_aheadBehindKeys.clear();
+    m_aheadBehindKeys.reserve(m_branches.size());
+    m_rowsByKey.clear();
+    for (int i = 0; i < m_branches.size(); ++i) {
+        const QString key = aheadBehindKey(m_branches[i]);
+        m_aheadBehindKeys.append(key);
+        if (!key.isEmpty()) {
+            m_rowsByKey.insert(key, i);
+        }
+    }
+    
+    endResetModel();
+}
+
+const GitBranchRef &BranchListModel::branchAt(int row) const
+{
+    return m_branches.at(row);
+}
+
+int BranchListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_branches.size();
+}
+
+int BranchListModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant BranchListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_branches.size()) {
+        return QVariant();
+    }
+    
+    const GitBranchRef &branch = m_branches.at(index.row());
+    
+    switch (role) {
+    case BranchNameRole:
+        return branch.name;
+    case IsRemoteRole:
+        return branch.isRemote;
+    case IsCurrentRole:
+        return branch.isCurrent;
+    case Qt::FontRole:
+        if (branch.isCurrent) {
+            QFont font;
+            font.setBold(true);
+            return font;
+        }
+        return QVariant();
+    case Qt::BackgroundRole:
+        if (branch.isCurrent) {
+            return QBrush(QColor(0, 255, 0, 50));
+        }
+        return QVariant();
+    case Qt::ForegroundRole:
+        if (branch.isRemote) {
+            return QBrush(QColor(100, 100, 100));
+        }
+        return QVariant();
+    case Qt::ToolTipRole:
+        return QString("%1\n%2\n%3").arg(branch.refName, branch.commitHash, branch.subject);
+    default:
+        break;
+    }
+    
+    if (role != Qt::DisplayRole && role != SortRole) {
+        return QVariant();
+    }
+    
+    switch (index.column()) {
+    case NameColumn:
+        if (role == Qt::DisplayRole && branch.isCurrent) {
+            return "* " + branch.name;
+        }
+        return branch.name;
+    case UpstreamColumn:
+        return branch.upstream;
+    case AheadBehindColumn: {
+        const QString &key = m_aheadBehindKeys.at(index.row());
+        if (key.isEmpty()) {
+            return role == SortRole ? QVariant(-1) : QVariant();
+        }
+        auto it = m_aheadBehindCache.constFind(key);
+        if (it == m_aheadBehindCache.constEnd()) {
+            if (role == SortRole) {
+                return -1;
+            }
+            requestAheadBehind(key);
+            return QVariant("...");
+        }
+        if (role == SortRole) {
+            return it->ahead < 0 ? -1 : it->ahead + it->behind;
+        }
+        if (it->ahead < 0) {
+            return QVariant();
+        }
+        return QString("+%1 -%2").arg(it->ahead).arg(it->behind);
+    }
+    case DateColumn:
+        if (role == SortRole) {
+            return branch.commitTime;
+        }
+        return QDateTime::fromSecsSinceEpoch(branch.commitTime).toString("yyyy-MM-dd HH:mm");
+    case SubjectColumn:
+        return branch.subject;
+    default:
+        return QVariant();
+    }
+}
+
+QVariant BranchListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    
+    switch (section) {
+    case NameColumn:
+        return "Branch";
+    case UpstreamColumn:
+        return "Upstream";
+    case AheadBehindColumn:
+        return "Ahead/Behind";
+    case DateColumn:
+        return "Last Commit";
+    case SubjectColumn:
+        return "Subject";
+    default:
+        return QVariant();
+    }
+}
+
+QString BranchListModel::aheadBehindKey(const GitBranchRef &branch) const
+{
+    if (branch.isRemote || branch.upstream.isEmpty()) {
+        return QString();
+    }
+    
+    auto it = m_rowByName.constFind(branch.upstream);
+    if (it == m_rowByName.constEnd()) {
+        return QString();
+    }
+    
+    return branch.commitHash + "..." + m_branches.at(it.value()).commitHash;
+}
+
+void BranchListModel::requestAheadBehind(const QString &key) const
+{
+    if (m_pending.contains(key)) {
+        return;
+    }
+    
+    const QString local = key.section("...", 0, 0);
+    const QString upstream = key.section("...", 1, 1);
+    BranchListModel *self = const_cast<BranchListModel*>(this);
+    
+    const quint64 requestId = m_gitManager->requestAheadBehind(local, upstream, self,
+        [self, key](bool success, int ahead, int behind) {
+            self->onAheadBehindReady(key, success ? ahead : -1, success ? behind : -1);
+        });
+    if (requestId) {
+        m_pending.insert(key, requestId);
+    }
+}
+
+void BranchListModel::onAheadBehindReady(const QString &key, int ahead, int behind)
+{
+    m_pending.remove(key);
+    m_aheadBehindCache.insert(key, {ahead, behind});
+    
+    const QList<int> rows = m_rowsByKey.values(key);
+    for (int row : rows) {
+        const QModelIndex cell = index(row, AheadBehindColumn);
+        emit dataChanged(cell, cell, {Qt::DisplayRole});
+    }
+}
\ No newline at end of file
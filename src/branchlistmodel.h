@@ -0,0 +1,61 @@
+#ifndef BRANCHLISTMODEL_H
+#define BRANCHLISTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include "gitmanager.h"
+
+class BranchListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        UpstreamColumn,
+        AheadBehindColumn,
+        DateColumn,
+        SubjectColumn,
+        ColumnCount
+    };
+    
+    enum Role {
+        BranchNameRole = Qt::UserRole,
+        SortRole,
+        IsRemoteRole,
+        IsCurrentRole
+    };
+    
+    explicit BranchListModel(GitManager *gitManager, QObject *parent = nullptr);
+    
+    void setBranches(const QString &repositoryPath, const QList<GitBranchRef> &branches);
+    const GitBranchRef &branchAt(int row) const;
+    
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private slots:
+    void onAheadBehindReady(const QString &key, int ahead, int behind);
+
+private:
+    struct AheadBehind {
+        int ahead;
+        int behind;
+    };
+    
+    QString aheadBehindKey(const GitBranchRef &branch) const;
+    void requestAheadBehind(const QString &key) const;
+    
+    GitManager *m_gitManager;
+    QString m_repositoryPath;
+    QList<GitBranchRef> m_branches;
+    QHash<QString, int> m_rowByName;
+    QStringList m_aheadBehindKeys;
+    QMultiHash<QString, int> m_rowsByKey;
+    QHash<QString, AheadBehind> m_aheadBehindCache;
+    mutable QHash<QString, quint64> m_pending;
+};
+
+#endif // BRANCHLISTMODEL_H
\ No newline at end of file
@@ -1,27 +1,55 @@
 #include "branchmanager.h"
 #include "gitmanager.h"
+#include "branchlistmodel.h"
 #include <QMessageBox>
 #include <QInputDialog>
+#include <QHeaderView>
 
 BranchManager::BranchManager(GitManager *gitManager, QObject *parent)
     : QObject(parent)
     , m_gitManager(gitManager)
     , m_dialog(nullptr)
+    , m_branchView(nullptr)
+    , m_branchModel(nullptr)
+    , m_proxyModel(nullptr)
+    , m_filterEdit(nullptr)
 {
+    connect(m_gitManager, &GitManager::branchChanged, this, &BranchManager::onRefsChanged);
+    connect(m_gitManager, &GitManager::remoteRefsChanged, this, &BranchManager::onRefsChanged);
 }
 
 void BranchManager::setupUI()
 {
     m_dialog = new QDialog();
     m_dialog->setWindowTitle("Branch Manager");
-    m_dialog->resize(400, 300);
+    m_dialog->resize(800, 500);
     
     QVBoxLayout *layout = new QVBoxLayout(m_dialog);
     
     QLabel *titleLabel = new QLabel("Branches");
     titleLabel->setStyleSheet("font-weight: bold; font-size: 14px;");
     
-    m_branchList = new QListWidget;
+    m_filterEdit = new QLineEdit;
+    m_filterEdit->setPlaceholderText("Filter branches...");
+    m_filterEdit->setClearButtonEnabled(true);
+    
+    m_branchModel = new BranchListModel(m_gitManager, this);
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_branchModel);
+    m_proxyModel->setFilterKeyColumn(BranchListModel::NameColumn);
+    m_proxyModel->setFilterRole(BranchListModel::BranchNameRole);
+    m_proxyModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    m_proxyModel->setSortRole(BranchListModel::SortRole);
+    
+    m_branchView = new QTreeView;
+    m_branchView->setModel(m_proxyModel);
+    m_branchView->setRootIsDecorated(false);
+    m_branchView->setUniformRowHeights(true);
+    m_branchView->setAlternatingRowColors(true);
+    m_branchView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_branchView->setSortingEnabled(true);
+    m_branchView->sortByColumn(BranchListModel::DateColumn, Qt::DescendingOrder);
+    m_branchView->header()->setSectionResizeMode(BranchListModel::SubjectColumn, QHeaderView::Stretch);
     
     QHBoxLayout *createLayout = new QHBoxLayout;
     m_branchNameEdit = new QLineEdit;
@@ -43,7 +71,8 @@ void BranchManager::setupUI()
     buttonLayout->addWidget(m_refreshButton);
     
     layout->addWidget(titleLabel);
-    layout->addWidget(m_branchList);
+    layout->addWidget(m_filterEdit);
+    layout->addWidget(m_branchView);
     layout->addLayout(createLayout);
     layout->addLayout(buttonLayout);
     
@@ -52,6 +81,7 @@ void BranchManager::setupUI()
     connect(m_deleteButton, &QPushButton::clicked, this, &BranchManager::deleteBranch);
     connect(m_mergeButton, &QPushButton::clicked, this, &BranchManager::mergeBranch);
     connect(m_refreshButton, &QPushButton::clicked, this, &BranchManager::refreshBranches);
+    connect(m_filterEdit, &QLineEdit::textChanged, this, &BranchManager::filterBranches);
 }
 
 void BranchManager::showBranchDialog()
@@ -66,23 +96,32 @@ void BranchManager::showBranchDialog()
 
 void BranchManager::populateBranchList()
 {
-    m_branchList->clear();
-    
     if (!m_gitManager->isRepositoryOpen()) {
+        m_branchModel->setBranches(QString(), QList<GitBranchRef>());
         return;
     }
     
-    QStringList branches = m_gitManager->getBranches();
-    QString currentBranch = m_gitManager->getCurrentBranch();
-    
-    for (const QString &branch : branches) {
-        QListWidgetItem *item = new QListWidgetItem(branch);
-        if (branch == currentBranch) {
-            item->setText("* " + branch);
-            item->setBackground(QBrush(QColor(0, 255, 0, 50)));
-        }
-        m_branchList->addItem(item);
+    m_branchModel->setBranches(m_gitManager->getRepositoryPath(), m_gitManager->getBranchRefs());
+}
+
+bool BranchManager::selectedBranch(QString &name, bool &isCurrent, bool &isRemote) const
+{
+    const QModelIndex index = m_branchView->currentIndex();
+    if (!index.isValid()) {
+        return false;
     }
+    
+    const QModelIndex source = m_proxyModel->mapToSource(index);
+    const GitBranchRef &branch = m_branchModel->branchAt(source.row());
+    name = branch.name;
+    isCurrent = branch.isCurrent;
+    isRemote = branch.isRemote;
+    return true;
+}
+
+void BranchManager::filterBranches(const QString &text)
+{
+    m_proxyModel->setFilterFixedString(text);
 }
 
 void BranchManager::createBranch()
@@ -104,17 +143,14 @@ void BranchManager::createBranch()
 
 void BranchManager::switchBranch()
 {
-    QListWidgetItem *current = m_branchList->currentItem();
-    if (!current) {
+    QString branchName;
+    bool isCurrent = false;
+    bool isRemote = false;
+    if (!selectedBranch(branchName, isCurrent, isRemote)) {
         QMessageBox::warning(m_dialog, "Error", "Please select a branch to switch to.");
         return;
     }
     
-    QString branchName = current->text();
-    if (branchName.startsWith("* ")) {
-        branchName = branchName.mid(2);
-    }
-    
     if (m_gitManager->switchBranch(branchName)) {
         populateBranchList();
         QMessageBox::information(m_dialog, "Success", "Switched to branch: " + branchName);
@@ -125,18 +161,24 @@ void BranchManager::switchBranch()
 
 void BranchManager::deleteBranch()
 {
-    QListWidgetItem *current = m_branchList->currentItem();
-    if (!current) {
+    QString branchName;
+    bool isCurrent = false;
+    bool isRemote = false;
+    if (!selectedBranch(branchName, isCurrent, isRemote)) {
         QMessageBox::warning(m_dialog, "Error", "Please select a branch to delete.");
         return;
     }
     
-    QString branchName = current->text();
-    if (branchName.startsWith("* ")) {
+    if (isCurrent) {
         QMessageBox::warning(m_dialog, "Error", "Cannot delete the current branch.");
         return;
     }
     
+    if (isRemote) {
+        QMessageBox::warning(m_dialog, "Error", "Cannot delete a remote-tracking branch.");
+        return;
+    }
+    
     int ret = QMessageBox::question(m_dialog, "Delete Branch", 
         "Are you sure you want to delete branch: " + branchName + "?",
         QMessageBox::Yes | QMessageBox::No, QMessageBox::No);
@@ -153,14 +195,15 @@ void BranchManager::deleteBranch()
 
 void BranchManager::mergeBranch()
 {
-    QListWidgetItem *current = m_branchList->currentItem();
-    if (!current) {
+    QString branchName;
+    bool isCurrent = false;
+    bool isRemote = false;
+    if (!selectedBranch(branchName, isCurrent, isRemote)) {
         QMessageBox::warning(m_dialog, "Error", "Please select a branch to merge.");
         return;
     }
     
-    QString branchName = current->text();
-    if (branchName.startsWith("* ")) {
+    if (isCurrent) {
         QMessageBox::warning(m_dialog, "Error", "Cannot merge the current branch into itself.");
         return;
     }
@@ -181,4 +224,11 @@ void BranchManager::mergeBranch()
 void BranchManager::refreshBranches()
 {
     populateBranchList();
+}
+
+void BranchManager::onRefsChanged()
+{
+    if (m_dialog && m_dialog->isVisible()) {
+        populateBranchList();
+    }
 }
\ No newline at end of file
@@ -4,7 +4,8 @@
 #include <QObject>
 #include <QWidget>
 #include <QDialog>
-#include <QListWidget>
+#include <QTreeView>
+#include <QSortFilterProxyModel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
@@ -12,6 +13,7 @@
 #include <QLabel>
 
 class GitManager;
+class BranchListModel;
 
 class BranchManager : public QObject
 {
@@ -28,11 +30,16 @@ private slots:
     void deleteBranch();
     void mergeBranch();
     void refreshBranches();
+    void filterBranches(const QString &text);
+    void onRefsChanged();
 
 private:
     GitManager *m_gitManager;
     QDialog *m_dialog;
-    QListWidget *m_branchList;
+    QTreeView *m_branchView;
+    BranchListModel *m_branchModel;
+    QSortFilterProxyModel *m_proxyModel;
+    QLineEdit *m_filterEdit;
     QLineEdit *m_branchNameEdit;
     QPushButton *m_createButton;
     QPushButton *m_switchButton;
@@ -42,6 +49,7 @@ private:
     
     void setupUI();
     void populateBranchList();
+    bool selectedBranch(QString &name, bool &isCurrent, bool &isRemote) const;
 };
 
 #endif // BRANCHMANAGER_H
\ No newline at end of file
@@ -0,0 +1,476 @@
+#include "commitgraph.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QtEndian>
+#include <cstring>
+#include <queue>
+#include <vector>
+
+namespace {
+
+const quint32 ChunkOidFanout = 0x4f494446;
+const quint32 ChunkOidLookup = 0x4f49444c;
+const quint32 ChunkCommitData = 0x43444154;
+const quint32 ChunkGenerationData = 0x47444132;
+const quint32 ChunkGenerationOverflow = 0x47444f32;
+const quint32 ChunkExtraEdges = 0x45444745;
+
+const quint32 ParentNone = 0x70000000;
+const quint32 ParentExtraEdges = 0x80000000;
+const quint32 ParentLastEdge = 0x80000000;
+const quint32 GenerationOverflowBit = 0x80000000;
+
+quint32 readUInt32(const uchar *data)
+{
+    return qFromBigEndian<quint32>(data);
+}
+
+quint64 readUInt64(const uchar *data)
+{
+    return qFromBigEndian<quint64>(data);
+}
+
+}
+
+CommitGraph::CommitGraph()
+    : m_hashLength(0)
+    , m_commitCount(0)
+    , m_hasCorrectedDates(false)
+{
+}
+
+CommitGraph::~CommitGraph()
+{
+    close();
+}
+
+bool CommitGraph::load(const QString &objectsDirectory)
+{
+    close();
+    
+    QDir infoDir(objectsDirectory + "/info");
+    const QString singleFile = infoDir.filePath("commit-graph");
+    const QString chainFile = infoDir.filePath("commit-graphs/commit-graph-chain");
+    
+    if (QFileInfo::exists(chainFile)) {
+        QFile chain(chainFile);
+        if (!chain.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return false;
+        }
+        
+        QTextStream stream(&chain);
+        quint32 base = 0;
+        while (!stream.atEnd()) {
+            const QString hash = stream.readLine().trimmed();
+            if (hash.isEmpty()) {
+                continue;
+            }
+            if (!loadLayer(infoDir.filePath("commit-graphs/graph-" + hash + ".graph"), base)) {
+                close();
+                return false;
+            }
+            base += m_layers.last().count;
+        }
+        m_sourcePath = chainFile;
+    } else if (QFileInfo::exists(singleFile)) {
+        if (!loadLayer(singleFile, 0)) {
+            close();
+            return false;
+        }
+        m_sourcePath = singleFile;
+    } else {
+        return false;
+    }
+    
+    if (m_layers.isEmpty()) {
+        close();
+        return false;
+    }
+    
+    m_commitCount = m_layers.last().base + m_layers.last().count;
+    m_hasCorrectedDates = true;
+    for (const Layer &layer : m_layers) {
+        if (!layer.generationData) {
+            m_hasCorrectedDates = false;
+        }
+    }
+    m_loadedModified = QFileInfo(m_sourcePath).lastModified();
+    return true;
+}
+
+bool CommitGraph::loadLayer(const QString &fileName, quint32 base)
+{
+    QFile *file = new QFile(fileName);
+    if (!file->open(QIODevice::ReadOnly)) {
+        delete file;
+        return false;
+    }
+    
+    const qint64 size = file->size();
+    const uchar *data = size >= 8 ? file->map(0, size) : nullptr;
+    if (!data || readUInt32(data) != 0x43475048 || data[4] != 1) {
+        delete file;
+        return false;
+    }
+    
+    const int hashLength = data[5] == 2 ? 32 : (data[5] == 1 ? 20 : 0);
+    if (hashLength == 0 || (m_hashLength != 0 && hashLength != m_hashLength)) {
+        delete file;
+        return false;
+    }
+    m_hashLength = hashLength;
+    
+    Layer layer;
+    layer.file = file;
+    layer.data = data;
+    layer.size = size;
+    layer.base = base;
+    layer.count = 0;
+    layer.fanout = nullptr;
+    layer.oids = nullptr;
+    layer.commitData = nullptr;
+    layer.extraEdges = nullptr;
+    layer.extraEdgeCount = 0;
+    layer.generationData = nullptr;
+    layer.generationOverflow = nullptr;
+    layer.generationOverflowCount = 0;
+    
+    const int chunkCount = data[6];
+    const qint64 tableEnd = 8 + qint64(chunkCount + 1) * 12;
+    if (tableEnd > size) {
+        delete file;
+        return false;
+    }
+    
+    for (int i = 0; i < chunkCount; ++i) {
+        const uchar *entry = data + 8 + i * 12;
+        const quint32 id = readUInt32(entry);
+        const quint64 offset = readUInt64(entry + 4);
+        const quint64 next = readUInt64(entry + 16);
+        if (offset > quint64(size) || next > quint64(size) || next < offset) {
+            delete file;
+            return false;
+        }
+        
+        const uchar *chunk = data + offset;
+        const qint64 chunkSize = qint64(next - offset);
+        switch (id) {
+        case ChunkOidFanout:
+            if (chunkSize >= 256 * 4) {
+                layer.fanout = chunk;
+                layer.count = readUInt32(chunk + 255 * 4);
+            }
+            break;
+        case ChunkOidLookup:
+            layer.oids = chunk;
+            break;
+        case ChunkCommitData:
+            layer.commitData = chunk;
+            break;
+        case ChunkExtraEdges:
+            layer.extraEdges = chunk;
+            layer.extraEdgeCount = chunkSize / 4;
+            break;
+        case ChunkGenerationData:
+            layer.generationData = chunk;
+            break;
+        case ChunkGenerationOverflow:
+            layer.generationOverflow = chunk;
+            layer.generationOverflowCount = chunkSize / 8;
+            break;
+        default:
+            break;
+        }
+    }
+    
+    if (!layer.fanout || !layer.oids || !layer.commitData) {
+        delete file;
+        return false;
+    }
+    
+    const qint64 recordSize = hashLength + 16;
+    if (layer.oids + qint64(layer.count) * hashLength > data + size
+        || layer.commitData + qint64(layer.count) * recordSize > data + size) {
+        delete file;
+        return false;
+    }
+    
+    m_layers.append(layer);
+    return true;
+}
+
+void CommitGraph::close()
+{
+    for (Layer &layer : m_layers) {
+        delete layer.file;
+    }
+    m_layers.clear();
+    m_sourcePath.clear();
+    m_loadedModified = QDateTime();
+    m_hashLength = 0;
+    m_commitCount = 0;
+    m_hasCorrectedDates = false;
+}
+
+bool CommitGraph::isValid() const
+{
+    return !m_layers.isEmpty();
+}
+
+bool CommitGraph::isStale(const QString &objectsDirectory) const
+{
+    QDir infoDir(objectsDirectory + "/info");
+    QString current = infoDir.filePath("commit-graphs/commit-graph-chain");
+    if (!QFileInfo::exists(current)) {
+        current = infoDir.filePath("commit-graph");
+    }
+    
+    if (!QFileInfo::exists(current)) {
+        return isValid();
+    }
+    
+    return current != m_sourcePath || QFileInfo(current).lastModified() != m_loadedModified;
+}
+
+int CommitGraph::hashLength() const
+{
+    return m_hashLength;
+}
+
+quint32 CommitGraph::commitCount() const
+{
+    return m_commitCount;
+}
+
+bool CommitGraph::hasCorrectedDates() const
+{
+    return m_hasCorrectedDates;
+}
+
+quint32 CommitGraph::findCommit(const QByteArray &commitId) const
+{
+    if (commitId.size() != m_hashLength) {
+        return InvalidPosition;
+    }
+    
+    const uchar *key = reinterpret_cast<const uchar *>(commitId.constData());
+    const int first = key[0];
+    
+    for (const Layer &layer : m_layers) {
+        quint32 low = first == 0 ? 0 : readUInt32(layer.fanout + (first - 1) * 4);
+        quint32 high = readUInt32(layer.fanout + first * 4);
+        
+        while (low < high) {
+            const quint32 middle = low + (high - low) / 2;
+            const int cmp = memcmp(layer.oids + qint64(middle) * m_hashLength, key, m_hashLength);
+            if (cmp == 0) {
+                return layer.base + middle;
+            }
+            if (cmp < 0) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+    }
+    
+    return InvalidPosition;
+}
+
+const CommitGraph::Layer *CommitGraph::layerFor(quint32 position) const
+{
+    for (int i = m_layers.size() - 1; i >= 0; --i) {
+        const Layer &layer = m_layers.at(i);
+        if (position >= layer.base) {
+            return position < layer.base + layer.count ? &layer : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+const uchar *CommitGraph::commitRecord(quint32 position, const Layer **layer) const
+{
+    const Layer *owner = layerFor(position);
+    if (!owner) {
+        return nullptr;
+    }
+    if (layer) {
+        *layer = owner;
+    }
+    return owner->commitData + qint64(position - owner->base) * (m_hashLength + 16);
+}
+
+QByteArray CommitGraph::commitId(quint32 position) const
+{
+    const Layer *layer = layerFor(position);
+    if (!layer) {
+        return QByteArray();
+    }
+    
+    const uchar *oid = layer->oids + qint64(position - layer->base) * m_hashLength;
+    return QByteArray(reinterpret_cast<const char *>(oid), m_hashLength);
+}
+
+QByteArray CommitGraph::rootTree(quint32 position) const
+{
+    const uchar *record = commitRecord(position);
+    if (!record) {
+        return QByteArray();
+    }
+    
+    return QByteArray(reinterpret_cast<const char *>(record), m_hashLength);
+}
+
+QVector<quint32> CommitGraph::parents(quint32 position) const
+{
+    QVector<quint32> result;
+    const Layer *layer = nullptr;
+    const uchar *record = commitRecord(position, &layer);
+    if (!record) {
+        return result;
+    }
+    
+    const quint32 first = readUInt32(record + m_hashLength);
+    const quint32 second = readUInt32(record + m_hashLength + 4);
+    
+    if (first == ParentNone) {
+        return result;
+    }
+    result.append(first);
+    
+    if (second == ParentNone) {
+        return result;
+    }
+    
+    if (!(second & ParentExtraEdges)) {
+        result.append(second);
+        return result;
+    }
+    
+    qint64 edge = second & ~ParentExtraEdges;
+    while (layer->extraEdges && edge < layer->extraEdgeCount) {
+        const quint32 value = readUInt32(layer->extraEdges + edge * 4);
+        result.append(value & ~ParentLastEdge);
+        if (value & ParentLastEdge) {
+            break;
+        }
+        ++edge;
+    }
+    
+    return result;
+}
+
+qint64 CommitGraph::commitTime(quint32 position) const
+{
+    const uchar *record = commitRecord(position);
+    if (!record) {
+        return 0;
+    }
+    
+    const quint32 high = readUInt32(record + m_hashLength + 8);
+    const quint32 low = readUInt32(record + m_hashLength + 12);
+    return (qint64(high & 0x3) << 32) | low;
+}
+
+quint32 CommitGraph::topologicalLevel(quint32 position) const
+{
+    const uchar *record = commitRecord(position);
+    if (!record) {
+        return 0;
+    }
+    
+    return readUInt32(record + m_hashLength + 8) >> 2;
+}
+
+quint64 CommitGraph::generation(quint32 position) const
+{
+    if (!m_hasCorrectedDates) {
+        return topologicalLevel(position);
+    }
+    
+    const Layer *layer = layerFor(position);
+    if (!layer) {
+        return 0;
+    }
+    
+    const quint32 offset = readUInt32(layer->generationData + qint64(position - layer->base) * 4);
+    if (!(offset & GenerationOverflowBit)) {
+        return quint64(commitTime(position)) + offset;
+    }
+    
+    const qint64 overflow = offset & ~GenerationOverflowBit;
+    if (!layer->generationOverflow || overflow >= layer->generationOverflowCount) {
+        return quint64(commitTime(position));
+    }
+    return quint64(commitTime(position)) + readUInt64(layer->generationOverflow + overflow * 8);
+}
+
+QVector<quint32> CommitGraph::walk(const QVector<quint32> &tips, int limit) const
+{
+    QVector<quint32> order;
+    if (!isValid()) {
+        return order;
+    }
+    
+    // Generation numbers are strictly greater than those of any parent, so
+    // popping the highest (generation, commit time) yields children before
+    // their parents while staying close to git log's date order.
+    typedef std::pair<std::pair<quint64, qint64>, quint32> Entry;
+    std::priority_queue<Entry> queue;
+    std::vector<bool> seen(m_commitCount, false);
+    
+    for (quint32 tip : tips) {
+        if (tip < m_commitCount && !seen[tip]) {
+            seen[tip] = true;
+            queue.push({{generation(tip), commitTime(tip)}, tip});
+        }
+    }
+    
+    while (!queue.empty() && (limit < 0 || order.size() < limit)) {
+        const quint32 position = queue.top().second;
+        queue.pop();
+        order.append(position);
+        
+        const QVector<quint32> parentPositions = parents(position);
+        for (quint32 parent : parentPositions) {
+            if (parent < m_commitCount && !seen[parent]) {
+                seen[parent] = true;
+                queue.push({{generation(parent), commitTime(parent)}, parent});
+            }
+        }
+    }
+    
+    return order;
+}
+
+bool CommitGraph::isAncestor(quint32 ancestor, quint32 descendant) const
+{
+    if (ancestor >= m_commitCount || descendant >= m_commitCount) {
+        return false;
+    }
+    
+    const quint64 cutoff = generation(ancestor);
+    std::vector<bool> seen(m_commitCount, false);
+    QVector<quint32> stack;
+    stack.append(descendant);
+    seen[descendant] = true;
+    
+    while (!stack.isEmpty()) {
+        const quint32 position = stack.takeLast();
+        if (position == ancestor) {
+            return true;
+        }
+        
+        const QVector<quint32> parentPositions = parents(position);
+        for (quint32 parent : parentPositions) {
+            if (parent < m_commitCount && !seen[parent] && generation(parent) >= cutoff) {
+                seen[parent] = true;
+                stack.append(parent);
+            }
+        }
+    }
+    
+    return false;
+}
\ No newline at end of file
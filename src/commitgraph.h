@@ -0,0 +1,69 @@
+#ifndef COMMITGRAPH_H
+#define COMMITGRAPH_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+class QFile;
+
+class CommitGraph
+{
+public:
+    static const quint32 InvalidPosition = 0xffffffff;
+    
+    CommitGraph();
+    ~CommitGraph();
+    
+    bool load(const QString &objectsDirectory);
+    void close();
+    bool isValid() const;
+    bool isStale(const QString &objectsDirectory) const;
+    
+    int hashLength() const;
+    quint32 commitCount() const;
+    bool hasCorrectedDates() const;
+    
+    quint32 findCommit(const QByteArray &commitId) const;
+    QByteArray commitId(quint32 position) const;
+    QByteArray rootTree(quint32 position) const;
+    QVector<quint32> parents(quint32 position) const;
+    qint64 commitTime(quint32 position) const;
+    quint32 topologicalLevel(quint32 position) const;
+    quint64 generation(quint32 position) const;
+    
+    QVector<quint32> walk(const QVector<quint32> &tips, int limit = -1) const;
+    bool isAncestor(quint32 ancestor, quint32 descendant) const;
+
+private:
+    struct Layer {
+        QFile *file;
+        const uchar *data;
+        qint64 size;
+        quint32 base;
+        quint32 count;
+        const uchar *fanout;
+        const uchar *oids;
+        const uchar *commitData;
+        const uchar *extraEdges;
+        qint64 extraEdgeCount;
+        const uchar *generationData;
+        const uchar *generationOverflow;
+        qint64 generationOverflowCount;
+    };
+    
+    bool loadLayer(const QString &fileName, quint32 base);
+    const Layer *layerFor(quint32 position) const;
+    const uchar *commitRecord(quint32 position, const Layer **layer = nullptr) const;
+    
+    QList<Layer> m_layers;
+    QString m_sourcePath;
+    QDateTime m_loadedModified;
+    int m_hashLength;
+    quint32 m_commitCount;
+    bool m_hasCorrectedDates;
+};
+
+#endif // COMMITGRAPH_H
\ No newline at end of file
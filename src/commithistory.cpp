@@ -1,7 +1,7 @@
 #include "commithistory.h"
 #include "gitmanager.h"
-#include <QFont>
-#include <QFontMetrics>
+#include "gittracer.h"
+#include <QSettings>
 
 CommitHistory::CommitHistory(GitManager *gitManager, QWidget *parent)
     : QWidget(parent)
@@ -12,11 +12,12 @@ CommitHistory::CommitHistory(GitManager *gitManager, QWidget *parent)
     , m_splitter(nullptr)
     , m_titleLabel(nullptr)
     , m_refreshButton(nullptr)
+    , m_requestSerial(0)
 {
     setupUI();
     
     connect(m_gitManager, &GitManager::repositoryChanged, this, &CommitHistory::refresh);
-    connect(m_gitManager, &GitManager::branchChanged, this, &CommitHistory::refresh);
+    connect(m_gitManager, &GitManager::headMoved, this, &CommitHistory::onHeadMoved);
 }
 
 void CommitHistory::setupUI()
@@ -40,8 +41,9 @@ void CommitHistory::setupUI()
     m_splitter = new QSplitter(Qt::Vertical);
     
     m_listView = new QListView;
-    m_model = new QStandardItemModel(this);
+    m_model = new CommitListModel(this);
     m_listView->setModel(m_model);
+    m_listView->setUniformItemSizes(true);
     m_listView->setSelectionMode(QAbstractItemView::SingleSelection);
     m_listView->setAlternatingRowColors(true);
     
@@ -62,62 +64,59 @@ void CommitHistory::setupUI()
 
 void CommitHistory::refresh()
 {
+    const quint64 serial = ++m_requestSerial;
     if (!m_gitManager->isRepositoryOpen()) {
         m_model->clear();
         m_detailsView->setPlainText("No repository opened...");
         return;
     }
     
-    populateCommitList();
+    int limit = QSettings().value("history/maxCommits", 100000).toInt();
+    m_gitManager->requestCommitStore(limit, this, [this, serial](QSharedPointer<const CommitStore> store) {
+        if (serial == m_requestSerial) {
+            populateCommitList(store);
+        }
+    });
 }
 
-void CommitHistory::populateCommitList()
+void CommitHistory::onHeadMoved(const QString &oldHead, const QString &newHead)
 {
-    m_model->clear();
-    
-    QList<GitCommit> commits = m_gitManager->getCommitHistory(100);
-    
-    for (const GitCommit &commit : commits) {
-        QStandardItem *item = new QStandardItem();
-        
-        QString displayText = QString("%1 - %2\n%3 (%4)")
-            .arg(commit.hash.left(8))
-            .arg(commit.message)
-            .arg(commit.author)
-            .arg(commit.date);
-        
-        item->setText(displayText);
-        item->setData(commit.hash, Qt::UserRole);
-        item->setData(commit.message, Qt::UserRole + 1);
-        item->setData(commit.author, Qt::UserRole + 2);
-        item->setData(commit.date, Qt::UserRole + 3);
-        
-        QFont font = item->font();
-        font.setFamily("Courier New");
-        font.setPointSize(9);
-        item->setFont(font);
-        
-        item->setToolTip(QString("Hash: %1\nAuthor: %2\nDate: %3\nMessage: %4")
-            .arg(commit.hash)
-            .arg(commit.author)
-            .arg(commit.date)
-            .arg(commit.message));
-        
-        m_model->appendRow(item);
-    }
+    const quint64 serial = ++m_requestSerial;
+    int limit = QSettings().value("history/maxCommits", 100000).toInt();
+    m_gitManager->requestCommitStoreUpdate(m_model->store(), oldHead, newHead, limit, this,
+        [this, serial](QSharedPointer<const CommitStore> store) {
+            if (serial == m_requestSerial) {
+                populateCommitList(store);
+            }
+        });
+}
+
+void CommitHistory::showCommits(const QList<GitCommit> &commits)
+{
+    ++m_requestSerial;
+    populateCommitList(QSharedPointer<const CommitStore>(new CommitStore(CommitStore::fromCommits(commits))));
+}
+
+QList<GitCommit> CommitHistory::commits() const
+{
+    return m_model->store()->commits(100);
+}
+
+void CommitHistory::populateCommitList(QSharedPointer<const CommitStore> store)
+{
+    GitTraceSpan span("model", "CommitHistory::populateCommitList");
+    span.setItemCount(store->size());
+    m_model->setStore(store);
 }
 
 void CommitHistory::onCommitClicked(const QModelIndex &index)
 {
     if (index.isValid()) {
-        QStandardItem *item = m_model->itemFromIndex(index);
-        if (item) {
-            QString commitHash = item->data(Qt::UserRole).toString();
-            if (!commitHash.isEmpty()) {
-                m_selectedCommit = commitHash;
-                showCommitDetails(commitHash);
-                emit commitSelected(commitHash);
-            }
+        QString commitHash = index.data(CommitListModel::HashRole).toString();
+        if (!commitHash.isEmpty()) {
+            m_selectedCommit = commitHash;
+            showCommitDetails(commitHash);
+            emit commitSelected(commitHash);
         }
     }
 }
@@ -126,20 +125,17 @@ void CommitHistory::showCommitDetails(const QString &commitHash)
 {
     QModelIndex index = m_listView->currentIndex();
     if (index.isValid()) {
-        QStandardItem *item = m_model->itemFromIndex(index);
-        if (item) {
-            QString hash = item->data(Qt::UserRole).toString();
-            QString message = item->data(Qt::UserRole + 1).toString();
-            QString author = item->data(Qt::UserRole + 2).toString();
-            QString date = item->data(Qt::UserRole + 3).toString();
-            
-            QString details = QString("Commit: %1\nAuthor: %2\nDate: %3\n\nMessage:\n%4")
-                .arg(hash)
-                .arg(author)
-                .arg(date)
-                .arg(message);
-            
-            m_detailsView->setPlainText(details);
-        }
+        QString hash = index.data(CommitListModel::HashRole).toString();
+        QString message = index.data(CommitListModel::SubjectRole).toString();
+        QString author = index.data(CommitListModel::AuthorRole).toString();
+        QString date = index.data(CommitListModel::DateRole).toString();
+        
+        QString details = QString("Commit: %1\nAuthor: %2\nDate: %3\n\nMessage:\n%4")
+            .arg(hash)
+            .arg(author)
+            .arg(date)
+            .arg(message);
+        
+        m_detailsView->setPlainText(details);
     }
 }
\ No newline at end of file
@@ -3,7 +3,6 @@
 
 #include <QWidget>
 #include <QListView>
-#include <QStandardItemModel>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLabel>
@@ -11,7 +10,8 @@
 #include <QTextEdit>
 #include <QSplitter>
 
-class GitManager;
+#include "gitmanager.h"
+#include "commitlistmodel.h"
 
 class CommitHistory : public QWidget
 {
@@ -21,27 +21,31 @@ public:
     explicit CommitHistory(GitManager *gitManager, QWidget *parent = nullptr);
     
     void refresh();
+    void showCommits(const QList<GitCommit> &commits);
+    QList<GitCommit> commits() const;
 
 signals:
     void commitSelected(const QString &commitHash);
 
 private slots:
     void onCommitClicked(const QModelIndex &index);
+    void onHeadMoved(const QString &oldHead, const QString &newHead);
     void showCommitDetails(const QString &commitHash);
 
 private:
     void setupUI();
-    void populateCommitList();
+    void populateCommitList(QSharedPointer<const CommitStore> store);
     
     GitManager *m_gitManager;
     QListView *m_listView;
-    QStandardItemModel *m_model;
+    CommitListModel *m_model;
     QTextEdit *m_detailsView;
     QSplitter *m_splitter;
     QLabel *m_titleLabel;
     QPushButton *m_refreshButton;
     
     QString m_selectedCommit;
+    quint64 m_requestSerial;
 };
 
 #endif // COMMITHISTORY_H
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "commitlistmodel.h"
+#include <QDateTime>
+
+CommitListModel::CommitListModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(new CommitStore)
+{
+    m_font.setFamily("Courier New");
+    m_font.setPointSize(9);
+}
+
+void CommitListModel::setStore(QSharedPointer<const CommitStore> store)
+{
+    beginResetModel();
+    m_store = store ? store : QSharedPointer<const CommitStore>(new CommitStore);
+    endResetModel();
+}
+
+QSharedPointer<const CommitStore> CommitListModel::store() const
+{
+    return m_store;
+}
+
+void CommitListModel::clear()
+{
+    setStore(QSharedPointer<const CommitStore>());
+}
+
+int CommitListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_store->size();
+}
+
+QVariant CommitListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_store->size()) {
+        return QVariant();
+    }
+    
+    const CommitStore::Index row = CommitStore::Index(index.row());
+    
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString("%1 - %2\n%3 (%4)")
+            .arg(m_store->hash(row).left(8))
+            .arg(m_store->subject(row))
+            .arg(m_store->author(row))
+            .arg(formatDate(m_store->time(row)));
+    case Qt::ToolTipRole:
+        return QString("Hash: %1\nAuthor: %2\nDate: %3\nMessage: %4")
+            .arg(m_store->hash(row))
+            .arg(m_store->author(row))
+            .arg(formatDate(m_store->time(row)))
+            .arg(m_store->subject(row));
+    case Qt::FontRole:
+        return m_font;
+    case HashRole:
+        return m_store->hash(row);
+    case SubjectRole:
+        return m_store->subject(row);
+    case AuthorRole:
+        return m_store->author(row);
+    case DateRole:
+        return formatDate(m_store->time(row));
+    case TimeRole:
+        return m_store->time(row);
+    default:
+        return QVariant();
+    }
+}
+
+QString CommitListModel::formatDate(qint64 time)
+{
+    return QDateTime::fromSecsSinceEpoch(time).toString("yyyy-MM-dd");
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#ifndef COMMITLISTMODEL_H
+#define COMMITLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QFont>
+#include <QSharedPointer>
+#include "commitstore.h"
+
+class CommitListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Role {
+        HashRole = Qt::UserRole,
+        SubjectRole,
+        AuthorRole,
+        DateRole,
+        TimeRole
+    };
+    
+    explicit CommitListModel(QObject *parent = nullptr);
+    
+    void setStore(QSharedPointer<const CommitStore> store);
+    QSharedPointer<const CommitStore> store() const;
+    void clear();
+    
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    static QString formatDate(qint64 time);
+    
+    QSharedPointer<const CommitStore> m_store;
+    QFont m_font;
+};
+
+#endif // COMMITLISTMODEL_H
\ No newline at end of file
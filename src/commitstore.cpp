@@ -0,0 +1,427 @@
+#include "commitstore.h"
+#include "gitmanager.h"
+#include <QDateTime>
+#include <cstring>
+
+namespace {
+
+const int MinimumTableCapacity = 1024;
+
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool decodeHex(const char *data, int size, QByteArray &out)
+{
+    if (size != 40 && size != 64) {
+        return false;
+    }
+    
+    out.resize(size / 2);
+    for (int i = 0; i < size / 2; ++i) {
+        const int high = hexValue(data[2 * i]);
+        const int low = hexValue(data[2 * i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        out[i] = char((high << 4) | low);
+    }
+    return true;
+}
+
+}
+
+CommitStore::CommitStore()
+    : m_hashLength(20)
+    , m_count(0)
+    , m_finalized(true)
+{
+    clear();
+}
+
+void CommitStore::clear()
+{
+    m_hashLength = 20;
+    m_count = 0;
+    m_ids.clear();
+    m_table.clear();
+    m_times.clear();
+    m_authorIndices.clear();
+    m_authors.clear();
+    m_authorLookup.clear();
+    m_subjects.clear();
+    m_subjectOffsets = QVector<quint32>(1, 0);
+    m_parentOffsets = QVector<quint32>(1, 0);
+    m_parents.clear();
+    m_pendingParentIds.clear();
+    m_externalIds.clear();
+    m_externalLookup.clear();
+    m_finalized = true;
+}
+
+void CommitStore::reserve(int commits)
+{
+    m_ids.reserve(commits * m_hashLength);
+    m_times.reserve(commits);
+    m_authorIndices.reserve(commits);
+    m_subjectOffsets.reserve(commits + 1);
+    m_parentOffsets.reserve(commits + 1);
+    if (commits * 2 > m_table.size()) {
+        rehash(commits * 2);
+    }
+}
+
+bool CommitStore::appendLogRecord(const char *data, int size)
+{
+    const char *fields[5];
+    int lengths[5];
+    const char *cursor = data;
+    const char *end = data + size;
+    
+    for (int field = 0; field < 5; ++field) {
+        const char *separator = field < 4 ? static_cast<const char*>(memchr(cursor, '\0', end - cursor)) : end;
+        if (!separator) {
+            return false;
+        }
+        fields[field] = cursor;
+        lengths[field] = int(separator - cursor);
+        cursor = separator + 1;
+    }
+    
+    QByteArray id;
+    if (!decodeHex(fields[0], lengths[0], id)) {
+        return false;
+    }
+    
+    QList<QByteArray> parentIds;
+    const char *parent = fields[4];
+    const char *parentsEnd = fields[4] + lengths[4];
+    while (parent < parentsEnd) {
+        const char *space = static_cast<const char*>(memchr(parent, ' ', parentsEnd - parent));
+        const char *next = space ? space : parentsEnd;
+        QByteArray parentId;
+        if (decodeHex(parent, int(next - parent), parentId)) {
+            parentIds.append(parentId);
+        }
+        parent = next + 1;
+    }
+    
+    const qint64 time = QByteArray::fromRawData(fields[2], lengths[2]).toLongLong();
+    return append(id, time,
+                  QString::fromUtf8(fields[1], lengths[1]),
+                  QString::fromUtf8(fields[3], lengths[3]),
+                  parentIds) != InvalidIndex;
+}
+
+CommitStore::Index CommitStore::append(const QByteArray &commitId, qint64 time, const QString &author,
+                                       const QString &subject, const QList<QByteArray> &parentIds)
+{
+    if (m_count == 0) {
+        if (commitId.size() != 20 && commitId.size() != 32) {
+            return InvalidIndex;
+        }
+        m_hashLength = commitId.size();
+    }
+    if (commitId.size() != m_hashLength || quint32(m_count) >= ExternalFlag - 1) {
+        return InvalidIndex;
+    }
+    
+    const uchar *id = reinterpret_cast<const uchar*>(commitId.constData());
+    const Index existing = lookup(id);
+    if (existing != InvalidIndex) {
+        return existing;
+    }
+    
+    if ((m_count + 1) * 2 > m_table.size()) {
+        rehash(qMax(MinimumTableCapacity, int(m_table.size()) * 2));
+    }
+    
+    const Index index = Index(m_count++);
+    m_ids.append(commitId);
+    m_times.append(time);
+    
+    auto authorIt = m_authorLookup.constFind(author);
+    if (authorIt == m_authorLookup.constEnd()) {
+        authorIt = m_authorLookup.insert(author, quint32(m_authors.size()));
+        m_authors.append(author);
+    }
+    m_authorIndices.append(authorIt.value());
+    
+    m_subjects.append(subject.toUtf8());
+    m_subjectOffsets.append(quint32(m_subjects.size()));
+    
+    for (const QByteArray &parentId : parentIds) {
+        if (parentId.size() == m_hashLength) {
+            m_pendingParentIds.append(parentId);
+        }
+    }
+    m_parentOffsets.append(quint32(m_parents.size() + m_pendingParentIds.size() / m_hashLength));
+    m_finalized = false;
+    
+    quint32 slot = hashId(id) & quint32(m_table.size() - 1);
+    while (m_table[slot] != InvalidIndex) {
+        slot = (slot + 1) & quint32(m_table.size() - 1);
+    }
+    m_table[slot] = index;
+    
+    return index;
+}
+
+void CommitStore::appendStore(const CommitStore &other, int limit)
+{
+    const int count = limit < 0 ? other.m_count : qMin(other.m_count, qMax(0, limit - m_count));
+    reserve(m_count + count);
+    
+    for (int i = 0; i < count; ++i) {
+        const Index index = Index(i);
+        QList<QByteArray> parentIds;
+        const int parents = other.parentCount(index);
+        for (int n = 0; n < parents; ++n) {
+            parentIds.append(other.parentId(index, n));
+        }
+        append(other.commitId(index), other.time(index), other.author(index), other.subject(index), parentIds);
+    }
+}
+
+void CommitStore::finalize()
+{
+    if (m_finalized) {
+        return;
+    }
+    
+    const int pending = m_pendingParentIds.size() / m_hashLength;
+    m_parents.reserve(m_parents.size() + pending);
+    for (int i = 0; i < pending; ++i) {
+        const uchar *id = reinterpret_cast<const uchar*>(m_pendingParentIds.constData()) + i * m_hashLength;
+        const Index index = lookup(id);
+        m_parents.append(index != InvalidIndex ? index : (internExternal(id) | ExternalFlag));
+    }
+    
+    m_pendingParentIds.clear();
+    m_pendingParentIds.squeeze();
+    m_externalLookup.clear();
+    m_finalized = true;
+}
+
+int CommitStore::size() const
+{
+    return m_count;
+}
+
+bool CommitStore::isEmpty() const
+{
+    return m_count == 0;
+}
+
+int CommitStore::hashLength() const
+{
+    return m_hashLength;
+}
+
+CommitStore::Index CommitStore::find(const QByteArray &commitId) const
+{
+    if (commitId.size() != m_hashLength) {
+        return InvalidIndex;
+    }
+    return lookup(reinterpret_cast<const uchar*>(commitId.constData()));
+}
+
+QByteArray CommitStore::commitId(Index index) const
+{
+    return m_ids.mid(int(index) * m_hashLength, m_hashLength);
+}
+
+QString CommitStore::hash(Index index) const
+{
+    return QString::fromLatin1(commitId(index).toHex());
+}
+
+qint64 CommitStore::time(Index index) const
+{
+    return m_times.at(int(index));
+}
+
+QString CommitStore::author(Index index) const
+{
+    return m_authors.at(int(m_authorIndices.at(int(index))));
+}
+
+QString CommitStore::subject(Index index) const
+{
+    const quint32 begin = m_subjectOffsets.at(int(index));
+    const quint32 end = m_subjectOffsets.at(int(index) + 1);
+    return QString::fromUtf8(m_subjects.constData() + begin, int(end - begin));
+}
+
+int CommitStore::parentCount(Index index) const
+{
+    return int(m_parentOffsets.at(int(index) + 1) - m_parentOffsets.at(int(index)));
+}
+
+CommitStore::Index CommitStore::parent(Index index, int n) const
+{
+    if (!m_finalized) {
+        return find(parentId(index, n));
+    }
+    
+    const quint32 value = m_parents.at(int(m_parentOffsets.at(int(index))) + n);
+    return (value & ExternalFlag) ? InvalidIndex : value;
+}
+
+QByteArray CommitStore::parentId(Index index, int n) const
+{
+    const int position = int(m_parentOffsets.at(int(index))) + n;
+    if (!m_finalized && position >= m_parents.size()) {
+        return m_pendingParentIds.mid((position - int(m_parents.size())) * m_hashLength, m_hashLength);
+    }
+    
+    const quint32 value = m_parents.at(position);
+    if (value & ExternalFlag) {
+        return m_externalIds.mid(int(value & ~ExternalFlag) * m_hashLength, m_hashLength);
+    }
+    return commitId(value);
+}
+
+QStringList CommitStore::parentHashes(Index index) const
+{
+    QStringList hashes;
+    const int count = parentCount(index);
+    for (int n = 0; n < count; ++n) {
+        hashes.append(QString::fromLatin1(parentId(index, n).toHex()));
+    }
+    return hashes;
+}
+
+GitCommit CommitStore::commit(Index index) const
+{
+    GitCommit commit;
+    commit.hash = hash(index);
+    commit.author = author(index);
+    commit.date = QDateTime::fromSecsSinceEpoch(time(index)).toString("yyyy-MM-dd");
+    commit.message = subject(index);
+    commit.parents = parentHashes(index);
+    return commit;
+}
+
+QList<GitCommit> CommitStore::commits(int limit) const
+{
+    const int count = limit < 0 ? m_count : qMin(limit, m_count);
+    QList<GitCommit> result;
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        result.append(commit(Index(i)));
+    }
+    return result;
+}
+
+CommitStore CommitStore::fromCommits(const QList<GitCommit> &commits)
+{
+    CommitStore store;
+    store.reserve(commits.size());
+    
+    for (const GitCommit &commit : commits) {
+        QList<QByteArray> parentIds;
+        for (const QString &parent : commit.parents) {
+            parentIds.append(QByteArray::fromHex(parent.toLatin1()));
+        }
+        
+        const QDate date = QDate::fromString(commit.date, Qt::ISODate);
+        store.append(QByteArray::fromHex(commit.hash.toLatin1()),
+                     date.isValid() ? date.startOfDay().toSecsSinceEpoch() : 0,
+                     commit.author, commit.message, parentIds);
+    }
+    
+    store.finalize();
+    return store;
+}
+
+QStringList CommitStore::logArguments(int limit, const QString &range)
+{
+    QStringList args;
+    args << "log" << "--format=%H%x00%an%x00%at%x00%s%x00%P";
+    if (limit > 0) {
+        args << "-n" << QString::number(limit);
+    }
+    if (!range.isEmpty()) {
+        args << range << "--";
+    }
+    return args;
+}
+
+qint64 CommitStore::memoryUsage() const
+{
+    qint64 bytes = m_ids.capacity() + m_subjects.capacity() + m_externalIds.capacity() + m_pendingParentIds.capacity();
+    bytes += qint64(m_table.capacity()) * sizeof(Index);
+    bytes += qint64(m_times.capacity()) * sizeof(qint64);
+    bytes += qint64(m_authorIndices.capacity()) * sizeof(quint32);
+    bytes += qint64(m_subjectOffsets.capacity()) * sizeof(quint32);
+    bytes += qint64(m_parentOffsets.capacity()) * sizeof(quint32);
+    bytes += qint64(m_parents.capacity()) * sizeof(quint32);
+    for (const QString &author : m_authors) {
+        bytes += author.capacity() * 2 + 64;
+    }
+    return bytes;
+}
+
+quint32 CommitStore::hashId(const uchar *id)
+{
+    quint32 value;
+    memcpy(&value, id, sizeof(value));
+    return value;
+}
+
+void CommitStore::rehash(int capacity)
+{
+    int size = MinimumTableCapacity;
+    while (size < capacity) {
+        size *= 2;
+    }
+    
+    m_table = QVector<Index>(size, InvalidIndex);
+    const quint32 mask = quint32(size - 1);
+    for (int i = 0; i < m_count; ++i) {
+        const uchar *id = reinterpret_cast<const uchar*>(m_ids.constData()) + i * m_hashLength;
+        quint32 slot = hashId(id) & mask;
+        while (m_table[slot] != InvalidIndex) {
+            slot = (slot + 1) & mask;
+        }
+        m_table[slot] = Index(i);
+    }
+}
+
+CommitStore::Index CommitStore::lookup(const uchar *id) const
+{
+    if (m_table.isEmpty()) {
+        return InvalidIndex;
+    }
+    
+    const quint32 mask = quint32(m_table.size() - 1);
+    quint32 slot = hashId(id) & mask;
+    const uchar *ids = reinterpret_cast<const uchar*>(m_ids.constData());
+    while (m_table[slot] != InvalidIndex) {
+        const Index index = m_table[slot];
+        if (memcmp(ids + qint64(index) * m_hashLength, id, m_hashLength) == 0) {
+            return index;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return InvalidIndex;
+}
+
+CommitStore::Index CommitStore::internExternal(const uchar *id)
+{
+    const QByteArray key(reinterpret_cast<const char*>(id), m_hashLength);
+    auto it = m_externalLookup.constFind(key);
+    if (it != m_externalLookup.constEnd()) {
+        return it.value();
+    }
+    
+    const Index index = Index(m_externalIds.size() / m_hashLength);
+    m_externalIds.append(key);
+    m_externalLookup.insert(key, index);
+    return index;
+}
\ No newline at end of file
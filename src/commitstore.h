@@ -0,0 +1,78 @@
+#ifndef COMMITSTORE_H
+#define COMMITSTORE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct GitCommit;
+
+class CommitStore
+{
+public:
+    typedef quint32 Index;
+    static const Index InvalidIndex = 0xffffffff;
+    
+    CommitStore();
+    
+    void clear();
+    void reserve(int commits);
+    
+    bool appendLogRecord(const char *data, int size);
+    Index append(const QByteArray &commitId, qint64 time, const QString &author, const QString &subject,
+                 const QList<QByteArray> &parentIds);
+    void appendStore(const CommitStore &other, int limit = -1);
+    void finalize();
+    
+    int size() const;
+    bool isEmpty() const;
+    int hashLength() const;
+    
+    Index find(const QByteArray &commitId) const;
+    QByteArray commitId(Index index) const;
+    QString hash(Index index) const;
+    qint64 time(Index index) const;
+    QString author(Index index) const;
+    QString subject(Index index) const;
+    int parentCount(Index index) const;
+    Index parent(Index index, int n) const;
+    QByteArray parentId(Index index, int n) const;
+    QStringList parentHashes(Index index) const;
+    
+    GitCommit commit(Index index) const;
+    QList<GitCommit> commits(int limit = -1) const;
+    static CommitStore fromCommits(const QList<GitCommit> &commits);
+    
+    static QStringList logArguments(int limit, const QString &range = QString());
+    qint64 memoryUsage() const;
+
+private:
+    static const quint32 ExternalFlag = 0x80000000;
+    
+    static quint32 hashId(const uchar *id);
+    void rehash(int capacity);
+    Index lookup(const uchar *id) const;
+    Index internExternal(const uchar *id);
+    
+    int m_hashLength;
+    int m_count;
+    QByteArray m_ids;
+    QVector<Index> m_table;
+    QVector<qint64> m_times;
+    QVector<quint32> m_authorIndices;
+    QStringList m_authors;
+    QHash<QString, quint32> m_authorLookup;
+    QByteArray m_subjects;
+    QVector<quint32> m_subjectOffsets;
+    QVector<quint32> m_parentOffsets;
+    QVector<quint32> m_parents;
+    QByteArray m_pendingParentIds;
+    QByteArray m_externalIds;
+    QHash<QByteArray, quint32> m_externalLookup;
+    bool m_finalized;
+};
+
+#endif // COMMITSTORE_H
\ No newline at end of file
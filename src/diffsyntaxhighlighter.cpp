@@ -0,0 +1,125 @@
+#include "diffsyntaxhighlighter.h"
+#include <QTextBlock>
+#include <QTextCharFormat>
+
+DiffSyntaxHighlighter::DiffSyntaxHighlighter(QTextDocument *document)
+    : QSyntaxHighlighter(document)
+    , m_language(SyntaxTokenizer::PlainText)
+    , m_cachedChunk(-1)
+    , m_hasCachedTokens(false)
+{
+}
+
+void DiffSyntaxHighlighter::setSource(SyntaxTokenizer::Language language, const QString &blobKey)
+{
+    m_language = language;
+    m_blobKey = blobKey;
+    invalidateTokens();
+}
+
+SyntaxTokenizer::Language DiffSyntaxHighlighter::language() const
+{
+    return m_language;
+}
+
+QString DiffSyntaxHighlighter::blobKey() const
+{
+    return m_blobKey;
+}
+
+void DiffSyntaxHighlighter::invalidateTokens()
+{
+    m_cachedChunk = -1;
+    m_hasCachedTokens = false;
+    m_cachedTokens = TokenChunk();
+}
+
+bool DiffSyntaxHighlighter::isContentLine(const QString &text)
+{
+    if (text.isEmpty() || text.startsWith("+++ ") || text.startsWith("--- ")) {
+        return false;
+    }
+    const QChar prefix = text.at(0);
+    return prefix == '+' || prefix == '-' || prefix == ' ';
+}
+
+TokenChunk DiffSyntaxHighlighter::tokenizeDiff(SyntaxTokenizer::Language language, const QStringList &lines)
+{
+    TokenChunk chunk;
+    chunk.lines.reserve(lines.size());
+    
+    // Removed and added lines belong to different versions of the file, so
+    // each side keeps its own state and context lines advance both.
+    int oldState = SyntaxTokenizer::Normal;
+    int newState = SyntaxTokenizer::Normal;
+    for (const QString &line : lines) {
+        if (!isContentLine(line)) {
+            oldState = SyntaxTokenizer::Normal;
+            newState = SyntaxTokenizer::Normal;
+            chunk.lines.append(SyntaxLineTokens());
+            continue;
+        }
+        
+        const QChar prefix = line.at(0);
+        const QString content = line.mid(1);
+        SyntaxLineTokens tokens;
+        if (prefix == '-') {
+            tokens = SyntaxTokenizer::tokenizeLine(language, content, oldState);
+        } else {
+            tokens = SyntaxTokenizer::tokenizeLine(language, content, newState);
+            if (prefix == ' ') {
+                SyntaxTokenizer::tokenizeLine(language, content, oldState);
+            }
+        }
+        for (SyntaxToken &token : tokens) {
+            ++token.start;
+        }
+        chunk.lines.append(tokens);
+    }
+    chunk.endState = newState;
+    return chunk;
+}
+
+void DiffSyntaxHighlighter::highlightBlock(const QString &text)
+{
+    QTextCharFormat lineFormat;
+    if (text.startsWith("diff ") || text.startsWith("index ") || text.startsWith("+++ ") || text.startsWith("--- ")) {
+        lineFormat.setFontWeight(QFont::Bold);
+        setFormat(0, text.size(), lineFormat);
+        return;
+    }
+    if (text.startsWith("@@")) {
+        lineFormat.setForeground(QColor(0, 90, 180));
+        setFormat(0, text.size(), lineFormat);
+        return;
+    }
+    if (text.startsWith('+')) {
+        lineFormat.setBackground(QColor(0, 255, 0, 40));
+    } else if (text.startsWith('-')) {
+        lineFormat.setBackground(QColor(255, 0, 0, 40));
+    }
+    if (lineFormat.hasProperty(QTextFormat::BackgroundBrush)) {
+        setFormat(0, text.size(), lineFormat);
+    }
+    
+    if (m_language == SyntaxTokenizer::PlainText || !isContentLine(text)) {
+        return;
+    }
+    
+    const int block = currentBlock().blockNumber();
+    const int chunk = block / TokenCache::ChunkLines;
+    if (chunk != m_cachedChunk) {
+        m_cachedChunk = chunk;
+        m_hasCachedTokens = TokenCache::instance()->lookup(m_blobKey, chunk, m_cachedTokens);
+    }
+    if (!m_hasCachedTokens) {
+        return;
+    }
+    
+    const SyntaxLineTokens tokens = m_cachedTokens.lines.value(block % TokenCache::ChunkLines);
+    for (const SyntaxToken &token : tokens) {
+        QTextCharFormat tokenFormat = lineFormat;
+        tokenFormat.setForeground(SyntaxTokenizer::color(token.kind));
+        setFormat(token.start, token.length, tokenFormat);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#ifndef DIFFSYNTAXHIGHLIGHTER_H
+#define DIFFSYNTAXHIGHLIGHTER_H
+
+#include <QSyntaxHighlighter>
+#include <QTextDocument>
+#include "syntaxtokenizer.h"
+#include "tokencache.h"
+
+class DiffSyntaxHighlighter : public QSyntaxHighlighter
+{
+    Q_OBJECT
+
+public:
+    explicit DiffSyntaxHighlighter(QTextDocument *document);
+    
+    void setSource(SyntaxTokenizer::Language language, const QString &blobKey);
+    SyntaxTokenizer::Language language() const;
+    QString blobKey() const;
+    void invalidateTokens();
+    
+    static bool isContentLine(const QString &text);
+    static TokenChunk tokenizeDiff(SyntaxTokenizer::Language language, const QStringList &lines);
+
+protected:
+    void highlightBlock(const QString &text) override;
+
+private:
+    SyntaxTokenizer::Language m_language;
+    QString m_blobKey;
+    int m_cachedChunk;
+    bool m_hasCachedTokens;
+    TokenChunk m_cachedTokens;
+};
+
+#endif // DIFFSYNTAXHIGHLIGHTER_H
\ No newline at end of file
@@ -1,12 +1,25 @@
 #include "diffviewer.h"
 #include "gitmanager.h"
+#include "gittracer.h"
+#include "diffsyntaxhighlighter.h"
 #include <QFont>
+#include <QLocale>
+#include <QPointer>
+#include <QScrollBar>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QThreadPool>
 
 DiffViewer::DiffViewer(GitManager *gitManager, QWidget *parent)
     : QWidget(parent)
     , m_gitManager(gitManager)
     , m_textEdit(nullptr)
     , m_titleLabel(nullptr)
+    , m_previewLabel(nullptr)
+    , m_loadMoreButton(nullptr)
+    , m_highlighter(nullptr)
+    , m_nextOffset(0)
+    , m_requestSerial(0)
 {
     setupUI();
 }
@@ -20,15 +33,30 @@ void DiffViewer::setupUI()
     m_titleLabel = new QLabel("Diff Viewer");
     m_titleLabel->setStyleSheet("font-weight: bold; font-size: 12px; padding: 5px;");
     
-    m_textEdit = new QTextEdit;
+    m_textEdit = new QPlainTextEdit;
     m_textEdit->setReadOnly(true);
+    m_textEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
     m_textEdit->setPlainText("Select a file to view differences...");
     
     QFont font("Courier New", 9);
     m_textEdit->setFont(font);
     
+    m_highlighter = new DiffSyntaxHighlighter(m_textEdit->document());
+    connect(m_textEdit->verticalScrollBar(), &QScrollBar::valueChanged, this, &DiffViewer::requestVisibleTokens);
+    
+    QHBoxLayout *footerLayout = new QHBoxLayout;
+    m_previewLabel = new QLabel;
+    m_loadMoreButton = new QPushButton("Load More");
+    m_loadMoreButton->setVisible(false);
+    connect(m_loadMoreButton, &QPushButton::clicked, this, &DiffViewer::loadMore);
+    
+    footerLayout->addWidget(m_previewLabel);
+    footerLayout->addStretch();
+    footerLayout->addWidget(m_loadMoreButton);
+    
     layout->addWidget(m_titleLabel);
     layout->addWidget(m_textEdit);
+    layout->addLayout(footerLayout);
 }
 
 void DiffViewer::showFileDiff(const QString &filePath)
@@ -38,18 +66,184 @@ void DiffViewer::showFileDiff(const QString &filePath)
         return;
     }
     
-    QString diff = m_gitManager->getFileDiff(filePath);
+    m_currentFile = filePath;
+    m_nextOffset = 0;
+    m_titleLabel->setText("Diff: " + filePath);
+    m_textEdit->setPlainText("Loading differences for: " + filePath);
+    m_previewLabel->clear();
+    m_loadMoreButton->setVisible(false);
+    m_highlighter->setSource(SyntaxTokenizer::PlainText, QString());
+    m_pendingChunks.clear();
     
-    if (diff.isEmpty()) {
-        m_textEdit->setPlainText("No differences found for: " + filePath);
-    } else {
-        m_titleLabel->setText("Diff: " + filePath);
-        m_textEdit->setPlainText(diff);
-    }
+    GitTraceAction action("Show diff");
+    requestPreview(0);
 }
 
 void DiffViewer::clear()
 {
+    ++m_requestSerial;
+    m_currentFile.clear();
+    m_nextOffset = 0;
+    m_highlighter->setSource(SyntaxTokenizer::PlainText, QString());
+    m_pendingChunks.clear();
     m_titleLabel->setText("Diff Viewer");
     m_textEdit->setPlainText("Select a file to view differences...");
+    m_previewLabel->clear();
+    m_loadMoreButton->setVisible(false);
+}
+
+void DiffViewer::loadMore()
+{
+    if (m_currentFile.isEmpty()) {
+        return;
+    }
+    
+    m_loadMoreButton->setEnabled(false);
+    
+    GitTraceAction action("Load more diff");
+    requestPreview(m_nextOffset);
+}
+
+void DiffViewer::requestPreview(qint64 offset)
+{
+    const quint64 serial = ++m_requestSerial;
+    m_gitManager->requestDiffPreview(m_currentFile, offset, PreviewChunkBytes, this,
+        [this, serial](const GitDiffPreview &preview) {
+            if (serial == m_requestSerial) {
+                showPreview(preview);
+            }
+        });
+}
+
+void DiffViewer::showPreview(const GitDiffPreview &preview)
+{
+    GitTraceSpan span("model", "DiffViewer::showFileDiff");
+    span.setDetail(preview.filePath);
+    span.setItemCount(preview.text.size());
+    
+    m_loadMoreButton->setEnabled(true);
+    m_loadMoreButton->setVisible(preview.success && preview.truncated);
+    m_nextOffset = preview.nextOffset;
+    
+    if (!preview.success) {
+        m_textEdit->setPlainText("Failed to load differences for: " + preview.filePath);
+        m_previewLabel->clear();
+        return;
+    }
+    
+    if (preview.isBinary) {
+        m_textEdit->setPlainText(binarySummary(preview));
+        m_previewLabel->setText("Binary file");
+        return;
+    }
+    
+    if (preview.offset == 0) {
+        m_highlighter->setSource(SyntaxTokenizer::languageForPath(preview.filePath),
+            QString("diff:%1:%2:%3:%4")
+                .arg(preview.filePath)
+                .arg(preview.indexObjectId)
+                .arg(preview.workingTreeSize)
+                .arg(qHash(preview.text), 0, 16));
+        if (preview.text.isEmpty()) {
+            m_textEdit->setPlainText("No differences found for: " + preview.filePath);
+        } else {
+            m_textEdit->setPlainText(preview.text);
+        }
+    } else {
+        QTextCursor cursor(m_textEdit->document());
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(preview.text);
+    }
+    requestVisibleTokens();
+    
+    QLocale locale;
+    if (preview.truncated) {
+        m_previewLabel->setText(QString("Showing the first %1 of the diff")
+            .arg(locale.formattedDataSize(preview.nextOffset)));
+    } else {
+        m_previewLabel->setText(QString("Working tree file: %1")
+            .arg(preview.workingTreeSize >= 0 ? locale.formattedDataSize(preview.workingTreeSize) : QString("deleted")));
+    }
+}
+
+void DiffViewer::requestVisibleTokens()
+{
+    const SyntaxTokenizer::Language language = m_highlighter->language();
+    if (language == SyntaxTokenizer::PlainText) {
+        return;
+    }
+    
+    QTextDocument *document = m_textEdit->document();
+    const int firstBlock = m_textEdit->cursorForPosition(QPoint(0, 0)).blockNumber();
+    const int lastBlock = m_textEdit->cursorForPosition(QPoint(0, m_textEdit->viewport()->height())).blockNumber();
+    const QString blobKey = m_highlighter->blobKey();
+    
+    for (int chunk = firstBlock / TokenCache::ChunkLines; chunk <= lastBlock / TokenCache::ChunkLines; ++chunk) {
+        const int first = chunk * TokenCache::ChunkLines;
+        const int count = qMin(TokenCache::ChunkLines, document->blockCount() - first);
+        TokenChunk cached;
+        if (count <= 0 || m_pendingChunks.contains(chunk)
+            || (TokenCache::instance()->lookup(blobKey, chunk, cached) && cached.lines.size() >= count)) {
+            continue;
+        }
+        
+        QStringList lines;
+        for (QTextBlock block = document->findBlockByNumber(first); block.isValid() && lines.size() < count; block = block.next()) {
+            lines.append(block.text());
+        }
+        
+        m_pendingChunks.insert(chunk);
+        QPointer<DiffViewer> self(this);
+        QThreadPool::globalInstance()->start([self, language, blobKey, chunk, lines]() {
+            TokenCache::instance()->insert(blobKey, chunk, DiffSyntaxHighlighter::tokenizeDiff(language, lines));
+            if (!self) {
+                return;
+            }
+            QMetaObject::invokeMethod(self, [self, blobKey, chunk]() {
+                if (!self || self->m_highlighter->blobKey() != blobKey) {
+                    return;
+                }
+                self->m_pendingChunks.remove(chunk);
+                self->m_highlighter->invalidateTokens();
+                QTextDocument *document = self->m_textEdit->document();
+                QTextBlock block = document->findBlockByNumber(chunk * TokenCache::ChunkLines);
+                for (int i = 0; i < TokenCache::ChunkLines && block.isValid(); ++i, block = block.next()) {
+                    self->m_highlighter->rehighlightBlock(block);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+}
+
+QString DiffViewer::binarySummary(const GitDiffPreview &preview)
+{
+    QLocale locale;
+    QStringList lines;
+    lines << "Binary file: " + preview.filePath;
+    lines << "Working tree: " + (preview.workingTreeSize >= 0
+        ? QString("%1 (%2 bytes)").arg(locale.formattedDataSize(preview.workingTreeSize)).arg(preview.workingTreeSize)
+        : QString("not present"));
+    lines << "Index: " + (preview.indexObjectId.isEmpty()
+        ? QString("not tracked")
+        : QString("%1 (%2 bytes)").arg(preview.indexObjectId).arg(preview.indexSize));
+    lines << "";
+    lines << QString("First %1 bytes:").arg(preview.head.size());
+    
+    for (int offset = 0; offset < preview.head.size(); offset += 16) {
+        const QByteArray row = preview.head.mid(offset, 16);
+        QString hex;
+        QString ascii;
+        for (int i = 0; i < 16; ++i) {
+            if (i < row.size()) {
+                const uchar byte = uchar(row[i]);
+                hex += QString("%1 ").arg(byte, 2, 16, QChar('0'));
+                ascii += (byte >= 0x20 && byte < 0x7f) ? QChar(byte) : QChar('.');
+            } else {
+                hex += "   ";
+            }
+        }
+        lines << QString("%1  %2 |%3|").arg(offset, 8, 16, QChar('0')).arg(hex).arg(ascii);
+    }
+    
+    return lines.join('\n');
 }
\ No newline at end of file
@@ -2,11 +2,16 @@
 #define DIFFVIEWER_H
 
 #include <QWidget>
-#include <QTextEdit>
+#include <QPlainTextEdit>
 #include <QVBoxLayout>
+#include <QHBoxLayout>
 #include <QLabel>
+#include <QPushButton>
+#include <QSet>
 
 class GitManager;
+class DiffSyntaxHighlighter;
+struct GitDiffPreview;
 
 class DiffViewer : public QWidget
 {
@@ -18,12 +23,29 @@ public:
     void showFileDiff(const QString &filePath);
     void clear();
 
+private slots:
+    void loadMore();
+    void requestVisibleTokens();
+
 private:
+    static const qint64 PreviewChunkBytes = 256 * 1024;
+    
     void setupUI();
+    void requestPreview(qint64 offset);
+    void showPreview(const GitDiffPreview &preview);
+    static QString binarySummary(const GitDiffPreview &preview);
     
     GitManager *m_gitManager;
-    QTextEdit *m_textEdit;
+    QPlainTextEdit *m_textEdit;
     QLabel *m_titleLabel;
+    QLabel *m_previewLabel;
+    QPushButton *m_loadMoreButton;
+    DiffSyntaxHighlighter *m_highlighter;
+    
+    QString m_currentFile;
+    qint64 m_nextOffset;
+    quint64 m_requestSerial;
+    QSet<int> m_pendingChunks;
 };
 
 #endif // DIFFVIEWER_H
\ No newline at end of file
@@ -0,0 +1,370 @@
+#include "filetreeindex.h"
+#include <QBrush>
+#include <QColor>
+#include <algorithm>
+
+FileTreeIndex::FileTreeIndex(QStandardItemModel *model, QStandardItem *rootItem)
+    : m_model(model)
+    , m_root(new Node)
+{
+    m_root->item = rootItem ? rootItem : m_model->invisibleRootItem();
+}
+
+FileTreeIndex::~FileTreeIndex()
+{
+    deleteTree(m_root);
+}
+
+void FileTreeIndex::clear()
+{
+    QList<int> rows;
+    rows.reserve(m_root->directories.size() + m_root->files.size());
+    for (Node *child : std::as_const(m_root->directories)) {
+        rows.append(child->item->row());
+    }
+    for (Node *child : std::as_const(m_root->files)) {
+        rows.append(child->item->row());
+    }
+    std::sort(rows.begin(), rows.end());
+    
+    for (int end = int(rows.size()); end > 0;) {
+        int begin = end - 1;
+        while (begin > 0 && rows[begin - 1] == rows[begin] - 1) {
+            --begin;
+        }
+        m_root->item->removeRows(rows[begin], end - begin);
+        end = begin;
+    }
+    
+    for (Node *child : std::as_const(m_root->directories)) {
+        deleteTree(child);
+    }
+    for (Node *child : std::as_const(m_root->files)) {
+        deleteTree(child);
+    }
+    
+    m_root->directories.clear();
+    m_root->files.clear();
+    m_root->counts = Counts();
+    m_filesByPath.clear();
+    m_dirtyDirectories.clear();
+}
+
+void FileTreeIndex::update(const QList<GitFileStatus> &files)
+{
+    QHash<QString, const GitFileStatus*> incoming;
+    incoming.reserve(files.size());
+    for (const GitFileStatus &file : files) {
+        incoming.insert(file.filePath, &file);
+    }
+    
+    QList<Node*> removed;
+    for (auto it = m_filesByPath.constBegin(); it != m_filesByPath.constEnd(); ++it) {
+        if (!incoming.contains(it.key())) {
+            removed.append(it.value());
+        }
+    }
+    for (Node *node : std::as_const(removed)) {
+        removeFile(node);
+    }
+    
+    m_filesByPath.reserve(files.size());
+    for (const GitFileStatus &file : files) {
+        Node *node = m_filesByPath.value(file.filePath);
+        if (node) {
+            updateFile(node, file);
+        } else {
+            insertFile(file);
+        }
+    }
+    
+    refreshDirectoryLabels();
+}
+
+bool FileTreeIndex::contains(const QString &filePath) const
+{
+    return m_filesByPath.contains(filePath);
+}
+
+QString FileTreeIndex::status(const QString &filePath) const
+{
+    Node *node = m_filesByPath.value(filePath);
+    return node ? node->file.status : QString();
+}
+
+int FileTreeIndex::fileCount() const
+{
+    return m_filesByPath.size();
+}
+
+QString FileTreeIndex::changeSummary() const
+{
+    return summary(m_root->counts);
+}
+
+void FileTreeIndex::insertFile(const GitFileStatus &file)
+{
+    QStringList parts = file.filePath.split('/', Qt::SkipEmptyParts);
+    if (parts.isEmpty()) {
+        return;
+    }
+    
+    const QString name = parts.takeLast();
+    Node *directory = m_root;
+    int depth = 0;
+    
+    while (depth < parts.size()) {
+        Node *child = directory->directories.value(parts[depth]);
+        if (!child) {
+            directory = createDirectory(directory, parts.mid(depth));
+            break;
+        }
+        
+        int matched = 1;
+        while (matched < child->components.size() && depth + matched < parts.size()
+               && child->components[matched] == parts[depth + matched]) {
+            ++matched;
+        }
+        if (matched < child->components.size()) {
+            child = splitDirectory(child, matched);
+        }
+        
+        directory = child;
+        depth += matched;
+    }
+    
+    if (Node *existing = directory->files.value(name)) {
+        updateFile(existing, file);
+        return;
+    }
+    
+    Node *node = new Node;
+    node->components = {name};
+    node->parent = directory;
+    node->file = file;
+    node->item = new QStandardItem(name);
+    node->item->setIcon(iconFor(file.filePath));
+    node->item->setData(file.filePath, Qt::UserRole);
+    node->statusItem = new QStandardItem;
+    applyFileStatus(node);
+    
+    directory->item->appendRow({node->item, node->statusItem});
+    directory->files.insert(name, node);
+    m_filesByPath.insert(file.filePath, node);
+    addCounts(directory, countsFor(file), 1);
+}
+
+void FileTreeIndex::removeFile(Node *node)
+{
+    Node *directory = node->parent;
+    addCounts(directory, countsFor(node->file), -1);
+    
+    directory->files.remove(node->components.first());
+    m_filesByPath.remove(node->file.filePath);
+    directory->item->removeRow(node->item->row());
+    delete node;
+    
+    while (directory != m_root && directory->files.isEmpty() && directory->directories.isEmpty()) {
+        Node *parent = directory->parent;
+        parent->directories.remove(directory->components.first());
+        parent->item->removeRow(directory->item->row());
+        m_dirtyDirectories.remove(directory);
+        delete directory;
+        directory = parent;
+    }
+    
+    if (directory != m_root) {
+        mergeDirectory(directory);
+    }
+}
+
+void FileTreeIndex::updateFile(Node *node, const GitFileStatus &file)
+{
+    if (node->file.status == file.status && node->file.isStaged == file.isStaged
+        && node->file.isModified == file.isModified && node->file.isUntracked == file.isUntracked
+        && node->file.isDeleted == file.isDeleted) {
+        return;
+    }
+    
+    addCounts(node->parent, countsFor(node->file), -1);
+    addCounts(node->parent, countsFor(file), 1);
+    node->file = file;
+    applyFileStatus(node);
+}
+
+FileTreeIndex::Node *FileTreeIndex::createDirectory(Node *parent, const QStringList &components)
+{
+    Node *node = new Node;
+    node->components = components;
+    node->parent = parent;
+    node->item = new QStandardItem(components.join('/'));
+    node->item->setIcon(iconFor(components.join('/') + '/'));
+    node->statusItem = new QStandardItem;
+    
+    parent->item->appendRow({node->item, node->statusItem});
+    parent->directories.insert(components.first(), node);
+    return node;
+}
+
+FileTreeIndex::Node *FileTreeIndex::splitDirectory(Node *directory, int keep)
+{
+    Node *parent = directory->parent;
+    
+    Node *head = new Node;
+    head->components = directory->components.mid(0, keep);
+    head->parent = parent;
+    head->counts = directory->counts;
+    head->item = new QStandardItem(head->components.join('/'));
+    head->item->setIcon(iconFor(head->components.join('/') + '/'));
+    head->statusItem = new QStandardItem(summary(head->counts));
+    
+    const int row = directory->item->row();
+    QList<QStandardItem*> taken = parent->item->takeRow(row);
+    parent->item->insertRow(row, {head->item, head->statusItem});
+    head->item->appendRow(taken);
+    
+    directory->components = directory->components.mid(keep);
+    directory->item->setText(directory->components.join('/'));
+    directory->parent = head;
+    
+    parent->directories.insert(head->components.first(), head);
+    head->directories.insert(directory->components.first(), directory);
+    return head;
+}
+
+void FileTreeIndex::mergeDirectory(Node *directory)
+{
+    if (!directory->files.isEmpty() || directory->directories.size() != 1) {
+        return;
+    }
+    
+    Node *child = directory->directories.constBegin().value();
+    Node *parent = directory->parent;
+    
+    const int row = directory->item->row();
+    QList<QStandardItem*> taken = directory->item->takeRow(child->item->row());
+    parent->item->removeRow(row);
+    parent->item->insertRow(row, taken);
+    
+    child->components = directory->components + child->components;
+    child->item->setText(child->components.join('/'));
+    child->parent = parent;
+    parent->directories.insert(child->components.first(), child);
+    
+    m_dirtyDirectories.remove(directory);
+    delete directory;
+}
+
+void FileTreeIndex::addCounts(Node *directory, const Counts &delta, int sign)
+{
+    if (delta.changed == 0 && delta.staged == 0 && delta.untracked == 0) {
+        return;
+    }
+    
+    for (Node *node = directory; node; node = node->parent) {
+        node->counts.changed += sign * delta.changed;
+        node->counts.staged += sign * delta.staged;
+        node->counts.untracked += sign * delta.untracked;
+        if (node != m_root) {
+            m_dirtyDirectories.insert(node);
+        }
+    }
+}
+
+void FileTreeIndex::refreshDirectoryLabels()
+{
+    for (Node *node : std::as_const(m_dirtyDirectories)) {
+        node->statusItem->setText(summary(node->counts));
+    }
+    m_dirtyDirectories.clear();
+}
+
+void FileTreeIndex::applyFileStatus(Node *node)
+{
+    const QString &status = node->file.status;
+    node->statusItem->setText(status);
+    node->statusItem->setData(status, Qt::UserRole);
+    
+    if (status.contains('M')) {
+        node->statusItem->setBackground(QBrush(QColor(255, 255, 0, 100)));
+    } else if (status.contains('A')) {
+        node->statusItem->setBackground(QBrush(QColor(0, 255, 0, 100)));
+    } else if (status.contains('D')) {
+        node->statusItem->setBackground(QBrush(QColor(255, 0, 0, 100)));
+    } else if (status.contains('?')) {
+        node->statusItem->setBackground(QBrush(QColor(128, 128, 128, 100)));
+    } else {
+        node->statusItem->setBackground(QBrush());
+    }
+}
+
+void FileTreeIndex::deleteTree(Node *node)
+{
+    for (Node *child : std::as_const(node->directories)) {
+        deleteTree(child);
+    }
+    for (Node *child : std::as_const(node->files)) {
+        deleteTree(child);
+    }
+    delete node;
+}
+
+FileTreeIndex::Counts FileTreeIndex::countsFor(const GitFileStatus &file)
+{
+    Counts counts;
+    counts.changed = (file.isModified && !file.isUntracked) ? 1 : 0;
+    counts.staged = file.isStaged ? 1 : 0;
+    counts.untracked = file.isUntracked ? 1 : 0;
+    return counts;
+}
+
+QIcon FileTreeIndex::iconFor(const QString &filePath)
+{
+    static QHash<QString, QIcon> icons;
+    
+    QString extension;
+    if (filePath.endsWith('/')) {
+        extension = "/";
+    } else {
+        const int slash = filePath.lastIndexOf('/');
+        const int dot = filePath.lastIndexOf('.');
+        if (dot > slash + 1) {
+            extension = filePath.mid(dot + 1).toLower();
+        }
+    }
+    
+    auto it = icons.constFind(extension);
+    if (it != icons.constEnd()) {
+        return it.value();
+    }
+    
+    QString resource;
+    if (extension == "/") {
+        resource = ":/icons/folder.png";
+    } else if (extension == "cpp" || extension == "cc" || extension == "cxx") {
+        resource = ":/icons/cpp.png";
+    } else if (extension == "h" || extension == "hpp") {
+        resource = ":/icons/header.png";
+    } else if (extension == "txt") {
+        resource = ":/icons/text.png";
+    } else {
+        resource = ":/icons/file.png";
+    }
+    
+    return icons.insert(extension, QIcon(resource)).value();
+}
+
+QString FileTreeIndex::summary(const Counts &counts)
+{
+    QStringList parts;
+    if (counts.changed > 0) {
+        parts.append(QString("%1 changed").arg(counts.changed));
+    }
+    if (counts.staged > 0) {
+        parts.append(QString("%1 staged").arg(counts.staged));
+    }
+    if (counts.untracked > 0) {
+        parts.append(QString("%1 untracked").arg(counts.untracked));
+    }
+    return parts.join(", ");
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef FILETREEINDEX_H
+#define FILETREEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QIcon>
+#include <QStandardItemModel>
+#include "gitmanager.h"
+
+class FileTreeIndex
+{
+public:
+    explicit FileTreeIndex(QStandardItemModel *model, QStandardItem *rootItem = nullptr);
+    ~FileTreeIndex();
+    
+    void clear();
+    void update(const QList<GitFileStatus> &files);
+    
+    bool contains(const QString &filePath) const;
+    QString status(const QString &filePath) const;
+    int fileCount() const;
+    QString changeSummary() const;
+
+private:
+    struct Counts {
+        int changed = 0;
+        int staged = 0;
+        int untracked = 0;
+    };
+    
+    struct Node {
+        QStringList components;
+        Node *parent = nullptr;
+        QHash<QString, Node*> directories;
+        QHash<QString, Node*> files;
+        GitFileStatus file;
+        Counts counts;
+        QStandardItem *item = nullptr;
+        QStandardItem *statusItem = nullptr;
+    };
+    
+    FileTreeIndex(const FileTreeIndex &) = delete;
+    FileTreeIndex &operator=(const FileTreeIndex &) = delete;
+    
+    void insertFile(const GitFileStatus &file);
+    void removeFile(Node *node);
+    void updateFile(Node *node, const GitFileStatus &file);
+    Node *createDirectory(Node *parent, const QStringList &components);
+    Node *splitDirectory(Node *directory, int keep);
+    void mergeDirectory(Node *directory);
+    void addCounts(Node *directory, const Counts &delta, int sign);
+    void refreshDirectoryLabels();
+    void applyFileStatus(Node *node);
+    void deleteTree(Node *node);
+    
+    static Counts countsFor(const GitFileStatus &file);
+    static QIcon iconFor(const QString &filePath);
+    static QString summary(const Counts &counts);
+    
+    QStandardItemModel *m_model;
+    Node *m_root;
+    QHash<QString, Node*> m_filesByPath;
+    QSet<Node*> m_dirtyDirectories;
+};
+
+#endif // FILETREEINDEX_H
\ No newline at end of file
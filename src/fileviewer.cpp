@@ -0,0 +1,135 @@
+#include "fileviewer.h"
+#include "gitmanager.h"
+#include "gittracer.h"
+#include "mappedtextview.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QLocale>
+#include <QPointer>
+
+FileViewer::FileViewer(GitManager *gitManager, QWidget *parent)
+    : QWidget(parent)
+    , m_gitManager(gitManager)
+    , m_view(nullptr)
+    , m_titleLabel(nullptr)
+    , m_statusLabel(nullptr)
+    , m_lineEdit(nullptr)
+    , m_goButton(nullptr)
+    , m_temporaryFile(nullptr)
+{
+    setupUI();
+}
+
+void FileViewer::setupUI()
+{
+    setWindowTitle("File Viewer");
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    QHBoxLayout *headerLayout = new QHBoxLayout;
+    m_titleLabel = new QLabel("File Viewer");
+    m_titleLabel->setStyleSheet("font-weight: bold; font-size: 12px; padding: 5px;");
+    
+    m_lineEdit = new QLineEdit;
+    m_lineEdit->setPlaceholderText("Line");
+    m_lineEdit->setMaximumWidth(120);
+    m_goButton = new QPushButton("Go");
+    m_goButton->setMaximumWidth(60);
+    
+    headerLayout->addWidget(m_titleLabel);
+    headerLayout->addStretch();
+    headerLayout->addWidget(m_lineEdit);
+    headerLayout->addWidget(m_goButton);
+    
+    m_view = new MappedTextView;
+    m_statusLabel = new QLabel;
+    
+    layout->addLayout(headerLayout);
+    layout->addWidget(m_view);
+    layout->addWidget(m_statusLabel);
+    
+    connect(m_goButton, &QPushButton::clicked, this, &FileViewer::goToLine);
+    connect(m_lineEdit, &QLineEdit::returnPressed, this, &FileViewer::goToLine);
+    connect(m_view, &MappedTextView::indexingProgress, this, &FileViewer::onIndexingProgress);
+}
+
+void FileViewer::openFile(const QString &filePath, const QString &revision)
+{
+    m_filePath = filePath;
+    m_revision = revision;
+    m_view->closeFile();
+    
+    const QString title = revision.isEmpty() ? filePath + " (working tree)" : filePath + " @ " + revision;
+    m_titleLabel->setText(title);
+    setWindowTitle(title);
+    
+    if (revision.isEmpty()) {
+        const QFileInfo info(QDir(m_gitManager->getRepositoryPath()).filePath(filePath));
+        showFile(info.absoluteFilePath(), QString("worktree:%1:%2:%3")
+            .arg(info.absoluteFilePath())
+            .arg(info.size())
+            .arg(info.lastModified().toMSecsSinceEpoch()));
+        return;
+    }
+    
+    delete m_temporaryFile;
+    m_temporaryFile = new QTemporaryFile(QDir::temp().filePath("srikok-view-XXXXXX"), this);
+    if (!m_temporaryFile->open()) {
+        m_statusLabel->setText("Cannot create a temporary file: " + m_temporaryFile->errorString());
+        return;
+    }
+    m_temporaryFile->close();
+    
+    m_statusLabel->setText("Loading " + title + "...");
+    
+    GitTraceAction action("View file at revision");
+    QPointer<QTemporaryFile> temporaryFile(m_temporaryFile);
+    m_gitManager->requestFileExport(filePath, revision, m_temporaryFile->fileName(), this,
+        [this, temporaryFile](bool success, const QString &objectId, const QString &error) {
+            if (temporaryFile != m_temporaryFile) {
+                return;
+            }
+            if (success) {
+                showFile(temporaryFile->fileName(), "blob:" + objectId);
+            } else {
+                m_statusLabel->setText("Failed to load file: " + error);
+            }
+        });
+}
+
+void FileViewer::showFile(const QString &path, const QString &blobKey)
+{
+    QString error;
+    if (!m_view->openFile(path, &error)) {
+        m_statusLabel->setText("Failed to open file: " + error);
+        return;
+    }
+    m_view->setSyntax(SyntaxTokenizer::languageForPath(m_filePath), blobKey);
+    m_statusLabel->setText("Indexing lines...");
+}
+
+void FileViewer::goToLine()
+{
+    bool ok = false;
+    const qint64 line = m_lineEdit->text().trimmed().toLongLong(&ok);
+    if (ok && line > 0) {
+        m_view->goToLine(line - 1);
+        m_view->setFocus();
+    }
+}
+
+void FileViewer::onIndexingProgress(qint64 lines, qint64 bytes, bool finished)
+{
+    QLocale locale;
+    if (finished) {
+        m_statusLabel->setText(QString("%1 lines, %2")
+            .arg(locale.toString(lines))
+            .arg(locale.formattedDataSize(m_view->fileSize())));
+    } else {
+        m_statusLabel->setText(QString("Indexing lines... %1 lines (%2 of %3)")
+            .arg(locale.toString(lines))
+            .arg(locale.formattedDataSize(bytes))
+            .arg(locale.formattedDataSize(m_view->fileSize())));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef FILEVIEWER_H
+#define FILEVIEWER_H
+
+#include <QWidget>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTemporaryFile>
+
+class GitManager;
+class MappedTextView;
+
+class FileViewer : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit FileViewer(GitManager *gitManager, QWidget *parent = nullptr);
+    
+    void openFile(const QString &filePath, const QString &revision = QString());
+
+private slots:
+    void goToLine();
+    void onIndexingProgress(qint64 lines, qint64 bytes, bool finished);
+
+private:
+    void setupUI();
+    void showFile(const QString &path, const QString &blobKey);
+    
+    GitManager *m_gitManager;
+    MappedTextView *m_view;
+    QLabel *m_titleLabel;
+    QLabel *m_statusLabel;
+    QLineEdit *m_lineEdit;
+    QPushButton *m_goButton;
+    QTemporaryFile *m_temporaryFile;
+    
+    QString m_filePath;
+    QString m_revision;
+};
+
+#endif // FILEVIEWER_H
\ No newline at end of file
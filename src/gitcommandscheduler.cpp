@@ -0,0 +1,442 @@
+#include "gitcommandscheduler.h"
+#include <QTimer>
+
+namespace {
+
+const int TerminateGracePeriodMs = 5000;
+
+}
+
+GitCommandResult::GitCommandResult()
+    : success(false)
+    , cancelled(false)
+    , exitCode(-1)
+    , elapsedMs(0)
+{
+}
+
+GitCommandScheduler::GitCommandScheduler(QObject *parent)
+    : QObject(parent)
+    , m_running(0)
+    , m_maxConcurrent(6)
+    , m_maxConcurrentPerRepository(3)
+    , m_nextRequestId(1)
+{
+    m_taskPool.setMaxThreadCount(m_maxConcurrent);
+}
+
+GitCommandScheduler::~GitCommandScheduler()
+{
+    for (Command *command : m_taskCommands) {
+        command->cancelled->storeRelaxed(1);
+    }
+    m_taskPool.waitForDone();
+    qDeleteAll(m_taskCommands);
+    m_taskCommands.clear();
+    
+    for (auto it = m_processCommands.begin(); it != m_processCommands.end(); ++it) {
+        it.key()->disconnect(this);
+        it.key()->terminate();
+    }
+    for (auto it = m_processCommands.begin(); it != m_processCommands.end(); ++it) {
+        if (!it.key()->waitForFinished(TerminateGracePeriodMs)) {
+            it.key()->kill();
+            it.key()->waitForFinished(1000);
+        }
+        delete it.value();
+    }
+    m_processCommands.clear();
+    
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        qDeleteAll(m_queues[priority]);
+        m_queues[priority].clear();
+    }
+}
+
+QString GitCommandScheduler::commandKey(const QString &workingDirectory, const QStringList &args)
+{
+    return workingDirectory + QChar(0) + args.join(QChar(0));
+}
+
+quint64 GitCommandScheduler::submit(const QString &workingDirectory, const QStringList &args, Priority priority,
+                                    QObject *context, Callback callback, const QString &supersedeKey)
+{
+    cancelSuperseded(supersedeKey);
+    
+    const QString key = commandKey(workingDirectory, args);
+    Command *command = m_commands.value(key);
+    
+    if (!command) {
+        command = createCommand(key, workingDirectory, args, priority);
+    } else if (!command->started && priority < command->priority) {
+        removeFromQueue(command);
+        command->priority = priority;
+        m_queues[priority].append(command);
+    }
+    
+    return addRequest(command, context, callback, supersedeKey);
+}
+
+quint64 GitCommandScheduler::submitTask(const QString &workingDirectory, const QString &name, Priority priority,
+                                        QObject *context, Task task, Callback callback, const QString &supersedeKey)
+{
+    cancelSuperseded(supersedeKey);
+    
+    // Tasks are never shared, so each one gets its own key.
+    const QString key = commandKey(workingDirectory, {name}) + QChar(0) + QString::number(m_nextRequestId);
+    Command *command = createCommand(key, workingDirectory, {name}, priority);
+    command->task = task;
+    command->cancelled.reset(new QAtomicInt(0));
+    
+    return addRequest(command, context, callback, supersedeKey);
+}
+
+void GitCommandScheduler::cancelSuperseded(const QString &supersedeKey)
+{
+    if (supersedeKey.isEmpty()) {
+        return;
+    }
+    
+    auto previous = m_supersedeRequests.constFind(supersedeKey);
+    if (previous != m_supersedeRequests.constEnd()) {
+        cancel(previous.value());
+    }
+}
+
+GitCommandScheduler::Command *GitCommandScheduler::createCommand(const QString &key, const QString &workingDirectory,
+                                                                 const QStringList &args, Priority priority)
+{
+    Command *command = new Command;
+    command->key = key;
+    command->workingDirectory = workingDirectory;
+    command->args = args;
+    command->priority = priority;
+    command->process = nullptr;
+    command->action = GitTracer::currentAction();
+    command->started = false;
+    command->abandoned = false;
+    m_commands.insert(key, command);
+    m_queues[priority].append(command);
+    return command;
+}
+
+quint64 GitCommandScheduler::addRequest(Command *command, QObject *context, Callback callback, const QString &supersedeKey)
+{
+    Request request;
+    request.id = m_nextRequestId++;
+    request.context = context;
+    request.hasContext = context != nullptr;
+    request.callback = callback;
+    request.supersedeKey = supersedeKey;
+    
+    command->requests.append(request);
+    m_requestCommands.insert(request.id, command->key);
+    if (!supersedeKey.isEmpty()) {
+        m_supersedeRequests.insert(supersedeKey, request.id);
+    }
+    
+    schedule();
+    return request.id;
+}
+
+GitCommandScheduler::Command *GitCommandScheduler::commandForRequest(quint64 requestId) const
+{
+    auto it = m_requestCommands.constFind(requestId);
+    if (it == m_requestCommands.constEnd()) {
+        return nullptr;
+    }
+    return m_commands.value(it.value());
+}
+
+void GitCommandScheduler::cancel(quint64 requestId)
+{
+    Command *command = commandForRequest(requestId);
+    m_requestCommands.remove(requestId);
+    if (!command) {
+        return;
+    }
+    
+    for (int i = 0; i < command->requests.size(); ++i) {
+        const Request &request = command->requests.at(i);
+        if (request.id == requestId) {
+            if (!request.supersedeKey.isEmpty() && m_supersedeRequests.value(request.supersedeKey) == requestId) {
+                m_supersedeRequests.remove(request.supersedeKey);
+            }
+            command->requests.removeAt(i);
+            break;
+        }
+    }
+    
+    if (!command->requests.isEmpty()) {
+        return;
+    }
+    
+    m_commands.remove(command->key);
+    
+    if (!command->started) {
+        removeFromQueue(command);
+        delete command;
+        return;
+    }
+    
+    command->abandoned = true;
+    if (command->task) {
+        command->cancelled->storeRelaxed(1);
+        return;
+    }
+    
+    QProcess *process = command->process;
+    process->terminate();
+    QTimer::singleShot(TerminateGracePeriodMs, process, [process]() {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+        }
+    });
+}
+
+void GitCommandScheduler::cancelAll(const QString &workingDirectory)
+{
+    QList<quint64> requestIds;
+    for (Command *command : m_commands) {
+        if (command->workingDirectory == workingDirectory) {
+            for (const Request &request : command->requests) {
+                requestIds.append(request.id);
+            }
+        }
+    }
+    
+    for (quint64 requestId : requestIds) {
+        cancel(requestId);
+    }
+}
+
+void GitCommandScheduler::setMaxConcurrent(int maxConcurrent)
+{
+    m_maxConcurrent = qMax(1, maxConcurrent);
+    m_taskPool.setMaxThreadCount(m_maxConcurrent);
+    schedule();
+}
+
+void GitCommandScheduler::setMaxConcurrentPerRepository(int maxConcurrent)
+{
+    m_maxConcurrentPerRepository = qMax(1, maxConcurrent);
+    schedule();
+}
+
+int GitCommandScheduler::maxConcurrent() const
+{
+    return m_maxConcurrent;
+}
+
+int GitCommandScheduler::maxConcurrentPerRepository() const
+{
+    return m_maxConcurrentPerRepository;
+}
+
+int GitCommandScheduler::runningCount() const
+{
+    return m_running;
+}
+
+int GitCommandScheduler::queuedCount() const
+{
+    int count = 0;
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        count += m_queues[priority].size();
+    }
+    return count;
+}
+
+void GitCommandScheduler::removeFromQueue(Command *command)
+{
+    m_queues[command->priority].removeOne(command);
+}
+
+bool GitCommandScheduler::canStart(const Command *command) const
+{
+    // Interactive work always keeps one slot in reserve so a click never
+    // waits behind a full set of background commands.
+    const int reserve = command->priority == Interactive ? 0 : 1;
+    const int limit = qMax(1, m_maxConcurrent - reserve);
+    const int repositoryLimit = qMax(1, m_maxConcurrentPerRepository - reserve);
+    
+    return m_running < limit
+        && m_runningPerRepository.value(command->workingDirectory) < repositoryLimit;
+}
+
+void GitCommandScheduler::schedule()
+{
+    for (int priority = 0; priority < PriorityCount; ++priority) {
+        QList<Command*> &queue = m_queues[priority];
+        for (int i = 0; i < queue.size();) {
+            if (m_running >= m_maxConcurrent) {
+                return;
+            }
+            
+            Command *command = queue.at(i);
+            if (canStart(command)) {
+                queue.removeAt(i);
+                start(command);
+            } else {
+                ++i;
+            }
+        }
+    }
+}
+
+void GitCommandScheduler::start(Command *command)
+{
+    command->started = true;
+    if (command->task) {
+        startTask(command);
+        return;
+    }
+    
+    command->process = new QProcess(this);
+    command->process->setWorkingDirectory(command->workingDirectory);
+    m_processCommands.insert(command->process, command);
+    
+    ++m_running;
+    ++m_runningPerRepository[command->workingDirectory];
+    
+    connect(command->process, &QProcess::started, this, &GitCommandScheduler::onProcessStarted);
+    connect(command->process, &QProcess::finished, this, &GitCommandScheduler::onProcessFinished);
+    connect(command->process, &QProcess::errorOccurred, this, &GitCommandScheduler::onProcessError);
+    
+    emit commandStarted(command->workingDirectory, command->args);
+    
+    command->trace.begin(command->workingDirectory, command->args, command->action);
+    command->timer.start();
+    command->process->start("git", command->args);
+}
+
+void GitCommandScheduler::startTask(Command *command)
+{
+    m_taskCommands.insert(command);
+    
+    ++m_running;
+    ++m_runningPerRepository[command->workingDirectory];
+    
+    emit commandStarted(command->workingDirectory, command->args);
+    
+    const Task task = command->task;
+    const QSharedPointer<QAtomicInt> cancelled = command->cancelled;
+    const QString action = command->action;
+    command->timer.start();
+    m_taskPool.start([this, command, task, cancelled, action]() {
+        {
+            GitTraceAction traceAction(action);
+            task(*cancelled);
+        }
+        QMetaObject::invokeMethod(this, [this, command]() {
+            onTaskFinished(command);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void GitCommandScheduler::onTaskFinished(Command *command)
+{
+    if (!m_taskCommands.remove(command)) {
+        return;
+    }
+    
+    GitCommandResult result;
+    result.cancelled = command->abandoned;
+    result.success = !command->abandoned;
+    result.exitCode = result.success ? 0 : -1;
+    result.elapsedMs = command->timer.elapsed();
+    
+    complete(command, result);
+}
+
+void GitCommandScheduler::onProcessStarted()
+{
+    Command *command = m_processCommands.value(qobject_cast<QProcess*>(sender()));
+    if (command) {
+        command->trace.markStarted();
+    }
+}
+
+void GitCommandScheduler::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    QProcess *process = qobject_cast<QProcess*>(sender());
+    Command *command = m_processCommands.value(process);
+    if (!command) {
+        return;
+    }
+    
+    GitCommandResult result;
+    result.exitCode = exitCode;
+    result.cancelled = command->abandoned;
+    result.success = !command->abandoned && exitStatus == QProcess::NormalExit && exitCode == 0;
+    result.output = process->readAllStandardOutput();
+    result.error = QString::fromUtf8(process->readAllStandardError());
+    result.elapsedMs = command->timer.elapsed();
+    
+    command->trace.addOutput(result.output.size());
+    command->trace.finish(exitCode, result.success, result.cancelled ? QString("Cancelled") : result.error);
+    
+    complete(command, result);
+}
+
+void GitCommandScheduler::onProcessError(QProcess::ProcessError error)
+{
+    if (error != QProcess::FailedToStart) {
+        return;
+    }
+    
+    QProcess *process = qobject_cast<QProcess*>(sender());
+    Command *command = m_processCommands.value(process);
+    if (!command) {
+        return;
+    }
+    
+    GitCommandResult result;
+    result.cancelled = command->abandoned;
+    result.error = "Failed to start git: " + process->errorString();
+    result.elapsedMs = command->timer.elapsed();
+    
+    command->trace.finish(-1, false, result.error);
+    
+    complete(command, result);
+}
+
+void GitCommandScheduler::complete(Command *command, const GitCommandResult &result)
+{
+    if (command->process) {
+        m_processCommands.remove(command->process);
+        command->process->deleteLater();
+    }
+    
+    --m_running;
+    if (--m_runningPerRepository[command->workingDirectory] <= 0) {
+        m_runningPerRepository.remove(command->workingDirectory);
+    }
+    
+    if (!command->abandoned) {
+        m_commands.remove(command->key);
+    }
+    
+    const QList<Request> requests = command->requests;
+    for (const Request &request : requests) {
+        m_requestCommands.remove(request.id);
+        if (!request.supersedeKey.isEmpty() && m_supersedeRequests.value(request.supersedeKey) == request.id) {
+            m_supersedeRequests.remove(request.supersedeKey);
+        }
+    }
+    
+    emit commandFinished(command->workingDirectory, command->args, result);
+    
+    const bool abandoned = command->abandoned;
+    delete command;
+    
+    if (!abandoned) {
+        for (const Request &request : requests) {
+            if (request.callback && (!request.hasContext || request.context)) {
+                request.callback(result);
+            }
+        }
+    }
+    
+    schedule();
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#ifndef GITCOMMANDSCHEDULER_H
+#define GITCOMMANDSCHEDULER_H
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QProcess>
+#include <QSet>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QThreadPool>
+#include <functional>
+#include "gittracer.h"
+
+struct GitCommandResult {
+    bool success;
+    bool cancelled;
+    int exitCode;
+    QByteArray output;
+    QString error;
+    qint64 elapsedMs;
+    
+    GitCommandResult();
+};
+
+class GitCommandScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        Interactive,
+        Normal,
+        Background,
+        PriorityCount
+    };
+    
+    typedef std::function<void(const GitCommandResult &)> Callback;
+    typedef std::function<void(const QAtomicInt &cancelled)> Task;
+    
+    explicit GitCommandScheduler(QObject *parent = nullptr);
+    ~GitCommandScheduler();
+    
+    quint64 submit(const QString &workingDirectory, const QStringList &args, Priority priority,
+                   QObject *context, Callback callback, const QString &supersedeKey = QString());
+    quint64 submitTask(const QString &workingDirectory, const QString &name, Priority priority,
+                       QObject *context, Task task, Callback callback, const QString &supersedeKey = QString());
+    void cancel(quint64 requestId);
+    void cancelAll(const QString &workingDirectory);
+    
+    void setMaxConcurrent(int maxConcurrent);
+    void setMaxConcurrentPerRepository(int maxConcurrent);
+    int maxConcurrent() const;
+    int maxConcurrentPerRepository() const;
+    int runningCount() const;
+    int queuedCount() const;
+
+signals:
+    void commandStarted(const QString &workingDirectory, const QStringList &args);
+    void commandFinished(const QString &workingDirectory, const QStringList &args, const GitCommandResult &result);
+
+private slots:
+    void onProcessStarted();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessError(QProcess::ProcessError error);
+
+private:
+    struct Request {
+        quint64 id;
+        QPointer<QObject> context;
+        bool hasContext;
+        Callback callback;
+        QString supersedeKey;
+    };
+    
+    struct Command {
+        QString key;
+        QString workingDirectory;
+        QStringList args;
+        Priority priority;
+        QList<Request> requests;
+        Task task;
+        QSharedPointer<QAtomicInt> cancelled;
+        QProcess *process;
+        QElapsedTimer timer;
+        QString action;
+        GitProcessTrace trace;
+        bool started;
+        bool abandoned;
+    };
+    
+    static QString commandKey(const QString &workingDirectory, const QStringList &args);
+    Command *commandForRequest(quint64 requestId) const;
+    Command *createCommand(const QString &key, const QString &workingDirectory, const QStringList &args, Priority priority);
+    quint64 addRequest(Command *command, QObject *context, Callback callback, const QString &supersedeKey);
+    void cancelSuperseded(const QString &supersedeKey);
+    void schedule();
+    bool canStart(const Command *command) const;
+    void start(Command *command);
+    void startTask(Command *command);
+    void onTaskFinished(Command *command);
+    void complete(Command *command, const GitCommandResult &result);
+    void removeFromQueue(Command *command);
+    
+    QList<Command*> m_queues[PriorityCount];
+    QHash<QString, Command*> m_commands;
+    QHash<quint64, QString> m_requestCommands;
+    QHash<QString, quint64> m_supersedeRequests;
+    QHash<QString, int> m_runningPerRepository;
+    QHash<QProcess*, Command*> m_processCommands;
+    QSet<Command*> m_taskCommands;
+    QThreadPool m_taskPool;
+    int m_running;
+    int m_maxConcurrent;
+    int m_maxConcurrentPerRepository;
+    quint64 m_nextRequestId;
+};
+
+#endif // GITCOMMANDSCHEDULER_H
\ No newline at end of file
@@ -0,0 +1,197 @@
+#include "gitfsmonitor.h"
+#include "gitmanager.h"
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+
+#ifdef Q_OS_LINUX
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+
+const char *HelperName = "srikok-fsmonitor";
+const char *SocketName = "srikok-fsmonitor.sock";
+
+}
+
+bool GitFsMonitor::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return QFileInfo(helperPath()).isExecutable();
+#else
+    return false;
+#endif
+}
+
+QString GitFsMonitor::helperPath()
+{
+    return QDir(QCoreApplication::applicationDirPath()).filePath(HelperName);
+}
+
+QString GitFsMonitor::hookCommand()
+{
+    return "\"" + helperPath() + "\" hook";
+}
+
+QString GitFsMonitor::resolveGitDirectory(const QString &workTree)
+{
+    const QString dotGit = QDir(workTree).filePath(".git");
+    const QFileInfo info(dotGit);
+    if (info.isDir()) {
+        return info.absoluteFilePath();
+    }
+    
+    QFile file(dotGit);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QString();
+    }
+    
+    const QString line = QString::fromUtf8(file.readLine()).trimmed();
+    if (!line.startsWith("gitdir:")) {
+        return QString();
+    }
+    
+    const QString gitDirectory = line.mid(7).trimmed();
+    return QDir::cleanPath(QDir(workTree).absoluteFilePath(gitDirectory));
+}
+
+QString GitFsMonitor::socketPath(const QString &gitDirectory)
+{
+    const QString path = QDir(gitDirectory).filePath(SocketName);
+#ifdef Q_OS_LINUX
+    if (path.toLocal8Bit().size() < int(sizeof(sockaddr_un::sun_path))) {
+        return path;
+    }
+#endif
+    const QByteArray digest = QCryptographicHash::hash(gitDirectory.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+    return QDir::temp().filePath(QString("%1-%2.sock").arg(HelperName, QString::fromLatin1(digest)));
+}
+
+bool GitFsMonitor::isEnabled(const QString &workingDirectory)
+{
+    QString output;
+    if (!GitManager::runGitCommand(workingDirectory, {"config", "--get", "core.fsmonitor"}, output)) {
+        return false;
+    }
+    return output.contains(HelperName);
+}
+
+bool GitFsMonitor::enable(const QString &workingDirectory, QString *error)
+{
+    if (!isSupported()) {
+        if (error) {
+            *error = "The file system monitor is not available on this platform";
+        }
+        return false;
+    }
+    
+    QString output;
+    if (!GitManager::runGitCommand(workingDirectory, {"config", "core.fsmonitor", hookCommand()}, output, error)
+        || !GitManager::runGitCommand(workingDirectory, {"config", "core.fsmonitorHookVersion", QString::number(HookVersion)}, output, error)) {
+        return false;
+    }
+    
+    startDaemon(workingDirectory);
+    return true;
+}
+
+bool GitFsMonitor::disable(const QString &workingDirectory, QString *error)
+{
+    QString output;
+    if (isEnabled(workingDirectory)
+        && !GitManager::runGitCommand(workingDirectory, {"config", "--unset", "core.fsmonitor"}, output, error)) {
+        return false;
+    }
+    GitManager::runGitCommand(workingDirectory, {"config", "--unset", "core.fsmonitorHookVersion"}, output);
+    
+    QByteArray response;
+    request(socketPath(resolveGitDirectory(workingDirectory)), "stop\n", response);
+    return true;
+}
+
+bool GitFsMonitor::startDaemon(const QString &workingDirectory, const QString &helper)
+{
+    const QString program = helper.isEmpty() ? helperPath() : helper;
+    return QProcess::startDetached(program, {"daemon", QDir(workingDirectory).absolutePath()});
+}
+
+bool GitFsMonitor::isDaemonRunning(const QString &workingDirectory)
+{
+    QByteArray response;
+    return request(socketPath(resolveGitDirectory(workingDirectory)), "ping\n", response) && response.startsWith("ok");
+}
+
+bool GitFsMonitor::request(const QString &socketPath, const QByteArray &request, QByteArray &response, int timeoutMs)
+{
+    response.clear();
+#ifdef Q_OS_LINUX
+    const QByteArray path = socketPath.toLocal8Bit();
+    if (path.isEmpty() || path.size() >= int(sizeof(sockaddr_un::sun_path))) {
+        return false;
+    }
+    
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return false;
+    }
+    
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.constData(), size_t(path.size()));
+    
+    bool ok = ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+    
+    qint64 written = 0;
+    while (ok && written < request.size()) {
+        const ssize_t n = ::write(fd, request.constData() + written, size_t(request.size() - written));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = n > 0;
+        written += qMax<ssize_t>(n, 0);
+    }
+    if (ok) {
+        shutdown(fd, SHUT_WR);
+    }
+    
+    char buffer[65536];
+    while (ok) {
+        pollfd descriptor = {fd, POLLIN, 0};
+        const int ready = poll(&descriptor, 1, timeoutMs);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            ok = false;
+            break;
+        }
+        const ssize_t n = ::read(fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            ok = n == 0;
+            break;
+        }
+        response.append(buffer, int(n));
+    }
+    
+    ::close(fd);
+    return ok;
+#else
+    Q_UNUSED(socketPath);
+    Q_UNUSED(request);
+    Q_UNUSED(timeoutMs);
+    return false;
+#endif
+}
\ No newline at end of file
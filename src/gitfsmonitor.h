@@ -0,0 +1,28 @@
+#ifndef GITFSMONITOR_H
+#define GITFSMONITOR_H
+
+#include <QByteArray>
+#include <QString>
+
+class GitFsMonitor
+{
+public:
+    static const int HookVersion = 2;
+    
+    static bool isSupported();
+    static QString helperPath();
+    static QString hookCommand();
+    
+    static QString resolveGitDirectory(const QString &workTree);
+    static QString socketPath(const QString &gitDirectory);
+    
+    static bool isEnabled(const QString &workingDirectory);
+    static bool enable(const QString &workingDirectory, QString *error = nullptr);
+    static bool disable(const QString &workingDirectory, QString *error = nullptr);
+    
+    static bool startDaemon(const QString &workingDirectory, const QString &helper = QString());
+    static bool isDaemonRunning(const QString &workingDirectory);
+    static bool request(const QString &socketPath, const QByteArray &request, QByteArray &response, int timeoutMs = 1000);
+};
+
+#endif // GITFSMONITOR_H
\ No newline at end of file
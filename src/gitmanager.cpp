@@ -1,12 +1,309 @@
 #include "gitmanager.h"
+#include "commitgraph.h"
+#include "gittracer.h"
+#include "commitstore.h"
+#include "gitfsmonitor.h"
+#include "repositorystats.h"
+#include "objectsizeanalyzer.h"
+#include "tagquery.h"
 #include <QDebug>
+#include <QFile>
+#include <QDirIterator>
 #include <QRegularExpression>
+#include <QTemporaryFile>
 #include <QDateTime>
+#include <QPointer>
+#include <algorithm>
+
+namespace {
+
+const int BinarySniffBytes = 8000;
+const int BinaryHeadBytes = 256;
+const int StatsBatchCommits = 2000;
+const int SpoolPollMs = 100;
+
+// Prepending new commits matches a full git log only for a plain chain.
+// git log interleaves commits brought in by a merge with the old history
+// by date, so merges and out-of-order dates fall back to a full load.
+bool isLinearUpdate(const CommitStore &fresh, const CommitStore &base)
+{
+    for (int i = 0; i < fresh.size(); ++i) {
+        if (fresh.parentCount(i) > 1 || (i > 0 && fresh.time(i) > fresh.time(i - 1))) {
+            return false;
+        }
+    }
+    return fresh.isEmpty() || fresh.time(fresh.size() - 1) >= base.time(0);
+}
+
+struct DiffPreviewResult {
+    GitDiffPreview preview;
+    QSharedPointer<GitDiffSpool> spool;
+};
+
+struct ExportResult {
+    bool success = false;
+    QString objectId;
+    QString error;
+};
+
+struct StatsRun {
+    QList<QByteArray> commitIds;
+    QList<QByteArray> missing;
+    RepositoryStatsCache cache;
+    QVector<RepositoryStatsCache> partials;
+    QStringList errors;
+    RepositoryStatsSummary summary;
+    QElapsedTimer timer;
+    int remaining = 0;
+};
+
+bool streamNumstat(const QString &workingDirectory, const QList<QByteArray> &commitIds, RepositoryStatsCache &cache, QString *error)
+{
+    const QStringList args = RepositoryStatsCache::logArguments();
+    
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, args);
+    
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("GIT_NO_LAZY_FETCH", "1");
+    
+    QProcess process;
+    process.setWorkingDirectory(workingDirectory);
+    process.setProcessEnvironment(environment);
+    process.start("git", args);
+    if (!process.waitForStarted()) {
+        *error = "Failed to start git: " + process.errorString();
+        trace.finish(-1, false, *error);
+        return false;
+    }
+    trace.markStarted();
+    
+    QByteArray input;
+    input.reserve(commitIds.size() * 41);
+    for (const QByteArray &commitId : commitIds) {
+        input += commitId;
+        input += '\n';
+    }
+    process.write(input);
+    process.closeWriteChannel();
+    
+    QByteArray pending;
+    qint64 outputBytes = 0;
+    auto consumeLines = [&pending, &cache]() {
+        int start = 0;
+        int newline;
+        while ((newline = pending.indexOf('\n', start)) >= 0) {
+            cache.appendLogLine(pending.constData() + start, newline - start);
+            start = newline + 1;
+        }
+        pending.remove(0, start);
+    };
+    
+    for (;;) {
+        const bool readable = process.waitForReadyRead(-1);
+        const QByteArray chunk = process.readAllStandardOutput();
+        outputBytes += chunk.size();
+        pending += chunk;
+        consumeLines();
+        if (!readable && process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    
+    process.waitForFinished(-1);
+    pending += process.readAllStandardOutput();
+    consumeLines();
+    cache.appendLogLine(pending.constData(), pending.size());
+    cache.finishLog();
+    trace.addOutput(outputBytes);
+    
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        *error = QString::fromUtf8(process.readAllStandardError()).trimmed();
+        if (error->isEmpty()) {
+            *error = QString("git log exited with code %1").arg(process.exitCode());
+        }
+        trace.finish(process.exitCode(), false, *error);
+        return false;
+    }
+    
+    trace.finish(0, true);
+    return true;
+}
+
+// Numstat needs every blob on both sides of each commit, so a partial
+// clone would either fetch its whole history or fail part way through.
+bool prepareStatsRun(const QString &workingDirectory, StatsRun &run)
+{
+    if (GitManager::isPartialClone(workingDirectory)) {
+        run.summary.error = "line statistics are not collected for partial clones";
+        return false;
+    }
+    
+    QString revisions;
+    if (!GitManager::runGitCommand(workingDirectory, {"rev-list", "HEAD"}, revisions, &run.summary.error)) {
+        return false;
+    }
+    
+    for (const QString &line : revisions.split('\n', Qt::SkipEmptyParts)) {
+        run.commitIds.append(line.trimmed().toLatin1());
+    }
+    
+    run.cache.load(RepositoryStatsCache::filePath(workingDirectory));
+    for (const QByteArray &commitId : run.commitIds) {
+        if (!run.cache.contains(commitId)) {
+            run.missing.append(commitId);
+        }
+    }
+    
+    const int batchCount = (int(run.missing.size()) + StatsBatchCommits - 1) / StatsBatchCommits;
+    run.partials.resize(batchCount);
+    for (int i = 0; i < batchCount; ++i) {
+        run.errors.append(QString());
+    }
+    return true;
+}
+
+void finishStatsRun(const QString &workingDirectory, StatsRun &run)
+{
+    if (!run.partials.isEmpty()) {
+        for (const RepositoryStatsCache &partial : run.partials) {
+            run.cache.merge(partial);
+        }
+        run.cache.save(RepositoryStatsCache::filePath(workingDirectory));
+    }
+    
+    run.summary = run.cache.summarize(run.commitIds);
+    run.summary.processedCommits = int(run.missing.size());
+    run.summary.batchCount = int(run.partials.size());
+    run.summary.elapsedMs = run.timer.elapsed();
+}
+
+GitFileStatus fileStatus(const QString &status, const QString &filePath)
+{
+    GitFileStatus file;
+    file.status = status;
+    file.filePath = filePath;
+    file.isStaged = (file.status[0] != ' ' && file.status[0] != '?');
+    file.isModified = (file.status[1] != ' ');
+    file.isUntracked = (file.status == "??");
+    file.isDeleted = (file.status.contains('D'));
+    return file;
+}
+
+}
+
+GitDiffPreview::GitDiffPreview()
+    : workingTreeSize(-1)
+    , indexSize(-1)
+    , offset(0)
+    , nextOffset(0)
+    , isBinary(false)
+    , truncated(false)
+    , success(false)
+{
+}
+
+GitDiffSpool::~GitDiffSpool()
+{
+    if (!path.isEmpty()) {
+        QFile::remove(path);
+    }
+}
+
+GitRepositorySummary::GitRepositorySummary()
+    : ahead(0)
+    , behind(0)
+    , changedFiles(0)
+{
+}
+
+bool GitRepositorySummary::operator==(const GitRepositorySummary &other) const
+{
+    return branch == other.branch
+        && upstream == other.upstream
+        && ahead == other.ahead
+        && behind == other.behind
+        && changedFiles == other.changedFiles;
+}
+
+bool GitRepositorySummary::operator!=(const GitRepositorySummary &other) const
+{
+    return !(*this == other);
+}
+
+GitSubmodule::GitSubmodule()
+    : initialized(false)
+{
+}
+
+GitSubmoduleStatus::GitSubmoduleStatus()
+    : elapsedMs(0)
+    , success(false)
+{
+}
+
+GitCloneOptions::GitCloneOptions()
+    : depth(0)
+    , singleBranch(false)
+{
+}
+
+QStringList GitCloneOptions::cloneArguments() const
+{
+    QStringList args;
+    args << "clone";
+    
+    if (!branch.isEmpty()) {
+        args << "--branch" << branch;
+    }
+    if (depth > 0) {
+        args << "--depth" << QString::number(depth);
+    }
+    if (!filter.isEmpty()) {
+        args << ("--filter=" + filter);
+    }
+    if (singleBranch) {
+        args << "--single-branch";
+    } else if (depth > 0) {
+        args << "--no-single-branch";
+    }
+    if (!sparseDirectories.isEmpty()) {
+        args << "--sparse";
+    }
+    
+    args << "--" << url << path;
+    return args;
+}
+
+QStringList GitCloneOptions::sparseCheckoutArguments() const
+{
+    QStringList args;
+    if (!sparseDirectories.isEmpty()) {
+        args << "sparse-checkout" << "set" << "--cone" << "--" << sparseDirectories;
+    }
+    return args;
+}
 
 GitManager::GitManager(QObject *parent)
     : QObject(parent)
+    , m_commitGraph(nullptr)
+    , m_scheduler(nullptr)
+    , m_refWatcher(nullptr)
+    , m_stateCacheBytes(0)
+    , m_tagNamesGeneration(0)
     , m_isRepositoryOpen(false)
+    , m_fsMonitorEnabled(false)
+    , m_statusBaselineMs(-1)
+{
+    m_scheduler = new GitCommandScheduler(this);
+    m_refWatcher = new GitRefWatcher(this);
+    connect(m_refWatcher, &GitRefWatcher::changed, this, &GitManager::onRefsChanged);
+    m_immutableCache.setMaxCost(ImmutableCacheBudget);
+}
+
+GitManager::~GitManager()
 {
+    delete m_commitGraph;
 }
 
 bool GitManager::openRepository(const QString &path)
@@ -20,23 +317,58 @@ bool GitManager::openRepository(const QString &path)
     m_repositoryPath = path;
     m_isRepositoryOpen = true;
     
+    delete m_commitGraph;
+    m_commitGraph = nullptr;
+    invalidateStateCache();
+    m_immutableCache.clear();
+    m_diffSpool.reset();
+    invalidateTagNames();
+    m_refWatcher->setRepository(getGitDirectory());
+    
+    m_fsMonitorEnabled = false;
+    m_statusBaselineMs = -1;
+    m_scheduler->submit(m_repositoryPath, {"config", "--get", "core.fsmonitor"}, GitCommandScheduler::Background, this,
+        [this, path](const GitCommandResult &result) {
+            if (path != m_repositoryPath) {
+                return;
+            }
+            m_fsMonitorEnabled = result.success && result.output.contains("srikok-fsmonitor");
+            emit fsMonitorStateChanged(m_fsMonitorEnabled);
+            if (m_fsMonitorEnabled) {
+                measureStatusBaseline();
+            }
+        });
+    
     emit repositoryChanged();
     return true;
 }
 
 bool GitManager::cloneRepository(const QString &url, const QString &path)
 {
-    QStringList args;
-    args << "clone" << url << path;
+    GitCloneOptions options;
+    options.url = url;
+    options.path = path;
     
-    if (executeGitCommand("git", args)) {
-        m_repositoryPath = path;
-        m_isRepositoryOpen = true;
-        emit repositoryChanged();
-        return true;
+    return cloneRepository(options);
+}
+
+bool GitManager::cloneRepository(const GitCloneOptions &options)
+{
+    QString output;
+    if (!executeGitCommand("git", options.cloneArguments(), output, -1)) {
+        return false;
     }
     
-    return false;
+    const QStringList sparseArgs = options.sparseCheckoutArguments();
+    if (!sparseArgs.isEmpty()) {
+        QString error;
+        if (!runGitCommand(options.path, sparseArgs, output, &error)) {
+            m_lastError = error;
+            return false;
+        }
+    }
+    
+    return openRepository(options.path);
 }
 
 bool GitManager::isRepositoryOpen() const
@@ -49,15 +381,120 @@ QString GitManager::getRepositoryPath() const
     return m_repositoryPath;
 }
 
+QString GitManager::getGitDirectory() const
+{
+    if (!m_isRepositoryOpen) return QString();
+    
+    const QString dotGit = QDir(m_repositoryPath).filePath(".git");
+    QFileInfo info(dotGit);
+    if (info.isDir()) {
+        return dotGit;
+    }
+    
+    QFile file(dotGit);
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.startsWith("gitdir:")) {
+            return QDir(m_repositoryPath).absoluteFilePath(line.mid(7).trimmed());
+        }
+    }
+    
+    return dotGit;
+}
+
+QString GitManager::getObjectsDirectory() const
+{
+    const QString gitDir = getGitDirectory();
+    if (gitDir.isEmpty()) return QString();
+    
+    QFile commonDir(gitDir + "/commondir");
+    if (commonDir.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QString common = QString::fromUtf8(commonDir.readLine()).trimmed();
+        return QDir(QDir(gitDir).absoluteFilePath(common)).filePath("objects");
+    }
+    
+    return gitDir + "/objects";
+}
+
+QString GitManager::readRef(const QString &refName) const
+{
+    const QString gitDir = getGitDirectory();
+    
+    QFile looseRef(gitDir + "/" + refName);
+    if (looseRef.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QString value = QString::fromUtf8(looseRef.readAll()).trimmed();
+        if (value.startsWith("ref: ")) {
+            return readRef(value.mid(5));
+        }
+        return value;
+    }
+    
+    QString commonDir = gitDir;
+    QFile commonDirFile(gitDir + "/commondir");
+    if (commonDirFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        commonDir = QDir(gitDir).absoluteFilePath(QString::fromUtf8(commonDirFile.readLine()).trimmed());
+        QFile sharedRef(commonDir + "/" + refName);
+        if (sharedRef.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return QString::fromUtf8(sharedRef.readAll()).trimmed();
+        }
+    }
+    
+    QFile packedRefs(commonDir + "/packed-refs");
+    if (packedRefs.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        const QByteArray wanted = " " + refName.toUtf8();
+        while (!packedRefs.atEnd()) {
+            const QByteArray line = packedRefs.readLine().trimmed();
+            if (line.startsWith('#') || line.startsWith('^')) {
+                continue;
+            }
+            if (line.endsWith(wanted)) {
+                return QString::fromLatin1(line.left(line.indexOf(' ')));
+            }
+        }
+    }
+    
+    return QString();
+}
+
+QString GitManager::resolveHeadCommit() const
+{
+    if (!m_isRepositoryOpen) return QString();
+    
+    return readRef("HEAD");
+}
+
+const CommitGraph *GitManager::commitGraph() const
+{
+    if (!m_isRepositoryOpen) return nullptr;
+    
+    const QString objectsDir = getObjectsDirectory();
+    if (!m_commitGraph) {
+        m_commitGraph = new CommitGraph;
+        m_commitGraph->load(objectsDir);
+    } else if (m_commitGraph->isStale(objectsDir)) {
+        m_commitGraph->load(objectsDir);
+    }
+    
+    return m_commitGraph->isValid() ? m_commitGraph : nullptr;
+}
+
 QString GitManager::getCurrentBranch() const
 {
     if (!m_isRepositoryOpen) return QString();
     
+    QFile head(getGitDirectory() + "/HEAD");
+    if (head.open(QIODevice::ReadOnly)) {
+        const QByteArray content = head.readAll().trimmed();
+        if (content.startsWith("ref: refs/heads/")) {
+            return QString::fromUtf8(content.mid(16));
+        }
+    }
+    
     QString output;
     QStringList args;
     args << "rev-parse" << "--abbrev-ref" << "HEAD";
     
-    if (executeGitCommand("git", args, output)) {
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
         return output.trimmed();
     }
     
@@ -72,7 +509,7 @@ QStringList GitManager::getBranches() const
     QStringList args;
     args << "branch";
     
-    if (executeGitCommand("git", args, output)) {
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
         QStringList branches;
         QStringList lines = output.split('\n');
         
@@ -100,7 +537,7 @@ QStringList GitManager::getRemoteBranches() const
     QStringList args;
     args << "branch" << "-r";
     
-    if (executeGitCommand("git", args, output)) {
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
         QStringList branches;
         QStringList lines = output.split('\n');
         
@@ -125,13 +562,58 @@ QStringList GitManager::getRemotes() const
     QStringList args;
     args << "remote";
     
-    if (executeGitCommand("git", args, output)) {
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
         return output.split('\n', Qt::SkipEmptyParts);
     }
     
     return QStringList();
 }
 
+QList<GitBranchRef> GitManager::getBranchRefs(QString *error) const
+{
+    QList<GitBranchRef> refs;
+    
+    if (!m_isRepositoryOpen) return refs;
+    
+    QString output;
+    QStringList args;
+    args << "for-each-ref"
+         << "--format=%(HEAD)%00%(refname)%00%(refname:short)%00%(upstream:short)%00%(objectname)%00%(committerdate:unix)%00%(contents:subject)"
+         << "refs/heads" << "refs/remotes";
+    
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
+        const QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+        refs.reserve(lines.size());
+        
+        for (const QString &line : lines) {
+            const QStringList parts = line.split(QChar(0));
+            if (parts.size() < 7) {
+                continue;
+            }
+            
+            GitBranchRef ref;
+            ref.isCurrent = (parts[0] == "*");
+            ref.refName = parts[1];
+            ref.name = parts[2];
+            ref.upstream = parts[3];
+            ref.commitHash = parts[4];
+            ref.commitTime = parts[5].toLongLong();
+            ref.subject = parts[6];
+            ref.isRemote = ref.refName.startsWith("refs/remotes/");
+            
+            if (ref.isRemote && ref.refName.endsWith("/HEAD")) {
+                continue;
+            }
+            
+            refs.append(ref);
+        }
+    } else if (error) {
+        *error = m_lastError;
+    }
+    
+    return refs;
+}
+
 QList<GitFileStatus> GitManager::getFileStatus() const
 {
     QList<GitFileStatus> files;
@@ -140,95 +622,867 @@ QList<GitFileStatus> GitManager::getFileStatus() const
     
     QString output;
     QStringList args;
-    args << "status" << "--porcelain";
+    args << "status" << "--porcelain" << "--ignore-submodules=dirty";
     
+    const QByteArray indexBefore = m_refWatcher->indexStamp();
+    const QDateTime startedAt = QDateTime::currentDateTime();
+    QElapsedTimer timer;
+    timer.start();
     if (executeGitCommand("git", args, output)) {
-        QStringList lines = output.split('\n');
+        recordStatusTiming(timer.elapsed());
+        m_refWatcher->absorbIndexChange(indexBefore, startedAt);
+        files = parseFileStatus(output);
+    }
+    
+    return files;
+}
+
+QList<GitFileStatus> GitManager::parseFileStatus(const QString &output)
+{
+    QList<GitFileStatus> files;
+    QStringList lines = output.split('\n');
+    
+    for (const QString &line : lines) {
+        if (line.length() >= 3) {
+            files.append(fileStatus(line.left(2), line.mid(3)));
+        }
+    }
+    
+    return files;
+}
+
+QStringList GitManager::submoduleListArguments()
+{
+    return {"config", "--file", ".gitmodules", "--get-regexp", "^submodule\\..*\\.(path|url)$"};
+}
+
+QList<GitSubmodule> GitManager::parseSubmoduleList(const QString &repositoryPath, const QString &output)
+{
+    QList<GitSubmodule> submodules;
+    QHash<QString, int> indexByName;
+    
+    for (const QString &line : output.split('\n', Qt::SkipEmptyParts)) {
+        const int space = line.indexOf(' ');
+        const int dot = line.lastIndexOf('.', space);
+        if (space < 0 || dot <= 10) {
+            continue;
+        }
         
-        for (const QString &line : lines) {
-            if (line.length() >= 3) {
-                GitFileStatus file;
-                file.status = line.left(2);
-                file.filePath = line.mid(3);
-                file.isStaged = (file.status[0] != ' ' && file.status[0] != '?');
-                file.isModified = (file.status[1] != ' ');
-                file.isUntracked = (file.status == "??");
-                file.isDeleted = (file.status.contains('D'));
-                
-                files.append(file);
+        const QString name = line.mid(10, dot - 10);
+        const QString key = line.mid(dot + 1, space - dot - 1);
+        auto it = indexByName.constFind(name);
+        if (it == indexByName.constEnd()) {
+            it = indexByName.insert(name, submodules.size());
+            GitSubmodule submodule;
+            submodule.name = name;
+            submodules.append(submodule);
+        }
+        
+        GitSubmodule &submodule = submodules[it.value()];
+        if (key == "path") {
+            submodule.path = line.mid(space + 1).trimmed();
+        } else if (key == "url") {
+            submodule.url = line.mid(space + 1).trimmed();
+        }
+    }
+    
+    QList<GitSubmodule> result;
+    for (GitSubmodule &submodule : submodules) {
+        if (submodule.path.isEmpty()) {
+            continue;
+        }
+        submodule.initialized = QFileInfo::exists(QDir(repositoryPath).filePath(submodule.path + "/.git"));
+        result.append(submodule);
+    }
+    
+    std::sort(result.begin(), result.end(), [](const GitSubmodule &a, const GitSubmodule &b) {
+        return a.path < b.path;
+    });
+    return result;
+}
+
+QStringList GitManager::submoduleStatusArguments()
+{
+    return repositorySummaryArguments() << "--ignore-submodules=dirty";
+}
+
+void GitManager::parseSubmoduleStatus(const QString &output, GitSubmoduleStatus &status)
+{
+    status.summary = parseRepositorySummary(output);
+    status.files = parseStatusEntries(output);
+    
+    const int oid = output.indexOf("# branch.oid ");
+    if (oid >= 0) {
+        const int start = oid + 13;
+        const QString head = output.mid(start, output.indexOf('\n', start) - start);
+        status.headCommit = head == "(initial)" ? QString() : head;
+    }
+}
+
+QList<GitFileStatus> GitManager::parseStatusEntries(const QString &output)
+{
+    QList<GitFileStatus> files;
+    
+    for (const QString &line : output.split('\n', Qt::SkipEmptyParts)) {
+        int fields = 0;
+        switch (line.at(0).toLatin1()) {
+        case '1':
+            fields = 8;
+            break;
+        case '2':
+            fields = 9;
+            break;
+        case 'u':
+            fields = 10;
+            break;
+        case '?':
+            fields = 1;
+            break;
+        default:
+            continue;
+        }
+        
+        int position = -1;
+        for (int i = 0; i < fields; ++i) {
+            position = line.indexOf(' ', position + 1);
+            if (position < 0) {
+                break;
             }
         }
+        if (position < 0) {
+            continue;
+        }
+        
+        const QString path = line.mid(position + 1).section('\t', 0, 0);
+        const QString code = line.at(0) == '?' ? QString("??") : line.mid(2, 2).replace('.', ' ');
+        files.append(fileStatus(code, path));
     }
     
     return files;
 }
 
-QList<GitCommit> GitManager::getCommitHistory(int limit) const
+QList<GitCommit> GitManager::getCommitHistory(int limit, QString *error) const
 {
     QList<GitCommit> commits;
     
     if (!m_isRepositoryOpen) return commits;
     
+    if (limit > 0) {
+        commits = getCommitHistoryFromGraph(limit);
+        if (!commits.isEmpty()) {
+            return commits;
+        }
+    }
+    
     QString output;
+    if (executeCachedGitCommand(commitHistoryArguments(limit), output, CacheUntilStateChanges)) {
+        commits = parseCommitLog(output);
+    } else if (error) {
+        *error = m_lastError;
+    }
+    
+    return commits;
+}
+
+QStringList GitManager::commitHistoryArguments(int limit)
+{
     QStringList args;
-    args << "log" << "--oneline" << "--pretty=format:%H|%an|%ad|%s|%P" << "--date=short";
+    args << "log" << "--pretty=format:%H%x00%an%x00%ad%x00%s%x00%P" << "--date=short";
     if (limit > 0) {
         args << "-n" << QString::number(limit);
     }
+    return args;
+}
+
+QList<GitCommit> GitManager::parseCommitLog(const QString &output)
+{
+    QList<GitCommit> commits;
+    const QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+    commits.reserve(lines.size());
+    
+    for (const QString &line : lines) {
+        const QStringList parts = line.split(QChar(0));
+        if (parts.size() >= 4) {
+            GitCommit commit;
+            commit.hash = parts[0];
+            commit.author = parts[1];
+            commit.date = parts[2];
+            commit.message = parts[3];
+            if (parts.size() > 4) {
+                commit.parents = parts[4].split(' ', Qt::SkipEmptyParts);
+            }
+            
+            commits.append(commit);
+        }
+    }
+    
+    return commits;
+}
+
+QList<GitCommit> GitManager::getCommitHistoryFromGraph(int limit) const
+{
+    QList<GitCommit> commits;
+    
+    const CommitGraph *graph = commitGraph();
+    if (!graph) return commits;
+    
+    const QByteArray headId = QByteArray::fromHex(resolveHeadCommit().toLatin1());
+    const quint32 head = graph->findCommit(headId);
+    if (head == CommitGraph::InvalidPosition) {
+        return commits;
+    }
+    
+    const QVector<quint32> order = graph->walk({head}, limit);
+    QStringList hashes;
+    hashes.reserve(order.size());
+    for (quint32 position : order) {
+        hashes.append(QString::fromLatin1(graph->commitId(position).toHex()));
+    }
+    
+    commits = getCommitsByHash(hashes);
+    if (commits.size() != order.size()) {
+        return QList<GitCommit>();
+    }
+    
+    for (int i = 0; i < commits.size(); ++i) {
+        const QVector<quint32> parents = graph->parents(order[i]);
+        commits[i].parents.clear();
+        for (quint32 parent : parents) {
+            commits[i].parents.append(QString::fromLatin1(graph->commitId(parent).toHex()));
+        }
+    }
+    
+    return commits;
+}
+
+QList<GitCommit> GitManager::getCommitsByHash(const QStringList &hashes) const
+{
+    QList<GitCommit> commits;
+    
+    if (!m_isRepositoryOpen || hashes.isEmpty()) return commits;
+    
+    QByteArray input;
+    input.reserve(hashes.size() * 41);
+    for (const QString &hash : hashes) {
+        input += hash.toLatin1();
+        input += '\n';
+    }
+    
+    QString output;
+    QStringList args;
+    args << "log" << "--no-walk=unsorted" << "--stdin" << "--pretty=format:%H%x00%an%x00%ad%x00%s%x00%P" << "--date=short";
+    
+    if (executeGitCommand("git", args, output, 30000, input)) {
+        commits = parseCommitLog(output);
+    }
+    
+    return commits;
+}
+
+QString GitManager::getFileContent(const QString &filePath, const QString &revision) const
+{
+    if (!m_isRepositoryOpen) return QString();
+    
+    QString output;
+    QStringList args;
+    args << "show" << (revision + ":" + filePath);
+    
+    static const QRegularExpression fullCommitId("^([0-9a-f]{40}|[0-9a-f]{64})$");
+    const CachePolicy policy = fullCommitId.match(revision).hasMatch() ? CacheForever : CacheUntilStateChanges;
+    
+    if (executeCachedGitCommand(args, output, policy)) {
+        return output;
+    }
+    
+    return QString();
+}
+
+QString GitManager::getFileDiff(const QString &filePath, QString *error) const
+{
+    if (!m_isRepositoryOpen) return QString();
+    
+    QString output;
+    QStringList args;
+    args << "diff" << filePath;
     
     if (executeGitCommand("git", args, output)) {
-        QStringList lines = output.split('\n');
+        return output;
+    }
+    
+    if (error) {
+        *error = m_lastError;
+    }
+    return QString();
+}
+
+QList<GitCommit> GitManager::searchCommits(const QString &text, int limit, QString *error) const
+{
+    if (!m_isRepositoryOpen || text.isEmpty()) return QList<GitCommit>();
+    
+    QStringList args = commitHistoryArguments(limit);
+    args << "--regexp-ignore-case" << "--fixed-strings" << ("--grep=" + text);
+    
+    QString output;
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
+        return parseCommitLog(output);
+    }
+    
+    if (error) {
+        *error = m_lastError;
+    }
+    return QList<GitCommit>();
+}
+
+QList<GitSearchMatch> GitManager::searchFiles(const QString &text, int limit, QString *error) const
+{
+    QList<GitSearchMatch> matches;
+    
+    if (!m_isRepositoryOpen || text.isEmpty()) return matches;
+    
+    QString output;
+    QStringList args;
+    args << "grep" << "-z" << "-n" << "-I" << "--ignore-case" << "--fixed-strings" << "-e" << text;
+    
+    if (!executeGitCommand("git", args, output)) {
+        // git grep exits 1 without a message when nothing matches.
+        if (error && !m_lastError.trimmed().isEmpty()) {
+            *error = m_lastError;
+        }
+        return matches;
+    }
+    
+    const QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        if (limit > 0 && matches.size() >= limit) {
+            break;
+        }
         
-        for (const QString &line : lines) {
-            if (!line.isEmpty()) {
-                QStringList parts = line.split('|');
-                if (parts.size() >= 4) {
-                    GitCommit commit;
-                    commit.hash = parts[0];
-                    commit.author = parts[1];
-                    commit.date = parts[2];
-                    commit.message = parts[3];
-                    if (parts.size() > 4) {
-                        commit.parents = parts[4].split(' ', Qt::SkipEmptyParts);
-                    }
-                    
-                    commits.append(commit);
+        const QStringList parts = line.split(QChar(0));
+        if (parts.size() >= 3) {
+            GitSearchMatch match;
+            match.filePath = parts[0];
+            match.lineNumber = parts[1].toInt();
+            match.text = parts.mid(2).join(QChar(0));
+            matches.append(match);
+        }
+    }
+    
+    return matches;
+}
+
+GitCommandScheduler *GitManager::scheduler() const
+{
+    return m_scheduler;
+}
+
+quint64 GitManager::requestFileStatus(QObject *context, std::function<void(const QList<GitFileStatus> &)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    QStringList args;
+    args << "status" << "--porcelain" << "--ignore-submodules=dirty";
+    
+    const QString repositoryPath = m_repositoryPath;
+    const QByteArray indexBefore = m_refWatcher->indexStamp();
+    const QDateTime startedAt = QDateTime::currentDateTime();
+    return m_scheduler->submit(m_repositoryPath, args, GitCommandScheduler::Normal, context,
+        [this, repositoryPath, indexBefore, startedAt, callback](const GitCommandResult &result) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            if (result.success) {
+                recordStatusTiming(result.elapsedMs);
+                m_refWatcher->absorbIndexChange(indexBefore, startedAt);
+            }
+            callback(result.success ? parseFileStatus(QString::fromUtf8(result.output)) : QList<GitFileStatus>());
+        });
+}
+
+quint64 GitManager::requestCommitStore(int limit, QObject *context, std::function<void(QSharedPointer<const CommitStore>)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    QSharedPointer<CommitStore> store(new CommitStore);
+    return m_scheduler->submitTask(m_repositoryPath, "commit-store", GitCommandScheduler::Normal, context,
+        [repositoryPath, limit, store](const QAtomicInt &) {
+            if (!loadCommitStore(repositoryPath, limit, *store)) {
+                store->clear();
+            }
+        },
+        [this, repositoryPath, store, callback](const GitCommandResult &) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            callback(store);
+        });
+}
+
+quint64 GitManager::requestCommitStoreUpdate(QSharedPointer<const CommitStore> base, const QString &oldHead, const QString &newHead, int limit,
+                                             QObject *context, std::function<void(QSharedPointer<const CommitStore>)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    QSharedPointer<CommitStore> store(new CommitStore);
+    return m_scheduler->submitTask(m_repositoryPath, "commit-store-update", GitCommandScheduler::Normal, context,
+        [repositoryPath, base, oldHead, newHead, limit, store](const QAtomicInt &) {
+            bool incremental = false;
+            QString output;
+            if (base && !base->isEmpty() && !oldHead.isEmpty() && !newHead.isEmpty()
+                && base->hash(0) == oldHead
+                && runGitCommand(repositoryPath, {"merge-base", "--is-ancestor", oldHead, newHead}, output)) {
+                CommitStore fresh;
+                if (loadCommitStore(repositoryPath, limit, fresh, nullptr, oldHead + ".." + newHead)
+                    && isLinearUpdate(fresh, *base)) {
+                    store->reserve(limit > 0 ? qMin(limit, fresh.size() + base->size()) : fresh.size() + base->size());
+                    store->appendStore(fresh, limit);
+                    store->appendStore(*base, limit);
+                    store->finalize();
+                    incremental = true;
+                }
+            }
+            
+            if (!incremental) {
+                store->clear();
+                if (!loadCommitStore(repositoryPath, limit, *store)) {
+                    store->clear();
                 }
             }
+        },
+        [this, repositoryPath, store, callback](const GitCommandResult &) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            callback(store);
+        });
+}
+
+quint64 GitManager::requestObjectSizeReport(QObject *context, std::function<void(const ObjectSizeReport &)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    QSharedPointer<ObjectSizeReport> report(new ObjectSizeReport);
+    
+    return m_scheduler->submitTask(m_repositoryPath, "object-size", GitCommandScheduler::Background, context,
+        [repositoryPath, report](const QAtomicInt &cancelled) {
+            ObjectSizeAnalyzer analyzer;
+            analyzer.analyze(repositoryPath, *report, &cancelled);
+        },
+        [this, repositoryPath, report, callback](const GitCommandResult &) {
+            if (repositoryPath == m_repositoryPath) {
+                callback(*report);
+            }
+        }, "object-size");
+}
+
+quint64 GitManager::requestIntroducingCommit(const QString &objectId, QObject *context, std::function<void(const QString &)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    return m_scheduler->submit(m_repositoryPath, ObjectSizeAnalyzer::introducingCommitArguments(objectId), GitCommandScheduler::Normal, context,
+        [this, repositoryPath, callback](const GitCommandResult &result) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            const QStringList lines = QString::fromUtf8(result.output).split('\n', Qt::SkipEmptyParts);
+            if (!result.success || lines.isEmpty()) {
+                callback(QString());
+                return;
+            }
+            const QStringList fields = lines.last().split(QChar(0x1f));
+            if (fields.size() < 4) {
+                callback(QString());
+                return;
+            }
+            callback(QString("%1 %2 %3: %4").arg(fields.at(0).left(10), fields.at(2), fields.at(1), fields.at(3)));
+        });
+}
+
+void GitManager::requestTagPage(const QString &prefix, int sortOrder, int offset, int limit, QObject *context, std::function<void(const GitTagPage &)> callback) const
+{
+    if (!m_isRepositoryOpen) return;
+    
+    const QString key = prefix + QChar(0) + QString::number(sortOrder);
+    QPointer<QObject> receiver(context);
+    
+    if (m_tagNames && m_tagNamesKey == key) {
+        GitTagPage page;
+        page.prefix = prefix;
+        page.sortOrder = sortOrder;
+        TagQuery::slicePage(*m_tagNames, offset, limit, page);
+        if (receiver) {
+            QMetaObject::invokeMethod(receiver, [page, callback]() {
+                callback(page);
+            }, Qt::QueuedConnection);
         }
+        return;
+    }
+    
+    const QString repositoryPath = m_repositoryPath;
+    const quint64 generation = m_tagNamesGeneration;
+    const QStringList args = TagQuery::listArguments(prefix, TagQuery::SortOrder(sortOrder));
+    m_scheduler->submit(m_repositoryPath, args, GitCommandScheduler::Normal, context,
+        [this, repositoryPath, generation, key, prefix, sortOrder, offset, limit, callback](const GitCommandResult &result) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            
+            GitTagPage page;
+            page.prefix = prefix;
+            page.sortOrder = sortOrder;
+            page.offset = offset;
+            if (!result.success) {
+                page.error = result.error;
+                callback(page);
+                return;
+            }
+            
+            QSharedPointer<const QStringList> names = QSharedPointer<const QStringList>::create(
+                TagQuery::parseList(QString::fromUtf8(result.output)));
+            if (m_tagNamesGeneration == generation) {
+                m_tagNames = names;
+                m_tagNamesKey = key;
+            }
+            TagQuery::slicePage(*names, offset, limit, page);
+            callback(page);
+        });
+}
+
+quint64 GitManager::requestSubmodules(QObject *context, std::function<void(const QList<GitSubmodule> &)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    if (!QFileInfo::exists(QDir(repositoryPath).filePath(".gitmodules"))) {
+        callback(QList<GitSubmodule>());
+        return 0;
+    }
+    
+    return m_scheduler->submit(m_repositoryPath, submoduleListArguments(), GitCommandScheduler::Normal, context,
+        [this, repositoryPath, callback](const GitCommandResult &result) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            callback(parseSubmoduleList(repositoryPath, QString::fromUtf8(result.output)));
+        }, "submodules");
+}
+
+quint64 GitManager::requestSubmoduleStatus(const QString &path, QObject *context, std::function<void(const GitSubmoduleStatus &)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    const QString workingDirectory = QDir(repositoryPath).filePath(path);
+    return m_scheduler->submit(workingDirectory, submoduleStatusArguments(), GitCommandScheduler::Background, context,
+        [this, repositoryPath, path, callback](const GitCommandResult &result) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            GitSubmoduleStatus status;
+            status.path = path;
+            status.elapsedMs = result.elapsedMs;
+            status.success = result.success;
+            status.error = result.error;
+            if (result.success) {
+                parseSubmoduleStatus(QString::fromUtf8(result.output), status);
+            }
+            callback(status);
+        }, "submodule-status:" + workingDirectory);
+}
+
+quint64 GitManager::requestTagDetails(const QStringList &names, QObject *context, std::function<void(bool, const QList<GitTagRef> &)> callback) const
+{
+    if (!m_isRepositoryOpen || names.isEmpty()) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    return m_scheduler->submit(m_repositoryPath, TagQuery::detailsArguments(names), GitCommandScheduler::Normal, context,
+        [this, repositoryPath, callback](const GitCommandResult &result) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            if (!result.success) {
+                callback(false, QList<GitTagRef>());
+                return;
+            }
+            callback(true, TagQuery::parseDetails(QString::fromUtf8(result.output)));
+        });
+}
+
+quint64 GitManager::requestAheadBehind(const QString &branch, const QString &upstream, QObject *context, std::function<void(bool, int, int)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    QStringList args;
+    args << "rev-list" << "--left-right" << "--count" << (branch + "..." + upstream);
+    
+    const QString repositoryPath = m_repositoryPath;
+    return m_scheduler->submit(m_repositoryPath, args, GitCommandScheduler::Normal, context,
+        [this, repositoryPath, callback](const GitCommandResult &result) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            const QStringList counts = QString::fromUtf8(result.output).split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+            if (!result.success || counts.size() != 2) {
+                callback(false, 0, 0);
+                return;
+            }
+            callback(true, counts[0].toInt(), counts[1].toInt());
+        });
+}
+
+void GitManager::requestRepositoryStats(QObject *context, std::function<void(const RepositoryStatsSummary &)> callback) const
+{
+    if (!m_isRepositoryOpen) return;
+    
+    for (quint64 requestId : m_statsRequests) {
+        m_scheduler->cancel(requestId);
+    }
+    m_statsRequests.clear();
+    
+    const QString repositoryPath = m_repositoryPath;
+    QSharedPointer<StatsRun> run(new StatsRun);
+    run->timer.start();
+    
+    auto finish = [this, repositoryPath, run, context, callback]() {
+        m_statsRequests.append(m_scheduler->submitTask(repositoryPath, "stats-summary", GitCommandScheduler::Background, context,
+            [repositoryPath, run](const QAtomicInt &) {
+                finishStatsRun(repositoryPath, *run);
+            },
+            [this, repositoryPath, run, callback](const GitCommandResult &) {
+                if (repositoryPath == m_repositoryPath) {
+                    callback(run->summary);
+                }
+            }));
+    };
+    
+    m_statsRequests.append(m_scheduler->submitTask(repositoryPath, "stats-revisions", GitCommandScheduler::Background, context,
+        [repositoryPath, run](const QAtomicInt &) {
+            if (!prepareStatsRun(repositoryPath, *run) && run->summary.error.isEmpty()) {
+                run->summary.error = "git rev-list failed";
+            }
+        },
+        [this, repositoryPath, run, context, callback, finish](const GitCommandResult &) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            if (!run->summary.error.isEmpty()) {
+                run->summary.error = run->summary.error.trimmed();
+                callback(run->summary);
+                return;
+            }
+            if (run->partials.isEmpty()) {
+                finish();
+                return;
+            }
+            
+            run->remaining = int(run->partials.size());
+            for (int batch = 0; batch < run->partials.size(); ++batch) {
+                const QList<QByteArray> commitIds = run->missing.mid(batch * StatsBatchCommits, StatsBatchCommits);
+                RepositoryStatsCache *partial = &run->partials[batch];
+                QString *error = &run->errors[batch];
+                m_statsRequests.append(m_scheduler->submitTask(repositoryPath, "stats-numstat", GitCommandScheduler::Background, context,
+                    [repositoryPath, run, commitIds, partial, error](const QAtomicInt &) {
+                        streamNumstat(repositoryPath, commitIds, *partial, error);
+                    },
+                    [this, repositoryPath, run, callback, finish](const GitCommandResult &) {
+                        if (repositoryPath != m_repositoryPath || --run->remaining > 0) {
+                            return;
+                        }
+                        for (const QString &error : run->errors) {
+                            if (!error.isEmpty()) {
+                                run->summary.error = error;
+                                callback(run->summary);
+                                return;
+                            }
+                        }
+                        finish();
+                    }));
+            }
+        }));
+}
+
+bool GitManager::loadCommitStore(const QString &workingDirectory, int limit, CommitStore &store, QString *error,
+                                 const QString &range)
+{
+    const QStringList args = CommitStore::logArguments(limit, range);
+    
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, args);
+    
+    QProcess process;
+    process.setWorkingDirectory(workingDirectory);
+    process.start("git", args);
+    if (!process.waitForStarted()) {
+        const QString message = "Failed to start git: " + process.errorString();
+        if (error) {
+            *error = message;
+        }
+        trace.finish(-1, false, message);
+        return false;
+    }
+    trace.markStarted();
+    
+    if (limit > 0) {
+        store.reserve(qMin(limit, 65536));
+    }
+    
+    QByteArray pending;
+    qint64 outputBytes = 0;
+    auto consumeLines = [&pending, &store]() {
+        int start = 0;
+        int newline;
+        while ((newline = pending.indexOf('\n', start)) >= 0) {
+            store.appendLogRecord(pending.constData() + start, newline - start);
+            start = newline + 1;
+        }
+        pending.remove(0, start);
+    };
+    
+    for (;;) {
+        const bool readable = process.waitForReadyRead(-1);
+        const QByteArray chunk = process.readAllStandardOutput();
+        outputBytes += chunk.size();
+        pending += chunk;
+        consumeLines();
+        if (!readable && process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    
+    process.waitForFinished(-1);
+    const QByteArray rest = process.readAllStandardOutput();
+    outputBytes += rest.size();
+    pending += rest;
+    consumeLines();
+    if (!pending.isEmpty()) {
+        store.appendLogRecord(pending.constData(), pending.size());
+    }
+    store.finalize();
+    trace.addOutput(outputBytes);
+    
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        const QString message = QString::fromUtf8(process.readAllStandardError());
+        if (error) {
+            *error = message;
+        }
+        trace.finish(process.exitCode(), false, message);
+        return false;
+    }
+    
+    trace.finish(0, true);
+    return true;
+}
+
+void GitManager::requestFileExport(const QString &filePath, const QString &revision, const QString &targetPath, QObject *context, std::function<void(bool, const QString &, const QString &)> callback) const
+{
+    if (!m_isRepositoryOpen) return;
+    
+    const QString repositoryPath = m_repositoryPath;
+    const QString object = revision + ":" + filePath;
+    QSharedPointer<ExportResult> exported(new ExportResult);
+    m_scheduler->submitTask(m_repositoryPath, "export:" + object, GitCommandScheduler::Interactive, context,
+        [repositoryPath, object, targetPath, exported](const QAtomicInt &) {
+            exported->success = exportBlob(repositoryPath, object, targetPath, &exported->objectId, &exported->error);
+        },
+        [exported, callback](const GitCommandResult &) {
+            callback(exported->success, exported->objectId, exported->error);
+        });
+}
+
+quint64 GitManager::requestDiffPreview(const QString &filePath, qint64 offset, qint64 maxBytes, QObject *context, std::function<void(const GitDiffPreview &)> callback) const
+{
+    if (!m_isRepositoryOpen) return 0;
+    
+    const QString repositoryPath = m_repositoryPath;
+    QSharedPointer<DiffPreviewResult> loaded(new DiffPreviewResult);
+    if (offset > 0) {
+        loaded->spool = m_diffSpool;
+    }
+    
+    return m_scheduler->submitTask(m_repositoryPath, "diff:" + filePath, GitCommandScheduler::Interactive, context,
+        [repositoryPath, filePath, offset, maxBytes, loaded](const QAtomicInt &cancelled) {
+            loaded->preview.filePath = filePath;
+            loaded->preview.offset = offset;
+            loadDiffPreview(repositoryPath, filePath, offset, maxBytes, loaded->preview, loaded->spool, nullptr, &cancelled);
+        },
+        [this, repositoryPath, loaded, callback](const GitCommandResult &) {
+            if (repositoryPath != m_repositoryPath) {
+                return;
+            }
+            m_diffSpool = loaded->spool;
+            callback(loaded->preview);
+        }, "file-diff");
+}
+
+QStringList GitManager::getTopLevelDirectories() const
+{
+    if (!m_isRepositoryOpen) return QStringList();
+    
+    QString output;
+    QStringList args;
+    args << "ls-tree" << "-d" << "--name-only" << "HEAD";
+    
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
+        return output.split('\n', Qt::SkipEmptyParts);
+    }
+    
+    return QStringList();
+}
+
+bool GitManager::isSparseCheckoutEnabled() const
+{
+    if (!m_isRepositoryOpen) return false;
+    
+    QString output;
+    QStringList args;
+    args << "config" << "--bool" << "core.sparseCheckout";
+    
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
+        return output.trimmed() == "true";
     }
     
-    return commits;
+    return false;
 }
 
-QString GitManager::getFileContent(const QString &filePath, const QString &revision) const
+QStringList GitManager::getSparseCheckoutDirectories() const
 {
-    if (!m_isRepositoryOpen) return QString();
+    if (!m_isRepositoryOpen || !isSparseCheckoutEnabled()) return QStringList();
     
     QString output;
     QStringList args;
-    args << "show" << (revision + ":" + filePath);
+    args << "sparse-checkout" << "list";
     
-    if (executeGitCommand("git", args, output)) {
-        return output;
+    if (executeCachedGitCommand(args, output, CacheUntilStateChanges)) {
+        return output.split('\n', Qt::SkipEmptyParts);
     }
     
-    return QString();
+    return QStringList();
 }
 
-QString GitManager::getFileDiff(const QString &filePath) const
+int GitManager::getCheckedOutFileCount() const
 {
-    if (!m_isRepositoryOpen) return QString();
+    if (!m_isRepositoryOpen) return 0;
     
     QString output;
     QStringList args;
-    args << "diff" << filePath;
+    args << "ls-files" << "-t";
     
-    if (executeGitCommand("git", args, output)) {
-        return output;
+    if (!executeGitCommand("git", args, output)) {
+        return 0;
     }
     
-    return QString();
+    int count = 0;
+    const QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        if (!line.startsWith("S ")) {
+            ++count;
+        }
+    }
+    
+    return count;
 }
 
 bool GitManager::stageFile(const QString &filePath)
@@ -239,7 +1493,7 @@ bool GitManager::stageFile(const QString &filePath)
     args << "add" << filePath;
     
     if (executeGitCommand("git", args)) {
-        emit fileStatusChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -254,7 +1508,7 @@ bool GitManager::unstageFile(const QString &filePath)
     args << "reset" << "HEAD" << filePath;
     
     if (executeGitCommand("git", args)) {
-        emit fileStatusChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -269,7 +1523,7 @@ bool GitManager::stageAll()
     args << "add" << ".";
     
     if (executeGitCommand("git", args)) {
-        emit fileStatusChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -284,7 +1538,7 @@ bool GitManager::unstageAll()
     args << "reset" << "HEAD";
     
     if (executeGitCommand("git", args)) {
-        emit fileStatusChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -299,7 +1553,7 @@ bool GitManager::commit(const QString &message)
     args << "commit" << "-m" << message;
     
     if (executeGitCommand("git", args)) {
-        emit fileStatusChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -314,7 +1568,7 @@ bool GitManager::createBranch(const QString &branchName)
     args << "branch" << branchName;
     
     if (executeGitCommand("git", args)) {
-        emit branchChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -329,8 +1583,7 @@ bool GitManager::switchBranch(const QString &branchName)
     args << "checkout" << branchName;
     
     if (executeGitCommand("git", args)) {
-        emit branchChanged();
-        emit repositoryChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -345,7 +1598,7 @@ bool GitManager::deleteBranch(const QString &branchName)
     args << "branch" << "-d" << branchName;
     
     if (executeGitCommand("git", args)) {
-        emit branchChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -360,7 +1613,7 @@ bool GitManager::mergeBranch(const QString &branchName)
     args << "merge" << branchName;
     
     if (executeGitCommand("git", args)) {
-        emit repositoryChanged();
+        m_refWatcher->checkNow();
         return true;
     }
     
@@ -387,88 +1640,645 @@ bool GitManager::removeRemote(const QString &name)
     return executeGitCommand("git", args);
 }
 
-bool GitManager::fetch(const QString &remote)
+bool GitManager::isFsMonitorEnabled() const
 {
-    if (!m_isRepositoryOpen) return false;
+    return m_fsMonitorEnabled;
+}
+
+bool GitManager::setFsMonitorEnabled(bool enabled)
+{
+    if (!m_isRepositoryOpen) {
+        m_lastError = "No repository opened";
+        return false;
+    }
     
-    QStringList args;
-    args << "fetch" << remote;
+    const bool success = enabled
+        ? GitFsMonitor::enable(m_repositoryPath, &m_lastError)
+        : GitFsMonitor::disable(m_repositoryPath, &m_lastError);
+    if (!success) {
+        return false;
+    }
     
-    if (executeGitCommand("git", args)) {
-        emit repositoryChanged();
-        return true;
+    m_fsMonitorEnabled = enabled;
+    m_statusBaselineMs = -1;
+    invalidateStateCache();
+    emit fsMonitorStateChanged(enabled);
+    
+    if (enabled) {
+        measureStatusBaseline();
+    }
+    return true;
+}
+
+void GitManager::measureStatusBaseline()
+{
+    if (!m_isRepositoryOpen) return;
+    
+    const QStringList args = {"--no-optional-locks", "-c", "core.fsmonitor=false", "status", "--porcelain", "--ignore-submodules=dirty"};
+    const QString repositoryPath = m_repositoryPath;
+    m_scheduler->submit(m_repositoryPath, args, GitCommandScheduler::Background, this,
+        [this, repositoryPath](const GitCommandResult &result) {
+            if (repositoryPath == m_repositoryPath && result.success) {
+                m_statusBaselineMs = result.elapsedMs;
+            }
+        }, "status-baseline");
+}
+
+qint64 GitManager::statusBaselineMs() const
+{
+    return m_statusBaselineMs;
+}
+
+void GitManager::recordStatusTiming(qint64 elapsedMs) const
+{
+    if (m_fsMonitorEnabled) {
+        emit const_cast<GitManager*>(this)->fileStatusTimed(elapsedMs, m_statusBaselineMs);
     }
+}
+
+QString GitManager::getLastError() const
+{
+    return m_lastError;
+}
+
+void GitManager::notifyRepositoryChanged()
+{
+    invalidateStateCache();
     
-    return false;
+    if (m_isRepositoryOpen) {
+        m_refWatcher->checkNow();
+    }
 }
 
-bool GitManager::pull(const QString &remote, const QString &branch)
+void GitManager::onRefsChanged(GitRefWatcher::Changes changes, const QString &oldHead, const QString &newHead)
 {
-    if (!m_isRepositoryOpen) return false;
+    invalidateStateCache();
     
-    QStringList args;
-    args << "pull" << remote;
-    if (!branch.isEmpty()) {
-        args << branch;
+    if (changes & GitRefWatcher::HeadMoved) {
+        emit headMoved(oldHead, newHead);
     }
+    if (changes & (GitRefWatcher::BranchSwitched | GitRefWatcher::LocalBranchesChanged)) {
+        emit branchChanged();
+    }
+    if (changes & GitRefWatcher::RemoteRefsChanged) {
+        emit remoteRefsChanged();
+    }
+    if (changes & GitRefWatcher::TagsChanged) {
+        invalidateTagNames();
+        emit tagsChanged();
+    }
+    if (changes & (GitRefWatcher::HeadMoved | GitRefWatcher::IndexChanged)) {
+        emit fileStatusChanged();
+    }
+}
+
+bool GitManager::isPartialClone(const QString &workingDirectory)
+{
+    QString output;
+    return runGitCommand(workingDirectory, {"config", "--get", "extensions.partialClone"}, output)
+        && !output.trimmed().isEmpty();
+}
+
+bool GitManager::runGitCommand(const QString &workingDirectory, const QStringList &args, QString &output, QString *error)
+{
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, args);
     
-    if (executeGitCommand("git", args)) {
-        emit repositoryChanged();
-        return true;
+    QProcess process;
+    process.setWorkingDirectory(workingDirectory);
+    process.start("git", args);
+    if (process.waitForStarted()) {
+        trace.markStarted();
     }
     
-    return false;
+    if (!process.waitForFinished(30000)) {
+        const QString message = process.error() == QProcess::FailedToStart
+            ? "Failed to start git: " + process.errorString()
+            : "Command timeout: git " + args.join(" ");
+        if (error) {
+            *error = message;
+        }
+        process.kill();
+        process.waitForFinished();
+        trace.finish(-1, false, message);
+        return false;
+    }
+    
+    const QByteArray stdoutData = process.readAllStandardOutput();
+    trace.addOutput(stdoutData.size());
+    
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        const QString message = QString::fromUtf8(process.readAllStandardError());
+        if (error) {
+            *error = message;
+        }
+        trace.finish(process.exitCode(), false, message);
+        return false;
+    }
+    
+    trace.finish(0, true);
+    output = QString::fromUtf8(stdoutData);
+    return true;
 }
 
-bool GitManager::push(const QString &remote, const QString &branch)
+bool GitManager::readGitOutput(const QString &workingDirectory, const QStringList &args, qint64 maxBytes,
+                               QByteArray &output, bool *truncated, QString *error)
 {
-    if (!m_isRepositoryOpen) return false;
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, args);
     
-    QStringList args;
-    args << "push" << remote;
-    if (!branch.isEmpty()) {
-        args << branch;
+    output.clear();
+    if (truncated) {
+        *truncated = false;
     }
     
-    if (executeGitCommand("git", args)) {
-        emit repositoryChanged();
+    QProcess process;
+    process.setWorkingDirectory(workingDirectory);
+    process.start("git", args);
+    if (!process.waitForStarted()) {
+        const QString message = "Failed to start git: " + process.errorString();
+        if (error) {
+            *error = message;
+        }
+        trace.finish(-1, false, message);
+        return false;
+    }
+    trace.markStarted();
+    
+    bool full = false;
+    auto consume = [&](const QByteArray &chunk) {
+        trace.addOutput(chunk.size());
+        output += chunk;
+        if (output.size() > maxBytes) {
+            output.truncate(maxBytes);
+            full = true;
+        }
+    };
+    
+    while (!full) {
+        const bool readable = process.waitForReadyRead(-1);
+        consume(process.readAllStandardOutput());
+        if (!readable && process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    
+    if (full) {
+        process.kill();
+        process.waitForFinished();
+        if (truncated) {
+            *truncated = true;
+        }
+        trace.finish(0, true);
         return true;
     }
     
-    return false;
+    process.waitForFinished(-1);
+    consume(process.readAllStandardOutput());
+    if (full && truncated) {
+        *truncated = true;
+    }
+    
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        const QString message = QString::fromUtf8(process.readAllStandardError());
+        if (error) {
+            *error = message;
+        }
+        trace.finish(process.exitCode(), false, message);
+        return false;
+    }
+    
+    trace.finish(0, true);
+    return true;
 }
 
-QString GitManager::getLastError() const
+bool GitManager::spoolGitOutput(const QString &workingDirectory, const QStringList &args, QIODevice &target,
+                                QString *error, const QAtomicInt *cancelled)
 {
-    return m_lastError;
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, args);
+    
+    QProcess process;
+    process.setWorkingDirectory(workingDirectory);
+    process.start("git", args);
+    if (!process.waitForStarted()) {
+        const QString message = "Failed to start git: " + process.errorString();
+        if (error) {
+            *error = message;
+        }
+        trace.finish(-1, false, message);
+        return false;
+    }
+    trace.markStarted();
+    
+    QString message;
+    auto consume = [&](const QByteArray &chunk) {
+        trace.addOutput(chunk.size());
+        if (target.write(chunk) != chunk.size()) {
+            message = "Cannot write git output: " + target.errorString();
+        }
+    };
+    
+    for (;;) {
+        if (cancelled && cancelled->loadRelaxed()) {
+            message = "Cancelled";
+        }
+        if (!message.isEmpty()) {
+            process.kill();
+            process.waitForFinished();
+            if (error) {
+                *error = message;
+            }
+            trace.finish(-1, false, message);
+            return false;
+        }
+        const bool readable = process.waitForReadyRead(SpoolPollMs);
+        consume(process.readAllStandardOutput());
+        if (!readable && process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    
+    process.waitForFinished(-1);
+    consume(process.readAllStandardOutput());
+    
+    if (message.isEmpty() && (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)) {
+        message = QString::fromUtf8(process.readAllStandardError());
+    }
+    if (!message.isEmpty()) {
+        if (error) {
+            *error = message;
+        }
+        trace.finish(process.exitCode(), false, message);
+        return false;
+    }
+    
+    trace.finish(0, true);
+    return true;
+}
+
+bool GitManager::exportBlob(const QString &workingDirectory, const QString &object, const QString &targetPath, QString *objectId, QString *error)
+{
+    QString resolved;
+    if (!runGitCommand(workingDirectory, {"rev-parse", "--verify", "--quiet", object}, resolved, error)) {
+        if (error && error->trimmed().isEmpty()) {
+            *error = "Unknown object " + object;
+        }
+        return false;
+    }
+    resolved = resolved.trimmed();
+    if (objectId) {
+        *objectId = resolved;
+    }
+    
+    const QStringList args = {"cat-file", "blob", resolved};
+    
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, args);
+    
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        const QString message = "Cannot write " + targetPath + ": " + target.errorString();
+        if (error) {
+            *error = message;
+        }
+        trace.finish(-1, false, message);
+        return false;
+    }
+    
+    QProcess process;
+    process.setWorkingDirectory(workingDirectory);
+    process.start("git", args);
+    if (!process.waitForStarted()) {
+        const QString message = "Failed to start git: " + process.errorString();
+        if (error) {
+            *error = message;
+        }
+        trace.finish(-1, false, message);
+        return false;
+    }
+    trace.markStarted();
+    
+    bool written = true;
+    auto drain = [&]() {
+        const QByteArray chunk = process.readAllStandardOutput();
+        trace.addOutput(chunk.size());
+        if (!chunk.isEmpty() && target.write(chunk) != chunk.size()) {
+            written = false;
+        }
+    };
+    
+    while (written) {
+        const bool readable = process.waitForReadyRead(-1);
+        drain();
+        if (!readable && process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    
+    if (!written) {
+        process.kill();
+    }
+    process.waitForFinished(-1);
+    drain();
+    target.close();
+    
+    if (!written || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        const QString message = written
+            ? QString::fromUtf8(process.readAllStandardError()).trimmed()
+            : "Cannot write " + targetPath + ": " + target.errorString();
+        if (error) {
+            *error = message;
+        }
+        trace.finish(process.exitCode(), false, message);
+        return false;
+    }
+    
+    trace.finish(0, true);
+    return true;
+}
+
+bool GitManager::loadDiffPreview(const QString &workingDirectory, const QString &filePath, qint64 offset, qint64 maxBytes,
+                                 GitDiffPreview &preview, QSharedPointer<GitDiffSpool> &spool, QString *error,
+                                 const QAtomicInt *cancelled)
+{
+    if (!spool || spool->preview.filePath != filePath) {
+        spool.reset();
+        
+        GitDiffPreview info;
+        info.filePath = filePath;
+        
+        QByteArray sniff;
+        QFile file(QDir(workingDirectory).filePath(filePath));
+        if (file.open(QIODevice::ReadOnly)) {
+            info.workingTreeSize = file.size();
+            sniff = file.read(BinarySniffBytes);
+        }
+        
+        QString output;
+        if (runGitCommand(workingDirectory, {"ls-files", "-s", "--", filePath}, output)) {
+            info.indexObjectId = output.section(' ', 1, 1);
+        }
+        
+        QByteArray blobHead;
+        if (!info.indexObjectId.isEmpty()) {
+            if (runGitCommand(workingDirectory, {"cat-file", "-s", info.indexObjectId}, output)) {
+                info.indexSize = output.trimmed().toLongLong();
+            }
+            if (!sniff.contains('\0') && info.indexSize > 0) {
+                readGitOutput(workingDirectory, {"cat-file", "blob", info.indexObjectId}, BinarySniffBytes, blobHead);
+            }
+        }
+        
+        info.isBinary = sniff.contains('\0') || blobHead.contains('\0');
+        if (info.isBinary) {
+            preview = info;
+            preview.head = (sniff.isEmpty() ? blobHead : sniff).left(BinaryHeadBytes);
+            preview.success = true;
+            return true;
+        }
+        
+        // The whole diff goes to a temporary file once, and every page,
+        // including "Load more", is read back from it.
+        QSharedPointer<GitDiffSpool> created(new GitDiffSpool);
+        created->preview = info;
+        QTemporaryFile spoolFile(QDir::temp().filePath("srikok-diff-XXXXXX"));
+        spoolFile.setAutoRemove(false);
+        if (!spoolFile.open()) {
+            if (error) {
+                *error = "Cannot create a temporary file: " + spoolFile.errorString();
+            }
+            return false;
+        }
+        created->path = spoolFile.fileName();
+        const bool spooled = spoolGitOutput(workingDirectory, {"diff", "--", filePath}, spoolFile, error, cancelled);
+        spoolFile.close();
+        if (!spooled) {
+            return false;
+        }
+        spool = created;
+    }
+    
+    preview = spool->preview;
+    preview.offset = offset;
+    preview.nextOffset = offset;
+    
+    QFile spoolFile(spool->path);
+    if (!spoolFile.open(QIODevice::ReadOnly) || !spoolFile.seek(offset)) {
+        if (error) {
+            *error = "Cannot read " + spool->path + ": " + spoolFile.errorString();
+        }
+        return false;
+    }
+    
+    QByteArray diff = spoolFile.read(maxBytes);
+    const bool truncated = offset + diff.size() < spoolFile.size();
+    if (truncated) {
+        const int lineEnd = diff.lastIndexOf('\n');
+        if (lineEnd >= 0) {
+            diff.truncate(lineEnd + 1);
+        }
+    }
+    
+    preview.text = QString::fromUtf8(diff);
+    preview.nextOffset = offset + diff.size();
+    preview.truncated = truncated;
+    preview.success = true;
+    return true;
+}
+
+QStringList GitManager::repositorySummaryArguments()
+{
+    QStringList args;
+    args << "--no-optional-locks" << "status" << "--porcelain=v2" << "--branch";
+    return args;
+}
+
+GitRepositorySummary GitManager::parseRepositorySummary(const QString &output)
+{
+    GitRepositorySummary summary;
+    const QStringList lines = output.split('\n', Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        if (line.startsWith("# branch.head ")) {
+            summary.branch = line.mid(14);
+        } else if (line.startsWith("# branch.upstream ")) {
+            summary.upstream = line.mid(18);
+        } else if (line.startsWith("# branch.ab ")) {
+            const QStringList counts = line.mid(12).split(' ', Qt::SkipEmptyParts);
+            if (counts.size() == 2) {
+                summary.ahead = counts[0].mid(1).toInt();
+                summary.behind = counts[1].mid(1).toInt();
+            }
+        } else if (!line.startsWith('#')) {
+            ++summary.changedFiles;
+        }
+    }
+    
+    return summary;
+}
+
+bool GitManager::getRepositorySummary(const QString &workingDirectory, GitRepositorySummary &summary, QList<GitFileStatus> *files, QString *error)
+{
+    QString output;
+    if (!runGitCommand(workingDirectory, repositorySummaryArguments(), output, error)) {
+        return false;
+    }
+    
+    summary = parseRepositorySummary(output);
+    if (files) {
+        *files = parseStatusEntries(output);
+    }
+    return true;
 }
 
-bool GitManager::executeGitCommand(const QString &command, const QStringList &args, QString &output) const
+bool GitManager::executeGitCommand(const QString &command, const QStringList &args, QString &output, int timeoutMs, const QByteArray &input) const
 {
+    GitProcessTrace trace;
+    trace.begin(m_repositoryPath, args);
+    
     QProcess process;
     process.setWorkingDirectory(m_repositoryPath);
     process.start(command, args);
+    if (process.waitForStarted()) {
+        trace.markStarted();
+        if (!input.isEmpty()) {
+            process.write(input);
+        }
+        process.closeWriteChannel();
+    }
     
-    if (!process.waitForFinished(30000)) {
-        const_cast<GitManager*>(this)->m_lastError = "Command timeout: " + command + " " + args.join(" ");
+    if (!process.waitForFinished(timeoutMs)) {
+        const_cast<GitManager*>(this)->m_lastError = process.error() == QProcess::FailedToStart
+            ? "Failed to start " + command + ": " + process.errorString()
+            : "Command timeout: " + command + " " + args.join(" ");
+        trace.finish(-1, false, m_lastError);
         return false;
     }
     
+    const QByteArray stdoutData = process.readAllStandardOutput();
+    trace.addOutput(stdoutData.size());
+    
     if (process.exitCode() != 0) {
         const_cast<GitManager*>(this)->m_lastError = process.readAllStandardError();
+        trace.finish(process.exitCode(), false, m_lastError);
         return false;
     }
     
-    output = process.readAllStandardOutput();
+    trace.finish(0, true);
+    output = QString::fromUtf8(stdoutData);
     return true;
 }
 
 bool GitManager::executeGitCommand(const QString &command, const QStringList &args) const
 {
+    invalidateStateCache();
+    
     QString output;
     return executeGitCommand(command, args, output);
 }
 
+bool GitManager::executeCachedGitCommand(const QStringList &args, QString &output, CachePolicy policy) const
+{
+    const QString key = args.join(QChar(0));
+    
+    if (policy == CacheForever) {
+        if (const QString *cached = m_immutableCache.object(key)) {
+            output = *cached;
+            return true;
+        }
+    } else {
+        const QString token = stateToken();
+        if (token != m_stateCacheToken) {
+            m_stateCache.clear();
+            m_stateCacheBytes = 0;
+            m_stateCacheToken = token;
+        }
+        
+        auto it = m_stateCache.constFind(key);
+        if (it != m_stateCache.constEnd()) {
+            output = it.value();
+            return true;
+        }
+    }
+    
+    if (!executeGitCommand("git", args, output)) {
+        return false;
+    }
+    
+    const qint64 cost = qMax<qint64>(1, qint64(output.size()) * qint64(sizeof(QChar)));
+    if (policy == CacheForever) {
+        if (cost <= m_immutableCache.maxCost()) {
+            m_immutableCache.insert(key, new QString(output), cost);
+        }
+    } else if (m_stateCacheBytes + cost <= StateCacheBudget) {
+        m_stateCache.insert(key, output);
+        m_stateCacheBytes += cost;
+    }
+    
+    return true;
+}
+
+QString GitManager::stateToken() const
+{
+    if (m_stateTokenTimer.isValid() && m_stateTokenTimer.elapsed() < StateTokenLifetimeMs) {
+        return m_stateToken;
+    }
+    
+    const QString gitDir = getGitDirectory();
+    QString commonDir = gitDir;
+    QFile commonDirFile(gitDir + "/commondir");
+    if (commonDirFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        commonDir = QDir(gitDir).absoluteFilePath(QString::fromUtf8(commonDirFile.readLine()).trimmed());
+    }
+    
+    auto fileStamp = [](const QString &path) {
+        QFileInfo info(path);
+        if (!info.exists()) {
+            return QString("-");
+        }
+        return QString("%1:%2").arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size());
+    };
+    
+    QString token;
+    QFile head(gitDir + "/HEAD");
+    if (head.open(QIODevice::ReadOnly)) {
+        token += QString::fromUtf8(head.readAll()).trimmed();
+    }
+    token += '|' + fileStamp(gitDir + "/index");
+    token += '|' + fileStamp(commonDir + "/packed-refs");
+    token += '|' + fileStamp(commonDir + "/config");
+    token += '|' + fileStamp(commonDir + "/shallow");
+    
+    qint64 newestRefDirectory = QFileInfo(commonDir + "/refs").lastModified().toMSecsSinceEpoch();
+    int refDirectories = 0;
+    QDirIterator it(commonDir + "/refs", QDir::Dirs | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        newestRefDirectory = qMax(newestRefDirectory, it.fileInfo().lastModified().toMSecsSinceEpoch());
+        ++refDirectories;
+    }
+    token += QString("|%1:%2").arg(newestRefDirectory).arg(refDirectories);
+    
+    m_stateToken = token;
+    m_stateTokenTimer.start();
+    return m_stateToken;
+}
+
+void GitManager::invalidateStateCache() const
+{
+    m_stateTokenTimer.invalidate();
+    m_stateCache.clear();
+    m_stateCacheBytes = 0;
+    m_stateCacheToken.clear();
+}
+
+void GitManager::invalidateTagNames() const
+{
+    m_tagNames.reset();
+    m_tagNamesKey.clear();
+    ++m_tagNamesGeneration;
+}
+
 QString GitManager::parseGitOutput(const QString &output) const
 {
     return output.trimmed();
@@ -7,6 +7,21 @@
 #include <QProcess>
 #include <QFileInfo>
 #include <QDir>
+#include <QCache>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSharedPointer>
+#include <QAtomicInt>
+#include <functional>
+#include "gitcommandscheduler.h"
+#include "gitrefwatcher.h"
+
+class CommitGraph;
+class CommitStore;
+struct RepositoryStatsSummary;
+struct ObjectSizeReport;
+struct GitTagRef;
+struct GitTagPage;
 
 struct GitFileStatus {
     QString filePath;
@@ -25,27 +40,145 @@ struct GitCommit {
     QStringList parents;
 };
 
+struct GitBranchRef {
+    QString name;
+    QString refName;
+    QString upstream;
+    QString commitHash;
+    QString subject;
+    qint64 commitTime;
+    bool isRemote;
+    bool isCurrent;
+};
+
+struct GitSearchMatch {
+    QString filePath;
+    int lineNumber;
+    QString text;
+};
+
+struct GitDiffPreview {
+    QString filePath;
+    QString text;
+    QByteArray head;
+    QString indexObjectId;
+    qint64 workingTreeSize;
+    qint64 indexSize;
+    qint64 offset;
+    qint64 nextOffset;
+    bool isBinary;
+    bool truncated;
+    bool success;
+    
+    GitDiffPreview();
+};
+
+struct GitDiffSpool {
+    QString path;
+    GitDiffPreview preview;
+    
+    ~GitDiffSpool();
+};
+
+struct GitRepositorySummary {
+    QString branch;
+    QString upstream;
+    int ahead;
+    int behind;
+    int changedFiles;
+    
+    GitRepositorySummary();
+    bool operator==(const GitRepositorySummary &other) const;
+    bool operator!=(const GitRepositorySummary &other) const;
+};
+
+struct GitSubmodule {
+    QString name;
+    QString path;
+    QString url;
+    bool initialized;
+    
+    GitSubmodule();
+};
+
+struct GitSubmoduleStatus {
+    QString path;
+    QString headCommit;
+    GitRepositorySummary summary;
+    QList<GitFileStatus> files;
+    qint64 elapsedMs;
+    bool success;
+    QString error;
+    
+    GitSubmoduleStatus();
+};
+
+struct GitCloneOptions {
+    QString url;
+    QString path;
+    QString branch;
+    int depth;
+    QString filter;
+    bool singleBranch;
+    QStringList sparseDirectories;
+    
+    GitCloneOptions();
+    QStringList cloneArguments() const;
+    QStringList sparseCheckoutArguments() const;
+};
+
 class GitManager : public QObject
 {
     Q_OBJECT
 
 public:
     explicit GitManager(QObject *parent = nullptr);
+    ~GitManager();
     
     bool openRepository(const QString &path);
     bool cloneRepository(const QString &url, const QString &path);
+    bool cloneRepository(const GitCloneOptions &options);
     bool isRepositoryOpen() const;
     QString getRepositoryPath() const;
+    QString getGitDirectory() const;
+    QString getObjectsDirectory() const;
+    QString resolveHeadCommit() const;
+    const CommitGraph *commitGraph() const;
     
     QString getCurrentBranch() const;
     QStringList getBranches() const;
     QStringList getRemoteBranches() const;
     QStringList getRemotes() const;
+    QList<GitBranchRef> getBranchRefs(QString *error = nullptr) const;
     
     QList<GitFileStatus> getFileStatus() const;
-    QList<GitCommit> getCommitHistory(int limit = 100) const;
+    QList<GitCommit> getCommitHistory(int limit = 100, QString *error = nullptr) const;
+    QList<GitCommit> getCommitsByHash(const QStringList &hashes) const;
     QString getFileContent(const QString &filePath, const QString &revision = "HEAD") const;
-    QString getFileDiff(const QString &filePath) const;
+    QString getFileDiff(const QString &filePath, QString *error = nullptr) const;
+    QList<GitCommit> searchCommits(const QString &text, int limit = 100, QString *error = nullptr) const;
+    QList<GitSearchMatch> searchFiles(const QString &text, int limit = 1000, QString *error = nullptr) const;
+    
+    GitCommandScheduler *scheduler() const;
+    quint64 requestFileStatus(QObject *context, std::function<void(const QList<GitFileStatus> &)> callback) const;
+    quint64 requestCommitStore(int limit, QObject *context, std::function<void(QSharedPointer<const CommitStore>)> callback) const;
+    quint64 requestCommitStoreUpdate(QSharedPointer<const CommitStore> base, const QString &oldHead, const QString &newHead, int limit,
+                                     QObject *context, std::function<void(QSharedPointer<const CommitStore>)> callback) const;
+    void requestFileExport(const QString &filePath, const QString &revision, const QString &targetPath, QObject *context, std::function<void(bool, const QString &, const QString &)> callback) const;
+    quint64 requestObjectSizeReport(QObject *context, std::function<void(const ObjectSizeReport &)> callback) const;
+    quint64 requestIntroducingCommit(const QString &objectId, QObject *context, std::function<void(const QString &)> callback) const;
+    void requestTagPage(const QString &prefix, int sortOrder, int offset, int limit, QObject *context, std::function<void(const GitTagPage &)> callback) const;
+    quint64 requestSubmodules(QObject *context, std::function<void(const QList<GitSubmodule> &)> callback) const;
+    quint64 requestSubmoduleStatus(const QString &path, QObject *context, std::function<void(const GitSubmoduleStatus &)> callback) const;
+    quint64 requestAheadBehind(const QString &branch, const QString &upstream, QObject *context, std::function<void(bool, int, int)> callback) const;
+    quint64 requestTagDetails(const QStringList &names, QObject *context, std::function<void(bool, const QList<GitTagRef> &)> callback) const;
+    void requestRepositoryStats(QObject *context, std::function<void(const RepositoryStatsSummary &)> callback) const;
+    quint64 requestDiffPreview(const QString &filePath, qint64 offset, qint64 maxBytes, QObject *context, std::function<void(const GitDiffPreview &)> callback) const;
+    
+    QStringList getTopLevelDirectories() const;
+    bool isSparseCheckoutEnabled() const;
+    QStringList getSparseCheckoutDirectories() const;
+    int getCheckedOutFileCount() const;
     
     bool stageFile(const QString &filePath);
     bool unstageFile(const QString &filePath);
@@ -60,25 +193,93 @@ public:
     
     bool addRemote(const QString &name, const QString &url);
     bool removeRemote(const QString &name);
-    bool fetch(const QString &remote = "origin");
-    bool pull(const QString &remote = "origin", const QString &branch = "");
-    bool push(const QString &remote = "origin", const QString &branch = "");
     
     QString getLastError() const;
+    void notifyRepositoryChanged();
+    
+    bool isFsMonitorEnabled() const;
+    bool setFsMonitorEnabled(bool enabled);
+    void measureStatusBaseline();
+    qint64 statusBaselineMs() const;
+    
+    static bool runGitCommand(const QString &workingDirectory, const QStringList &args, QString &output, QString *error = nullptr);
+    static bool isPartialClone(const QString &workingDirectory);
+    static bool readGitOutput(const QString &workingDirectory, const QStringList &args, qint64 maxBytes,
+                              QByteArray &output, bool *truncated = nullptr, QString *error = nullptr);
+    static bool spoolGitOutput(const QString &workingDirectory, const QStringList &args, QIODevice &target,
+                               QString *error = nullptr, const QAtomicInt *cancelled = nullptr);
+    static bool exportBlob(const QString &workingDirectory, const QString &object, const QString &targetPath, QString *objectId = nullptr, QString *error = nullptr);
+    static bool loadDiffPreview(const QString &workingDirectory, const QString &filePath, qint64 offset, qint64 maxBytes,
+                                GitDiffPreview &preview, QSharedPointer<GitDiffSpool> &spool, QString *error = nullptr,
+                                const QAtomicInt *cancelled = nullptr);
+    static bool getRepositorySummary(const QString &workingDirectory, GitRepositorySummary &summary, QList<GitFileStatus> *files = nullptr, QString *error = nullptr);
+    static QStringList repositorySummaryArguments();
+    static GitRepositorySummary parseRepositorySummary(const QString &output);
+    static QList<GitFileStatus> parseFileStatus(const QString &output);
+    static QList<GitFileStatus> parseStatusEntries(const QString &output);
+    static QStringList submoduleListArguments();
+    static QList<GitSubmodule> parseSubmoduleList(const QString &repositoryPath, const QString &output);
+    static QStringList submoduleStatusArguments();
+    static void parseSubmoduleStatus(const QString &output, GitSubmoduleStatus &status);
+    static QStringList commitHistoryArguments(int limit);
+    static QList<GitCommit> parseCommitLog(const QString &output);
+    static bool loadCommitStore(const QString &workingDirectory, int limit, CommitStore &store, QString *error = nullptr,
+                                const QString &range = QString());
 
 signals:
     void repositoryChanged();
     void fileStatusChanged();
     void branchChanged();
+    void headMoved(const QString &oldHead, const QString &newHead);
+    void remoteRefsChanged();
+    void tagsChanged();
+    void fsMonitorStateChanged(bool enabled);
+    void fileStatusTimed(qint64 elapsedMs, qint64 baselineMs);
+
+private slots:
+    void onRefsChanged(GitRefWatcher::Changes changes, const QString &oldHead, const QString &newHead);
 
 private:
-    bool executeGitCommand(const QString &command, const QStringList &args, QString &output) const;
+    enum CachePolicy {
+        CacheUntilStateChanges,
+        CacheForever
+    };
+    
+    static const qint64 StateCacheBudget = 16 * 1024 * 1024;
+    static const qint64 ImmutableCacheBudget = 64 * 1024 * 1024;
+    static const int StateTokenLifetimeMs = 50;
+    
+    bool executeCachedGitCommand(const QStringList &args, QString &output, CachePolicy policy) const;
+    QString stateToken() const;
+    void invalidateStateCache() const;
+    void invalidateTagNames() const;
+    bool executeGitCommand(const QString &command, const QStringList &args, QString &output, int timeoutMs = 30000, const QByteArray &input = QByteArray()) const;
     bool executeGitCommand(const QString &command, const QStringList &args) const;
     QString parseGitOutput(const QString &output) const;
+    QString readRef(const QString &refName) const;
+    QList<GitCommit> getCommitHistoryFromGraph(int limit) const;
+    void recordStatusTiming(qint64 elapsedMs) const;
     
     QString m_repositoryPath;
+    mutable CommitGraph *m_commitGraph;
+    GitCommandScheduler *m_scheduler;
+    GitRefWatcher *m_refWatcher;
+    
+    mutable QHash<QString, QString> m_stateCache;
+    mutable qint64 m_stateCacheBytes;
+    mutable QString m_stateCacheToken;
+    mutable QString m_stateToken;
+    mutable QElapsedTimer m_stateTokenTimer;
+    mutable QCache<QString, QString> m_immutableCache;
+    mutable QSharedPointer<GitDiffSpool> m_diffSpool;
+    mutable QSharedPointer<const QStringList> m_tagNames;
+    mutable QString m_tagNamesKey;
+    mutable quint64 m_tagNamesGeneration;
+    mutable QList<quint64> m_statsRequests;
     QString m_lastError;
     bool m_isRepositoryOpen;
+    bool m_fsMonitorEnabled;
+    qint64 m_statusBaselineMs;
 };
 
 #endif // GITMANAGER_H
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "gitprogress.h"
+#include <QRegularExpression>
+
+GitProgressInfo::GitProgressInfo()
+    : percent(-1)
+    , current(0)
+    , total(0)
+    , bytes(-1)
+    , bytesPerSecond(-1)
+    , done(false)
+{
+}
+
+QString GitProgressInfo::toString() const
+{
+    QString text = phase;
+    
+    if (total > 0) {
+        text += QString(": %1% (%2/%3)").arg(percent).arg(current).arg(total);
+    } else if (current > 0) {
+        text += QString(": %1").arg(current);
+    }
+    
+    if (bytes >= 0) {
+        text += ", " + GitProgressParser::formatBytes(bytes);
+    }
+    if (bytesPerSecond >= 0) {
+        text += " | " + GitProgressParser::formatBytes(bytesPerSecond) + "/s";
+    }
+    if (done) {
+        text += ", done";
+    }
+    
+    return text;
+}
+
+GitProgressParser::GitProgressParser()
+{
+}
+
+QList<GitProgressInfo> GitProgressParser::feed(const QByteArray &data)
+{
+    QList<GitProgressInfo> updates;
+    m_buffer.append(data);
+    
+    int start = 0;
+    for (int i = 0; i < m_buffer.size(); ++i) {
+        const char c = m_buffer.at(i);
+        if (c != '\r' && c != '\n') {
+            continue;
+        }
+        
+        const QString line = QString::fromUtf8(m_buffer.mid(start, i - start)).trimmed();
+        start = i + 1;
+        if (line.isEmpty()) {
+            continue;
+        }
+        
+        GitProgressInfo info;
+        if (parseLine(line, info)) {
+            updates.append(info);
+        } else if (c == '\n') {
+            m_messages.append(line);
+        }
+    }
+    
+    m_buffer.remove(0, start);
+    return updates;
+}
+
+QList<GitProgressInfo> GitProgressParser::finish()
+{
+    if (m_buffer.isEmpty()) {
+        return QList<GitProgressInfo>();
+    }
+    return feed("\n");
+}
+
+QStringList GitProgressParser::messages() const
+{
+    return m_messages;
+}
+
+void GitProgressParser::reset()
+{
+    m_buffer.clear();
+    m_messages.clear();
+}
+
+bool GitProgressParser::parseLine(const QString &line, GitProgressInfo &info) const
+{
+    static const QRegularExpression percentPattern(
+        "^(?:remote: )?([A-Za-z][A-Za-z ]*):\\s+(\\d+)% \\((\\d+)/(\\d+)\\)"
+        "(?:, ([\\d.]+) (bytes|KiB|MiB|GiB|TiB))?"
+        "(?: \\| ([\\d.]+) (bytes|KiB|MiB|GiB|TiB)/s)?"
+        "(, done\\.?)?");
+    static const QRegularExpression countPattern(
+        "^(?:remote: )?([A-Za-z][A-Za-z ]*):\\s+(\\d+)(, done\\.?)?$");
+    
+    QRegularExpressionMatch match = percentPattern.match(line);
+    if (match.hasMatch()) {
+        info.phase = match.captured(1);
+        info.percent = match.captured(2).toInt();
+        info.current = match.captured(3).toLongLong();
+        info.total = match.captured(4).toLongLong();
+        if (match.capturedLength(5) > 0) {
+            info.bytes = parseSize(match.captured(5), match.captured(6));
+        }
+        if (match.capturedLength(7) > 0) {
+            info.bytesPerSecond = parseSize(match.captured(7), match.captured(8));
+        }
+        info.done = match.capturedLength(9) > 0;
+        return true;
+    }
+    
+    match = countPattern.match(line);
+    if (match.hasMatch()) {
+        info.phase = match.captured(1);
+        info.current = match.captured(2).toLongLong();
+        info.done = match.capturedLength(3) > 0;
+        return true;
+    }
+    
+    return false;
+}
+
+qint64 GitProgressParser::parseSize(const QString &value, const QString &unit)
+{
+    double size = value.toDouble();
+    if (unit == "KiB") {
+        size *= 1024.0;
+    } else if (unit == "MiB") {
+        size *= 1024.0 * 1024.0;
+    } else if (unit == "GiB") {
+        size *= 1024.0 * 1024.0 * 1024.0;
+    } else if (unit == "TiB") {
+        size *= 1024.0 * 1024.0 * 1024.0 * 1024.0;
+    }
+    return qint64(size);
+}
+
+QString GitProgressParser::formatBytes(qint64 bytes)
+{
+    const char *units[] = {"bytes", "KiB", "MiB", "GiB", "TiB"};
+    double size = bytes;
+    int unit = 0;
+    while (size >= 1024.0 && unit < 4) {
+        size /= 1024.0;
+        ++unit;
+    }
+    
+    if (unit == 0) {
+        return QString("%1 %2").arg(bytes).arg(units[0]);
+    }
+    return QString("%1 %2").arg(size, 0, 'f', 2).arg(units[unit]);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef GITPROGRESS_H
+#define GITPROGRESS_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+struct GitProgressInfo {
+    QString phase;
+    int percent;
+    qint64 current;
+    qint64 total;
+    qint64 bytes;
+    qint64 bytesPerSecond;
+    bool done;
+    
+    GitProgressInfo();
+    QString toString() const;
+};
+
+class GitProgressParser
+{
+public:
+    GitProgressParser();
+    
+    QList<GitProgressInfo> feed(const QByteArray &data);
+    QList<GitProgressInfo> finish();
+    QStringList messages() const;
+    void reset();
+    
+    static QString formatBytes(qint64 bytes);
+
+private:
+    bool parseLine(const QString &line, GitProgressInfo &info) const;
+    static qint64 parseSize(const QString &value, const QString &unit);
+    
+    QByteArray m_buffer;
+    QStringList m_messages;
+};
+
+#endif // GITPROGRESS_H
\ No newline at end of file
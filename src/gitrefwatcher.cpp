@@ -0,0 +1,269 @@
+#include "gitrefwatcher.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QtEndian>
+
+namespace {
+
+const int DebounceMs = 150;
+const int IndexChecksumBytes = 32;
+const int IndexHeaderBytes = 12;
+const int IndexTimestampSlackMs = 2000;
+
+QByteArray readRef(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.read(512).trimmed();
+}
+
+}
+
+GitRefWatcher::GitRefWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_debounceTimer.setSingleShot(true);
+    m_debounceTimer.setInterval(DebounceMs);
+    
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, this, &GitRefWatcher::onPathChanged);
+    connect(&m_watcher, &QFileSystemWatcher::fileChanged, this, &GitRefWatcher::onPathChanged);
+    connect(&m_debounceTimer, &QTimer::timeout, this, &GitRefWatcher::checkNow);
+}
+
+void GitRefWatcher::setRepository(const QString &gitDirectory)
+{
+    clear();
+    if (gitDirectory.isEmpty()) {
+        return;
+    }
+    
+    m_gitDirectory = QDir(gitDirectory).absolutePath();
+    m_commonDirectory = m_gitDirectory;
+    QFile commonDirFile(m_gitDirectory + "/commondir");
+    if (commonDirFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        m_commonDirectory = QDir(QDir(m_gitDirectory).absoluteFilePath(QString::fromUtf8(commonDirFile.readLine()).trimmed())).absolutePath();
+    }
+    
+    updateWatches();
+    m_snapshot = takeSnapshot();
+}
+
+void GitRefWatcher::clear()
+{
+    m_debounceTimer.stop();
+    const QStringList watched = m_watcher.directories() + m_watcher.files();
+    if (!watched.isEmpty()) {
+        m_watcher.removePaths(watched);
+    }
+    m_gitDirectory.clear();
+    m_commonDirectory.clear();
+    m_snapshot = Snapshot();
+    m_packedRefs.clear();
+    m_packedRefsStamp.clear();
+}
+
+GitRefWatcher::Changes GitRefWatcher::checkNow()
+{
+    m_debounceTimer.stop();
+    if (m_gitDirectory.isEmpty()) {
+        return NoChange;
+    }
+    
+    updateWatches();
+    Snapshot snapshot = takeSnapshot();
+    const Changes changes = compare(m_snapshot, snapshot);
+    const QString oldHead = QString::fromLatin1(m_snapshot.headCommit);
+    m_snapshot = snapshot;
+    
+    if (changes != NoChange) {
+        emit changed(changes, oldHead, QString::fromLatin1(m_snapshot.headCommit));
+    }
+    return changes;
+}
+
+void GitRefWatcher::absorbIndexChange(const QByteArray &stampBefore, const QDateTime &startedAt)
+{
+    if (m_gitDirectory.isEmpty() || m_snapshot.indexStamp != stampBefore) {
+        return;
+    }
+    
+    const QByteArray current = indexStamp();
+    if (current == stampBefore) {
+        return;
+    }
+    
+    // A status refresh rewrites stat data but never adds or removes entries,
+    // and it can only have written the index while it was running.
+    const QDateTime modified = QFileInfo(m_gitDirectory + "/index").lastModified();
+    if (modified < startedAt.addMSecs(-IndexTimestampSlackMs)
+        || indexEntryCount(current) != indexEntryCount(stampBefore)) {
+        return;
+    }
+    
+    m_snapshot.indexStamp = current;
+}
+
+QString GitRefWatcher::headCommit() const
+{
+    return QString::fromLatin1(m_snapshot.headCommit);
+}
+
+void GitRefWatcher::onPathChanged()
+{
+    m_debounceTimer.start();
+}
+
+GitRefWatcher::Snapshot GitRefWatcher::takeSnapshot()
+{
+    Snapshot snapshot;
+    loadPackedRefs();
+    snapshot.refs = m_packedRefs;
+    
+    const QString refsDirectory = m_commonDirectory + "/refs";
+    QDirIterator it(refsDirectory, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (path.endsWith(".lock")) {
+            continue;
+        }
+        const QByteArray value = readRef(path);
+        if (!value.isEmpty()) {
+            snapshot.refs.insert("refs/" + QDir(refsDirectory).relativeFilePath(path).toUtf8(), value);
+        }
+    }
+    
+    const QByteArray head = readRef(m_gitDirectory + "/HEAD");
+    if (head.startsWith("ref:")) {
+        snapshot.headTarget = head.mid(4).trimmed();
+        snapshot.headCommit = snapshot.refs.value(snapshot.headTarget);
+    } else {
+        snapshot.headCommit = head;
+    }
+    
+    snapshot.indexStamp = indexStamp();
+    return snapshot;
+}
+
+QByteArray GitRefWatcher::indexStamp() const
+{
+    QFile index(m_gitDirectory + "/index");
+    if (!index.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    const QByteArray header = index.read(IndexHeaderBytes);
+    const quint32 entries = header.size() == IndexHeaderBytes ? qFromBigEndian<quint32>(header.constData() + 8) : 0;
+    const qint64 size = index.size();
+    index.seek(qMax<qint64>(0, size - IndexChecksumBytes));
+    return QByteArray::number(size) + ':' + QByteArray::number(entries) + ':' + index.read(IndexChecksumBytes);
+}
+
+quint32 GitRefWatcher::indexEntryCount(const QByteArray &stamp)
+{
+    const int first = stamp.indexOf(':');
+    const int second = stamp.indexOf(':', first + 1);
+    return first < 0 || second < 0 ? 0 : stamp.mid(first + 1, second - first - 1).toUInt();
+}
+
+void GitRefWatcher::loadPackedRefs()
+{
+    const QString path = m_commonDirectory + "/packed-refs";
+    const QFileInfo info(path);
+    const QString stamp = info.exists()
+        ? QString("%1:%2:%3").arg(info.lastModified().toMSecsSinceEpoch()).arg(info.size()).arg(info.metadataChangeTime().toMSecsSinceEpoch())
+        : QString("-");
+    if (stamp == m_packedRefsStamp) {
+        return;
+    }
+    
+    m_packedRefsStamp = stamp;
+    m_packedRefs.clear();
+    
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith('^')) {
+            continue;
+        }
+        const int space = line.indexOf(' ');
+        if (space > 0) {
+            m_packedRefs.insert(line.mid(space + 1), line.left(space));
+        }
+    }
+}
+
+void GitRefWatcher::updateWatches()
+{
+    QSet<QString> wanted;
+    wanted.insert(m_gitDirectory);
+    wanted.insert(m_commonDirectory);
+    
+    const QString refsDirectory = m_commonDirectory + "/refs";
+    if (QFileInfo(refsDirectory).isDir()) {
+        wanted.insert(refsDirectory);
+        QDirIterator it(refsDirectory, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            wanted.insert(it.next());
+        }
+    }
+    
+    const QStringList watched = m_watcher.directories();
+    QStringList stale;
+    for (const QString &path : watched) {
+        if (!wanted.remove(path)) {
+            stale.append(path);
+        }
+    }
+    if (!stale.isEmpty()) {
+        m_watcher.removePaths(stale);
+    }
+    if (!wanted.isEmpty()) {
+        m_watcher.addPaths(QStringList(wanted.begin(), wanted.end()));
+    }
+}
+
+GitRefWatcher::Changes GitRefWatcher::compare(const Snapshot &before, const Snapshot &after)
+{
+    Changes changes = NoChange;
+    
+    if (before.headTarget != after.headTarget) {
+        changes |= BranchSwitched;
+    }
+    if (before.headCommit != after.headCommit) {
+        changes |= HeadMoved;
+    }
+    if (before.indexStamp != after.indexStamp) {
+        changes |= IndexChanged;
+    }
+    
+    auto classify = [&changes](const QByteArray &name) {
+        if (name.startsWith("refs/heads/")) {
+            changes |= LocalBranchesChanged;
+        } else if (name.startsWith("refs/remotes/")) {
+            changes |= RemoteRefsChanged;
+        } else if (name.startsWith("refs/tags/")) {
+            changes |= TagsChanged;
+        }
+    };
+    
+    for (auto it = after.refs.constBegin(); it != after.refs.constEnd(); ++it) {
+        auto previous = before.refs.constFind(it.key());
+        if (previous == before.refs.constEnd() || previous.value() != it.value()) {
+            classify(it.key());
+        }
+    }
+    for (auto it = before.refs.constBegin(); it != before.refs.constEnd(); ++it) {
+        if (!after.refs.contains(it.key())) {
+            classify(it.key());
+        }
+    }
+    
+    return changes;
+}
\ No newline at end of file
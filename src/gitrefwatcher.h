@@ -0,0 +1,69 @@
+#ifndef GITREFWATCHER_H
+#define GITREFWATCHER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QDateTime>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QString>
+#include <QTimer>
+
+class GitRefWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Change {
+        NoChange = 0,
+        HeadMoved = 0x01,
+        BranchSwitched = 0x02,
+        LocalBranchesChanged = 0x04,
+        RemoteRefsChanged = 0x08,
+        TagsChanged = 0x10,
+        IndexChanged = 0x20
+    };
+    Q_DECLARE_FLAGS(Changes, Change)
+    Q_FLAG(Changes)
+    
+    explicit GitRefWatcher(QObject *parent = nullptr);
+    
+    void setRepository(const QString &gitDirectory);
+    void clear();
+    Changes checkNow();
+    QByteArray indexStamp() const;
+    void absorbIndexChange(const QByteArray &stampBefore, const QDateTime &startedAt);
+    QString headCommit() const;
+
+signals:
+    void changed(GitRefWatcher::Changes changes, const QString &oldHead, const QString &newHead);
+
+private slots:
+    void onPathChanged();
+
+private:
+    struct Snapshot {
+        QByteArray headTarget;
+        QByteArray headCommit;
+        QHash<QByteArray, QByteArray> refs;
+        QByteArray indexStamp;
+    };
+    
+    Snapshot takeSnapshot();
+    void loadPackedRefs();
+    void updateWatches();
+    static quint32 indexEntryCount(const QByteArray &stamp);
+    static Changes compare(const Snapshot &before, const Snapshot &after);
+    
+    QFileSystemWatcher m_watcher;
+    QTimer m_debounceTimer;
+    QString m_gitDirectory;
+    QString m_commonDirectory;
+    Snapshot m_snapshot;
+    QHash<QByteArray, QByteArray> m_packedRefs;
+    QString m_packedRefsStamp;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(GitRefWatcher::Changes)
+
+#endif // GITREFWATCHER_H
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "gittracer.h"
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QThread>
+
+namespace {
+
+thread_local QString t_currentAction;
+
+const int DefaultCapacity = 4096;
+
+quint64 currentThreadId()
+{
+    return quint64(quintptr(QThread::currentThreadId()));
+}
+
+QString commandName(const QStringList &args)
+{
+    static const QStringList OptionsWithValue = {"-c", "-C", "--git-dir", "--work-tree", "--namespace",
+                                                 "--super-prefix", "--config-env", "--attr-source"};
+    
+    for (int i = 0; i < args.size(); ++i) {
+        const QString &arg = args.at(i);
+        if (OptionsWithValue.contains(arg)) {
+            ++i;
+        } else if (!arg.startsWith('-')) {
+            return arg;
+        }
+    }
+    return args.value(0);
+}
+
+}
+
+GitTraceEvent::GitTraceEvent()
+    : id(0)
+    , startUs(0)
+    , spawnUs(-1)
+    , durationUs(0)
+    , outputBytes(-1)
+    , itemCount(-1)
+    , exitCode(0)
+    , success(true)
+    , threadId(0)
+{
+}
+
+GitTracer::GitTracer()
+    : m_capacity(DefaultCapacity)
+    , m_next(0)
+    , m_nextId(1)
+{
+    m_clock.start();
+}
+
+GitTracer *GitTracer::instance()
+{
+    static GitTracer tracer;
+    return &tracer;
+}
+
+qint64 GitTracer::now() const
+{
+    return m_clock.nsecsElapsed() / 1000;
+}
+
+void GitTracer::record(GitTraceEvent event)
+{
+    if (event.threadId == 0) {
+        event.threadId = currentThreadId();
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    event.id = m_nextId++;
+    
+    if (m_buffer.size() < m_capacity) {
+        m_buffer.append(event);
+    } else {
+        m_buffer[m_next] = event;
+    }
+    m_next = (m_next + 1) % m_capacity;
+}
+
+QList<GitTraceEvent> GitTracer::events(quint64 afterId) const
+{
+    QMutexLocker locker(&m_mutex);
+    
+    QList<GitTraceEvent> result;
+    const int count = m_buffer.size();
+    const int first = count < m_capacity ? 0 : m_next;
+    for (int i = 0; i < count; ++i) {
+        const GitTraceEvent &event = m_buffer.at((first + i) % count);
+        if (event.id > afterId) {
+            result.append(event);
+        }
+    }
+    return result;
+}
+
+void GitTracer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_buffer.clear();
+    m_next = 0;
+}
+
+void GitTracer::setCapacity(int capacity)
+{
+    const QList<GitTraceEvent> current = events();
+    
+    QMutexLocker locker(&m_mutex);
+    m_capacity = qMax(16, capacity);
+    m_buffer.clear();
+    for (int i = qMax(0, int(current.size()) - m_capacity); i < current.size(); ++i) {
+        m_buffer.append(current.at(i));
+    }
+    m_next = m_buffer.size() % m_capacity;
+}
+
+int GitTracer::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_capacity;
+}
+
+QByteArray GitTracer::toChromeTrace() const
+{
+    const QList<GitTraceEvent> recorded = events();
+    const qint64 pid = 1;
+    
+    // Chrome expects integer thread ids, and raw thread handles do not fit
+    // a JSON number, so threads are numbered in order of appearance.
+    QHash<quint64, int> threadNumbers;
+    QJsonArray traceEvents;
+    for (const GitTraceEvent &event : recorded) {
+        int tid = threadNumbers.value(event.threadId);
+        if (tid == 0) {
+            tid = int(threadNumbers.size()) + 1;
+            threadNumbers.insert(event.threadId, tid);
+        }
+        
+        QJsonObject args;
+        if (!event.action.isEmpty()) {
+            args["action"] = event.action;
+        }
+        if (!event.workingDirectory.isEmpty()) {
+            args["workingDirectory"] = event.workingDirectory;
+        }
+        if (!event.arguments.isEmpty()) {
+            args["arguments"] = event.arguments.join(' ');
+        }
+        if (event.spawnUs >= 0) {
+            args["spawnMs"] = event.spawnUs / 1000.0;
+        }
+        if (event.outputBytes >= 0) {
+            args["outputBytes"] = event.outputBytes;
+        }
+        if (event.itemCount >= 0) {
+            args["items"] = event.itemCount;
+        }
+        args["exitCode"] = event.exitCode;
+        args["success"] = event.success;
+        if (!event.error.isEmpty()) {
+            args["error"] = event.error;
+        }
+        
+        QJsonObject trace;
+        trace["name"] = event.name;
+        trace["cat"] = event.category;
+        trace["ph"] = "X";
+        trace["ts"] = event.startUs;
+        trace["dur"] = event.durationUs;
+        trace["pid"] = pid;
+        trace["tid"] = tid;
+        trace["args"] = args;
+        traceEvents.append(trace);
+        
+        if (event.spawnUs > 0) {
+            QJsonObject spawn;
+            spawn["name"] = "spawn";
+            spawn["cat"] = event.category;
+            spawn["ph"] = "X";
+            spawn["ts"] = event.startUs;
+            spawn["dur"] = event.spawnUs;
+            spawn["pid"] = pid;
+            spawn["tid"] = tid;
+            traceEvents.append(spawn);
+        }
+    }
+    
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+bool GitTracer::exportChromeTrace(const QString &filePath, QString *error) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    
+    const QByteArray data = toChromeTrace();
+    if (file.write(data) != data.size()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
+
+QString GitTracer::currentAction()
+{
+    return t_currentAction;
+}
+
+GitTraceAction::GitTraceAction(const QString &action)
+    : m_previous(t_currentAction)
+{
+    if (m_previous.isEmpty()) {
+        t_currentAction = action;
+    }
+}
+
+GitTraceAction::~GitTraceAction()
+{
+    t_currentAction = m_previous;
+}
+
+GitTraceSpan::GitTraceSpan(const QString &category, const QString &name)
+{
+    m_event.category = category;
+    m_event.name = name;
+    m_event.action = GitTracer::currentAction();
+    m_event.startUs = GitTracer::instance()->now();
+}
+
+GitTraceSpan::~GitTraceSpan()
+{
+    m_event.durationUs = GitTracer::instance()->now() - m_event.startUs;
+    GitTracer::instance()->record(m_event);
+}
+
+void GitTraceSpan::setDetail(const QString &detail)
+{
+    m_event.arguments = QStringList(detail);
+}
+
+void GitTraceSpan::setItemCount(qint64 count)
+{
+    m_event.itemCount = count;
+}
+
+GitProcessTrace::GitProcessTrace()
+    : m_active(false)
+{
+}
+
+void GitProcessTrace::begin(const QString &workingDirectory, const QStringList &args, const QString &action)
+{
+    m_event = GitTraceEvent();
+    m_event.category = "git";
+    m_event.name = "git " + commandName(args);
+    m_event.action = action;
+    m_event.workingDirectory = workingDirectory;
+    m_event.arguments = args;
+    m_event.outputBytes = 0;
+    m_event.threadId = currentThreadId();
+    m_event.startUs = GitTracer::instance()->now();
+    m_active = true;
+}
+
+void GitProcessTrace::markStarted()
+{
+    if (m_active && m_event.spawnUs < 0) {
+        m_event.spawnUs = GitTracer::instance()->now() - m_event.startUs;
+    }
+}
+
+void GitProcessTrace::addOutput(qint64 bytes)
+{
+    m_event.outputBytes += bytes;
+}
+
+void GitProcessTrace::finish(int exitCode, bool success, const QString &error)
+{
+    if (!m_active) {
+        return;
+    }
+    
+    m_event.durationUs = GitTracer::instance()->now() - m_event.startUs;
+    m_event.exitCode = exitCode;
+    m_event.success = success;
+    m_event.error = error.trimmed();
+    GitTracer::instance()->record(m_event);
+    m_active = false;
+}
+
+bool GitProcessTrace::isActive() const
+{
+    return m_active;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#ifndef GITTRACER_H
+#define GITTRACER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct GitTraceEvent {
+    quint64 id;
+    QString category;
+    QString name;
+    QString action;
+    QString workingDirectory;
+    QStringList arguments;
+    qint64 startUs;
+    qint64 spawnUs;
+    qint64 durationUs;
+    qint64 outputBytes;
+    qint64 itemCount;
+    int exitCode;
+    bool success;
+    QString error;
+    quint64 threadId;
+    
+    GitTraceEvent();
+};
+
+class GitTracer
+{
+public:
+    static GitTracer *instance();
+    
+    qint64 now() const;
+    void record(GitTraceEvent event);
+    QList<GitTraceEvent> events(quint64 afterId = 0) const;
+    void clear();
+    
+    void setCapacity(int capacity);
+    int capacity() const;
+    
+    QByteArray toChromeTrace() const;
+    bool exportChromeTrace(const QString &filePath, QString *error = nullptr) const;
+    
+    static QString currentAction();
+
+private:
+    GitTracer();
+    
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    QVector<GitTraceEvent> m_buffer;
+    int m_capacity;
+    int m_next;
+    quint64 m_nextId;
+    
+    friend class GitTraceAction;
+};
+
+class GitTraceAction
+{
+public:
+    explicit GitTraceAction(const QString &action);
+    ~GitTraceAction();
+
+private:
+    QString m_previous;
+};
+
+class GitTraceSpan
+{
+public:
+    GitTraceSpan(const QString &category, const QString &name);
+    ~GitTraceSpan();
+    
+    void setDetail(const QString &detail);
+    void setItemCount(qint64 count);
+
+private:
+    GitTraceEvent m_event;
+};
+
+class GitProcessTrace
+{
+public:
+    GitProcessTrace();
+    
+    void begin(const QString &workingDirectory, const QStringList &args, const QString &action = GitTracer::currentAction());
+    void markStarted();
+    void addOutput(qint64 bytes);
+    void finish(int exitCode, bool success, const QString &error = QString());
+    bool isActive() const;
+
+private:
+    GitTraceEvent m_event;
+    bool m_active;
+};
+
+#endif // GITTRACER_H
\ No newline at end of file
@@ -1,16 +1,21 @@
 #include <QApplication>
 #include "mainwindow.h"
+#include "startupprofiler.h"
 
 int main(int argc, char *argv[])
 {
+    StartupProfiler::instance()->start();
+    
     QApplication app(argc, argv);
     
     app.setApplicationName("Srikok Git");
     app.setApplicationVersion("1.0.0");
     app.setOrganizationName("Srikoksoft");
     app.setOrganizationDomain("srikoksoft.com");
+    StartupProfiler::instance()->mark("Application setup");
     
     MainWindow window;
+    StartupProfiler::instance()->mark("Main window construction");
     window.show();
     
     return app.exec();
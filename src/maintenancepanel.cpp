@@ -0,0 +1,180 @@
+#include "maintenancepanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLocale>
+#include <QSettings>
+
+namespace {
+
+enum Column {
+    TaskColumn,
+    LastRunColumn,
+    NextDueColumn,
+    FailuresColumn,
+    StateColumn,
+    ColumnCount
+};
+
+QString formatTime(const QDateTime &time)
+{
+    return time.isValid() ? time.toLocalTime().toString("yyyy-MM-dd HH:mm") : "Never";
+}
+
+QString formatChange(qint64 before, qint64 after)
+{
+    if (before <= 0) {
+        return QString("%1 ms -> %2 ms").arg(before).arg(after);
+    }
+    return QString("%1 ms -> %2 ms (%3%)")
+        .arg(before)
+        .arg(after)
+        .arg(QString::number((after - before) * 100.0 / before, 'f', 0));
+}
+
+}
+
+MaintenancePanel::MaintenancePanel(RepositoryMaintenance *maintenance, QWidget *parent)
+    : QWidget(parent)
+    , m_maintenance(maintenance)
+    , m_healthLabel(nullptr)
+    , m_warningLabel(nullptr)
+    , m_timingLabel(nullptr)
+    , m_taskTree(nullptr)
+    , m_idleCheck(nullptr)
+    , m_runButton(nullptr)
+    , m_cancelButton(nullptr)
+{
+    setupUI();
+    
+    connect(m_maintenance, &RepositoryMaintenance::healthChanged, this, &MaintenancePanel::onHealthChanged);
+    connect(m_maintenance, &RepositoryMaintenance::taskStarted, this, &MaintenancePanel::onTaskStarted);
+    connect(m_maintenance, &RepositoryMaintenance::taskFinished, this, &MaintenancePanel::onTaskFinished);
+    connect(m_maintenance, &RepositoryMaintenance::timingsMeasured, this, &MaintenancePanel::onTimingsMeasured);
+    connect(m_maintenance, &RepositoryMaintenance::runStarted, this, &MaintenancePanel::updateButtons);
+    connect(m_maintenance, &RepositoryMaintenance::runFinished, this, &MaintenancePanel::updateButtons);
+    
+    onHealthChanged(m_maintenance->health());
+    if (m_maintenance->timingBefore().isValid() && m_maintenance->timingAfter().isValid()) {
+        onTimingsMeasured(m_maintenance->timingBefore(), m_maintenance->timingAfter());
+    }
+    updateButtons();
+}
+
+void MaintenancePanel::setupUI()
+{
+    setWindowTitle("Maintenance");
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    m_healthLabel = new QLabel;
+    m_healthLabel->setWordWrap(true);
+    m_warningLabel = new QLabel;
+    m_warningLabel->setWordWrap(true);
+    m_warningLabel->setStyleSheet("color: #b35900;");
+    m_timingLabel = new QLabel("No maintenance run measured yet");
+    m_timingLabel->setWordWrap(true);
+    
+    m_taskTree = new QTreeWidget;
+    m_taskTree->setColumnCount(ColumnCount);
+    m_taskTree->setHeaderLabels({"Task", "Last Run", "Next Due", "Failures", "State"});
+    m_taskTree->setRootIsDecorated(false);
+    m_taskTree->setUniformRowHeights(true);
+    m_taskTree->header()->setSectionResizeMode(StateColumn, QHeaderView::Stretch);
+    for (int i = 0; i < RepositoryMaintenance::TaskCount; ++i) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(m_taskTree);
+        item->setText(TaskColumn, RepositoryMaintenance::taskName(RepositoryMaintenance::Task(i)));
+        updateTask(RepositoryMaintenance::Task(i));
+    }
+    
+    QHBoxLayout *buttonLayout = new QHBoxLayout;
+    m_idleCheck = new QCheckBox("Run when idle");
+    m_idleCheck->setChecked(m_maintenance->isEnabled());
+    m_runButton = new QPushButton("Run Now");
+    m_cancelButton = new QPushButton("Cancel");
+    buttonLayout->addWidget(m_idleCheck);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_runButton);
+    buttonLayout->addWidget(m_cancelButton);
+    
+    layout->addWidget(m_healthLabel);
+    layout->addWidget(m_warningLabel);
+    layout->addWidget(m_taskTree);
+    layout->addWidget(m_timingLabel);
+    layout->addLayout(buttonLayout);
+    
+    connect(m_runButton, &QPushButton::clicked, m_maintenance, &RepositoryMaintenance::runNow);
+    connect(m_cancelButton, &QPushButton::clicked, m_maintenance, &RepositoryMaintenance::cancel);
+    connect(m_idleCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        QSettings().setValue("maintenance/runWhenIdle", checked);
+        m_maintenance->setEnabled(checked);
+    });
+}
+
+void MaintenancePanel::onHealthChanged(const RepositoryHealth &health)
+{
+    for (int i = 0; i < RepositoryMaintenance::TaskCount; ++i) {
+        updateTask(RepositoryMaintenance::Task(i));
+    }
+    
+    if (!health.valid) {
+        m_healthLabel->setText(m_maintenance->repository().isEmpty() ? "No repository open" : "Checking repository health...");
+        m_warningLabel->hide();
+        return;
+    }
+    
+    const QLocale locale;
+    m_healthLabel->setText(QString("%1 loose objects (%2), %3 packs (%4), index %5, %6 loose refs, commit-graph %7, multi-pack-index %8")
+        .arg(locale.toString(health.looseObjects))
+        .arg(locale.formattedDataSize(health.looseBytes))
+        .arg(health.packCount)
+        .arg(locale.formattedDataSize(health.packBytes))
+        .arg(locale.formattedDataSize(health.indexBytes))
+        .arg(locale.toString(health.looseRefs))
+        .arg(health.hasCommitGraph ? "present" : "missing")
+        .arg(health.hasMultiPackIndex ? "present" : "missing"));
+    
+    const QStringList warnings = health.warnings();
+    m_warningLabel->setText(warnings.join("\n"));
+    m_warningLabel->setVisible(!warnings.isEmpty());
+}
+
+void MaintenancePanel::onTaskStarted(RepositoryMaintenance::Task task)
+{
+    updateTask(task, "Running...");
+}
+
+void MaintenancePanel::onTaskFinished(RepositoryMaintenance::Task task, bool success, qint64 elapsedMs)
+{
+    updateTask(task, success ? QString("Done in %1 ms").arg(elapsedMs) : "Failed: " + m_maintenance->lastError(task));
+}
+
+void MaintenancePanel::onTimingsMeasured(const MaintenanceTiming &before, const MaintenanceTiming &after)
+{
+    m_timingLabel->setText(QString("Status: %1\nLog: %2")
+        .arg(formatChange(before.statusMs, after.statusMs), formatChange(before.logMs, after.logMs)));
+}
+
+void MaintenancePanel::updateButtons()
+{
+    const bool running = m_maintenance->isRunning();
+    m_runButton->setEnabled(!running && !m_maintenance->repository().isEmpty());
+    m_cancelButton->setEnabled(running);
+}
+
+void MaintenancePanel::updateTask(RepositoryMaintenance::Task task, const QString &state)
+{
+    QTreeWidgetItem *item = m_taskTree->topLevelItem(task);
+    if (!item) {
+        return;
+    }
+    
+    item->setText(LastRunColumn, formatTime(m_maintenance->lastRun(task)));
+    item->setText(NextDueColumn, m_maintenance->nextDue(task).isValid() ? formatTime(m_maintenance->nextDue(task)) : "Now");
+    item->setText(FailuresColumn, QString::number(m_maintenance->failureCount(task)));
+    if (!state.isEmpty()) {
+        item->setText(StateColumn, state);
+    } else if (item->text(StateColumn).isEmpty() && !m_maintenance->lastError(task).isEmpty()) {
+        item->setText(StateColumn, "Failed: " + m_maintenance->lastError(task));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#ifndef MAINTENANCEPANEL_H
+#define MAINTENANCEPANEL_H
+
+#include <QWidget>
+#include <QTreeWidget>
+#include <QPushButton>
+#include <QCheckBox>
+#include <QLabel>
+#include "repositorymaintenance.h"
+
+class MaintenancePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MaintenancePanel(RepositoryMaintenance *maintenance, QWidget *parent = nullptr);
+
+private slots:
+    void onHealthChanged(const RepositoryHealth &health);
+    void onTaskStarted(RepositoryMaintenance::Task task);
+    void onTaskFinished(RepositoryMaintenance::Task task, bool success, qint64 elapsedMs);
+    void onTimingsMeasured(const MaintenanceTiming &before, const MaintenanceTiming &after);
+    void updateButtons();
+
+private:
+    void setupUI();
+    void updateTask(RepositoryMaintenance::Task task, const QString &state = QString());
+    
+    RepositoryMaintenance *m_maintenance;
+    QLabel *m_healthLabel;
+    QLabel *m_warningLabel;
+    QLabel *m_timingLabel;
+    QTreeWidget *m_taskTree;
+    QCheckBox *m_idleCheck;
+    QPushButton *m_runButton;
+    QPushButton *m_cancelButton;
+};
+
+#endif // MAINTENANCEPANEL_H
\ No newline at end of file
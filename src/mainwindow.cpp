@@ -6,7 +6,20 @@
 #include "branchmanager.h"
 #include "remotemanager.h"
 #include "diffviewer.h"
+#include "fileviewer.h"
 #include "settings.h"
+#include "sparsecheckoutdialog.h"
+#include "workspacepanel.h"
+#include "performancepanel.h"
+#include "analyticsdashboard.h"
+#include "repositorysizepanel.h"
+#include "repositorymaintenance.h"
+#include "maintenancepanel.h"
+#include "tagpanel.h"
+#include "gittracer.h"
+#include "sessionsnapshot.h"
+#include "startupprofiler.h"
+#include "gitfsmonitor.h"
 
 #include <QApplication>
 #include <QMenuBar>
@@ -22,6 +35,18 @@
 #include <QDialogButtonBox>
 #include <QLabel>
 #include <QLineEdit>
+#include <QPushButton>
+#include <QGroupBox>
+#include <QFormLayout>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QCheckBox>
+#include <QDir>
+#include <QRegularExpression>
+#include <QSettings>
+#include <QTimer>
+#include <QShowEvent>
+#include <QCloseEvent>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -33,19 +58,47 @@ MainWindow::MainWindow(QWidget *parent)
     , m_commitHistory(nullptr)
     , m_stagingArea(nullptr)
     , m_diffViewer(nullptr)
+    , m_workspacePanel(nullptr)
+    , m_workspaceDock(nullptr)
+    , m_performancePanel(nullptr)
+    , m_performanceDock(nullptr)
+    , m_maintenancePanel(nullptr)
+    , m_maintenanceDock(nullptr)
+    , m_tagPanel(nullptr)
+    , m_tagDock(nullptr)
     , m_gitManager(nullptr)
+    , m_maintenance(nullptr)
     , m_branchManager(nullptr)
     , m_remoteManager(nullptr)
     , m_settings(nullptr)
+    , m_sparseCheckoutDialog(nullptr)
+    , m_analyticsDashboard(nullptr)
+    , m_repositorySizePanel(nullptr)
+    , m_fsMonitorAction(nullptr)
+    , m_analyticsAction(nullptr)
+    , m_repositorySizeAction(nullptr)
+    , m_statusTimingLabel(nullptr)
+    , m_healthLabel(nullptr)
+    , m_remoteProgress(nullptr)
+    , m_remoteRateLabel(nullptr)
+    , m_remoteCancelButton(nullptr)
+    , m_remoteJobId(0)
+    , m_sessionRestoreScheduled(false)
+    , m_awaitingFreshData(false)
 {
     setWindowTitle("Srikok Git - Git Repository Manager");
     setWindowIcon(QIcon(":/icons/app.png"));
     resize(1200, 800);
     
     m_gitManager = new GitManager(this);
-    m_branchManager = new BranchManager(m_gitManager, this);
-    m_remoteManager = new RemoteManager(m_gitManager, this);
-    m_settings = new Settings(this);
+    
+    QSettings settings;
+    m_gitManager->scheduler()->setMaxConcurrent(settings.value("scheduler/maxConcurrent", 6).toInt());
+    m_gitManager->scheduler()->setMaxConcurrentPerRepository(settings.value("scheduler/maxConcurrentPerRepository", 3).toInt());
+    
+    m_maintenance = new RepositoryMaintenance(m_gitManager->scheduler(), this);
+    m_maintenance->setEnabled(settings.value("maintenance/runWhenIdle", true).toBool());
+    qApp->installEventFilter(this);
     
     setupUI();
     setupMenus();
@@ -57,6 +110,95 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    qApp->removeEventFilter(this);
+}
+
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    
+    if (!m_sessionRestoreScheduled) {
+        m_sessionRestoreScheduled = true;
+        QTimer::singleShot(0, this, &MainWindow::restoreSession);
+    }
+}
+
+void MainWindow::closeEvent(QCloseEvent *event)
+{
+    saveSession();
+    QMainWindow::closeEvent(event);
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::Wheel:
+        m_maintenance->notifyActivity();
+        break;
+    default:
+        break;
+    }
+    return QMainWindow::eventFilter(watched, event);
+}
+
+void MainWindow::restoreSession()
+{
+    StartupProfiler::instance()->mark("First paint");
+    
+    QSettings settings;
+    const SessionSnapshot snapshot = settings.value("session/restoreLastRepository", true).toBool()
+        ? SessionSnapshot::load() : SessionSnapshot();
+    
+    GitTraceAction action("Restore session");
+    
+    if (!snapshot.isValid() || !m_gitManager->openRepository(snapshot.repositoryPath)) {
+        StartupProfiler::instance()->finish();
+        return;
+    }
+    
+    m_repositoryBrowser->showFiles(snapshot.files);
+    m_stagingArea->showFiles(snapshot.files);
+    m_commitHistory->showCommits(snapshot.commits);
+    m_repoLabel->setText(snapshot.repositoryPath);
+    m_branchLabel->setText("Branch: " + m_gitManager->getCurrentBranch());
+    m_statusLabel->setText(QString("Showing snapshot from %1, refreshing...")
+        .arg(snapshot.savedAt.toLocalTime().toString("yyyy-MM-dd hh:mm")));
+    if (m_workspacePanel) {
+        m_workspacePanel->setActiveRepository(snapshot.repositoryPath);
+    }
+    StartupProfiler::instance()->mark("Snapshot rendered");
+    
+    m_awaitingFreshData = true;
+}
+
+void MainWindow::onRepositoryRefreshed()
+{
+    if (!m_awaitingFreshData) {
+        return;
+    }
+    
+    m_awaitingFreshData = false;
+    StartupProfiler::instance()->mark("Fresh data loaded");
+    StartupProfiler::instance()->finish();
+    m_statusLabel->setText(QString("Repository restored in %1 ms").arg(StartupProfiler::instance()->elapsedMs()));
+    m_statusLabel->setToolTip(StartupProfiler::instance()->summary());
+}
+
+void MainWindow::saveSession() const
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        SessionSnapshot::remove();
+        return;
+    }
+    
+    SessionSnapshot snapshot;
+    snapshot.repositoryPath = m_gitManager->getRepositoryPath();
+    snapshot.branch = m_gitManager->getCurrentBranch();
+    snapshot.files = m_repositoryBrowser->files();
+    snapshot.commits = m_commitHistory->commits();
+    snapshot.save();
 }
 
 void MainWindow::setupUI()
@@ -88,6 +230,118 @@ void MainWindow::setupUI()
     QVBoxLayout *layout = new QVBoxLayout;
     layout->addWidget(m_mainSplitter);
     m_centralWidget->setLayout(layout);
+    
+    m_workspaceDock = new QDockWidget("Workspace", this);
+    m_workspaceDock->setObjectName("WorkspaceDock");
+    addDockWidget(Qt::LeftDockWidgetArea, m_workspaceDock);
+    connect(m_workspaceDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) {
+            createWorkspacePanel();
+        }
+    });
+    
+    m_performanceDock = new QDockWidget("Performance", this);
+    m_performanceDock->setObjectName("PerformanceDock");
+    addDockWidget(Qt::BottomDockWidgetArea, m_performanceDock);
+    m_performanceDock->hide();
+    connect(m_performanceDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) {
+            createPerformancePanel();
+        }
+    });
+    
+    m_maintenanceDock = new QDockWidget("Maintenance", this);
+    m_maintenanceDock->setObjectName("MaintenanceDock");
+    addDockWidget(Qt::BottomDockWidgetArea, m_maintenanceDock);
+    m_maintenanceDock->hide();
+    connect(m_maintenanceDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) {
+            createMaintenancePanel();
+        }
+    });
+    
+    m_tagDock = new QDockWidget("Tags", this);
+    m_tagDock->setObjectName("TagDock");
+    addDockWidget(Qt::RightDockWidgetArea, m_tagDock);
+    m_tagDock->hide();
+    connect(m_tagDock, &QDockWidget::visibilityChanged, this, [this](bool visible) {
+        if (visible) {
+            createTagPanel();
+        }
+    });
+}
+
+void MainWindow::createWorkspacePanel()
+{
+    if (m_workspacePanel) {
+        return;
+    }
+    
+    m_workspacePanel = new WorkspacePanel(m_gitManager->scheduler(), this);
+    m_workspaceDock->setWidget(m_workspacePanel);
+    connect(m_workspacePanel, &WorkspacePanel::repositoryActivated, this, &MainWindow::openRepositoryPath);
+    
+    if (m_gitManager->isRepositoryOpen()) {
+        m_workspacePanel->setActiveRepository(m_gitManager->getRepositoryPath());
+    }
+}
+
+void MainWindow::createPerformancePanel()
+{
+    if (m_performancePanel) {
+        return;
+    }
+    
+    m_performancePanel = new PerformancePanel(this);
+    m_performanceDock->setWidget(m_performancePanel);
+}
+
+void MainWindow::createMaintenancePanel()
+{
+    if (m_maintenancePanel) {
+        return;
+    }
+    
+    m_maintenancePanel = new MaintenancePanel(m_maintenance, this);
+    m_maintenanceDock->setWidget(m_maintenancePanel);
+}
+
+void MainWindow::createTagPanel()
+{
+    if (m_tagPanel) {
+        return;
+    }
+    
+    m_tagPanel = new TagPanel(m_gitManager, this);
+    m_tagDock->setWidget(m_tagPanel);
+}
+
+BranchManager *MainWindow::branchManager()
+{
+    if (!m_branchManager) {
+        m_branchManager = new BranchManager(m_gitManager, this);
+    }
+    return m_branchManager;
+}
+
+RemoteManager *MainWindow::remoteManager()
+{
+    if (!m_remoteManager) {
+        m_remoteManager = new RemoteManager(m_gitManager, this);
+        connect(m_remoteManager, &RemoteManager::jobStarted, this, &MainWindow::onRemoteJobStarted);
+        connect(m_remoteManager, &RemoteManager::jobProgress, this, &MainWindow::onRemoteJobProgress);
+        connect(m_remoteManager, &RemoteManager::jobFinished, this, &MainWindow::onRemoteJobFinished);
+        connect(m_remoteManager, &RemoteManager::cloneFinished, this, &MainWindow::onCloneFinished);
+    }
+    return m_remoteManager;
+}
+
+Settings *MainWindow::settingsDialog()
+{
+    if (!m_settings) {
+        m_settings = new Settings(this);
+    }
+    return m_settings;
 }
 
 void MainWindow::setupMenus()
@@ -101,6 +355,11 @@ void MainWindow::setupMenus()
     QMenu *viewMenu = menuBar->addMenu("&View");
     QMenu *helpMenu = menuBar->addMenu("&Help");
     
+    viewMenu->addAction(m_workspaceDock->toggleViewAction());
+    viewMenu->addAction(m_performanceDock->toggleViewAction());
+    viewMenu->addAction(m_maintenanceDock->toggleViewAction());
+    viewMenu->addAction(m_tagDock->toggleViewAction());
+    
     m_openAction = new QAction("&Open Repository...", this);
     m_openAction->setShortcut(QKeySequence::Open);
     m_openAction->setStatusTip("Open an existing Git repository");
@@ -113,6 +372,36 @@ void MainWindow::setupMenus()
     m_refreshAction->setShortcut(QKeySequence::Refresh);
     m_refreshAction->setStatusTip("Refresh repository status");
     
+    m_sparseAction = new QAction("&Sparse Checkout...", this);
+    m_sparseAction->setStatusTip("Choose which top-level directories are checked out");
+    
+    m_analyticsAction = new QAction("Repository &Analytics...", this);
+    m_analyticsAction->setStatusTip("Show churn, author and activity statistics for the current branch");
+    
+    m_repositorySizeAction = new QAction("Analyze Repository &Size...", this);
+    m_repositorySizeAction->setStatusTip("Find the blobs, paths and directories that take the most space");
+    
+    m_fsMonitorAction = new QAction("Use File System &Monitor", this);
+    m_fsMonitorAction->setCheckable(true);
+    m_fsMonitorAction->setEnabled(GitFsMonitor::isSupported());
+    m_fsMonitorAction->setStatusTip("Let git status ask an inotify monitor which files changed instead of scanning the working tree");
+    
+    m_branchesAction = new QAction("&Manage Branches...", this);
+    m_branchesAction->setShortcut(QKeySequence("Ctrl+B"));
+    m_branchesAction->setStatusTip("Create, switch, merge and delete branches");
+    
+    m_fetchAction = new QAction("&Fetch", this);
+    m_fetchAction->setStatusTip("Fetch from a remote in the background");
+    
+    m_fetchAllAction = new QAction("Fetch &All Remotes", this);
+    m_fetchAllAction->setStatusTip("Fetch every remote in parallel");
+    
+    m_pullAction = new QAction("P&ull", this);
+    m_pullAction->setStatusTip("Pull the current branch from a remote in the background");
+    
+    m_pushAction = new QAction("P&ush", this);
+    m_pushAction->setStatusTip("Push the current branch to a remote in the background");
+    
     m_settingsAction = new QAction("&Settings...", this);
     m_settingsAction->setShortcut(QKeySequence::Preferences);
     m_settingsAction->setStatusTip("Configure application settings");
@@ -132,6 +421,18 @@ void MainWindow::setupMenus()
     fileMenu->addAction(m_exitAction);
     
     repositoryMenu->addAction(m_refreshAction);
+    repositoryMenu->addSeparator();
+    repositoryMenu->addAction(m_sparseAction);
+    repositoryMenu->addAction(m_fsMonitorAction);
+    repositoryMenu->addAction(m_analyticsAction);
+    repositoryMenu->addAction(m_repositorySizeAction);
+    
+    branchMenu->addAction(m_branchesAction);
+    
+    remoteMenu->addAction(m_fetchAction);
+    remoteMenu->addAction(m_fetchAllAction);
+    remoteMenu->addAction(m_pullAction);
+    remoteMenu->addAction(m_pushAction);
     
     helpMenu->addAction(m_aboutAction);
 }
@@ -143,6 +444,10 @@ void MainWindow::setupToolbar()
     mainToolBar->addAction(m_cloneAction);
     mainToolBar->addSeparator();
     mainToolBar->addAction(m_refreshAction);
+    mainToolBar->addSeparator();
+    mainToolBar->addAction(m_fetchAction);
+    mainToolBar->addAction(m_pullAction);
+    mainToolBar->addAction(m_pushAction);
 }
 
 void MainWindow::setupStatusBar()
@@ -150,8 +455,30 @@ void MainWindow::setupStatusBar()
     m_statusLabel = new QLabel("Ready");
     m_branchLabel = new QLabel("No repository");
     m_repoLabel = new QLabel("");
+    m_statusTimingLabel = new QLabel;
+    m_statusTimingLabel->hide();
+    m_healthLabel = new QLabel;
+    m_healthLabel->setStyleSheet("color: #b35900;");
+    m_healthLabel->hide();
+    
+    m_remoteProgress = new QProgressBar;
+    m_remoteProgress->setMaximumWidth(300);
+    m_remoteProgress->setTextVisible(true);
+    m_remoteProgress->hide();
+    
+    m_remoteRateLabel = new QLabel;
+    m_remoteRateLabel->hide();
+    
+    m_remoteCancelButton = new QToolButton;
+    m_remoteCancelButton->setText("Cancel");
+    m_remoteCancelButton->hide();
     
     statusBar()->addWidget(m_statusLabel);
+    statusBar()->addWidget(m_remoteProgress);
+    statusBar()->addWidget(m_remoteRateLabel);
+    statusBar()->addWidget(m_remoteCancelButton);
+    statusBar()->addPermanentWidget(m_healthLabel);
+    statusBar()->addPermanentWidget(m_statusTimingLabel);
     statusBar()->addPermanentWidget(m_branchLabel);
     statusBar()->addPermanentWidget(m_repoLabel);
 }
@@ -165,27 +492,86 @@ void MainWindow::connectSignals()
     connect(m_openAction, &QAction::triggered, this, &MainWindow::openRepository);
     connect(m_cloneAction, &QAction::triggered, this, &MainWindow::cloneRepository);
     connect(m_refreshAction, &QAction::triggered, this, &MainWindow::refreshRepository);
+    connect(m_branchesAction, &QAction::triggered, this, &MainWindow::manageBranches);
+    connect(m_sparseAction, &QAction::triggered, this, &MainWindow::manageSparseCheckout);
+    connect(m_fsMonitorAction, &QAction::triggered, this, &MainWindow::toggleFsMonitor);
+    connect(m_analyticsAction, &QAction::triggered, this, &MainWindow::showAnalytics);
+    connect(m_repositorySizeAction, &QAction::triggered, this, &MainWindow::showRepositorySize);
+    connect(m_fetchAction, &QAction::triggered, this, &MainWindow::fetchRemote);
+    connect(m_fetchAllAction, &QAction::triggered, this, &MainWindow::fetchAllRemotes);
+    connect(m_pullAction, &QAction::triggered, this, &MainWindow::pullRemote);
+    connect(m_pushAction, &QAction::triggered, this, &MainWindow::pushRemote);
+    connect(m_remoteCancelButton, &QToolButton::clicked, this, &MainWindow::cancelRemoteOperation);
     connect(m_settingsAction, &QAction::triggered, this, &MainWindow::showSettings);
     connect(m_aboutAction, &QAction::triggered, this, &MainWindow::showAbout);
     connect(m_exitAction, &QAction::triggered, this, &QWidget::close);
+    connect(m_repositoryBrowser, &RepositoryBrowser::refreshed, this, &MainWindow::onRepositoryRefreshed);
+    connect(m_repositoryBrowser, &RepositoryBrowser::fileSelected, m_diffViewer, &DiffViewer::showFileDiff);
+    connect(m_repositoryBrowser, &RepositoryBrowser::fileViewRequested, this, &MainWindow::openFileViewer);
+    connect(m_repositoryBrowser, &RepositoryBrowser::submoduleOpenRequested, this, &MainWindow::openRepositoryPath);
+    connect(m_gitManager, &GitManager::repositoryChanged, this, &MainWindow::onRepositoryStateChanged);
+    connect(m_gitManager, &GitManager::fileStatusChanged, this, &MainWindow::onRepositoryStateChanged);
+    connect(m_gitManager, &GitManager::branchChanged, this, &MainWindow::onBranchChanged);
+    connect(m_gitManager, &GitManager::remoteRefsChanged, this, &MainWindow::onRepositoryStateChanged);
+    connect(m_gitManager, &GitManager::fsMonitorStateChanged, this, &MainWindow::onFsMonitorStateChanged);
+    connect(m_gitManager, &GitManager::fileStatusTimed, this, &MainWindow::onFileStatusTimed);
+    connect(m_maintenance, &RepositoryMaintenance::healthChanged, this, &MainWindow::onRepositoryHealthChanged);
 }
 
 void MainWindow::openRepository()
 {
     QString dir = QFileDialog::getExistingDirectory(this, "Open Git Repository", QString(), QFileDialog::ShowDirsOnly);
     if (!dir.isEmpty()) {
-        if (m_gitManager->openRepository(dir)) {
-            m_statusLabel->setText("Repository opened: " + dir);
-            m_repoLabel->setText(dir);
-            refreshRepository();
-        } else {
-            QMessageBox::warning(this, "Error", "Failed to open repository. Not a valid Git repository.");
+        openRepositoryPath(dir);
+    }
+}
+
+void MainWindow::openRepositoryPath(const QString &path)
+{
+    GitTraceAction action("Open repository");
+    
+    if (m_gitManager->openRepository(path)) {
+        m_statusLabel->setText("Repository opened: " + path);
+        m_repoLabel->setText(path);
+        if (m_workspacePanel) {
+            m_workspacePanel->setActiveRepository(path);
         }
+        m_branchLabel->setText("Branch: " + m_gitManager->getCurrentBranch());
+    } else {
+        QMessageBox::warning(this, "Error", "Failed to open repository. Not a valid Git repository.");
+    }
+}
+
+void MainWindow::onRepositoryStateChanged()
+{
+    GitTraceAction action("Repository changed");
+    
+    if (m_gitManager->isRepositoryOpen() && m_workspacePanel) {
+        m_workspacePanel->pollNow(QDir(m_gitManager->getRepositoryPath()).absolutePath());
+    }
+    
+    if (m_gitManager->isRepositoryOpen()) {
+        m_maintenance->setRepository(m_gitManager->getRepositoryPath());
     }
 }
 
+void MainWindow::onBranchChanged()
+{
+    if (m_gitManager->isRepositoryOpen()) {
+        m_branchLabel->setText("Branch: " + m_gitManager->getCurrentBranch());
+    }
+    onRepositoryStateChanged();
+}
+
 void MainWindow::cloneRepository()
 {
+    GitTraceAction action("Clone");
+    
+    if (remoteManager()->isRunning(m_remoteJobId)) {
+        QMessageBox::information(this, "Clone Repository", "Another remote operation is still running.");
+        return;
+    }
+    
     QDialog dialog(this);
     dialog.setWindowTitle("Clone Repository");
     dialog.setMinimumWidth(500);
@@ -199,28 +585,113 @@ void MainWindow::cloneRepository()
     urlEdit->setMinimumWidth(450);
     layout->addWidget(urlEdit);
     
+    QLabel *pathLabel = new QLabel("Clone into:");
+    layout->addWidget(pathLabel);
+    
+    QHBoxLayout *pathLayout = new QHBoxLayout;
+    QLineEdit *pathEdit = new QLineEdit();
+    QPushButton *browseButton = new QPushButton("Browse...");
+    pathLayout->addWidget(pathEdit);
+    pathLayout->addWidget(browseButton);
+    layout->addLayout(pathLayout);
+    
+    connect(browseButton, &QPushButton::clicked, &dialog, [&dialog, pathEdit]() {
+        QString dir = QFileDialog::getExistingDirectory(&dialog, "Choose Clone Directory", pathEdit->text(), QFileDialog::ShowDirsOnly);
+        if (!dir.isEmpty()) {
+            pathEdit->setText(dir);
+        }
+    });
+    
+    QGroupBox *optionsGroup = new QGroupBox("Options");
+    QFormLayout *optionsLayout = new QFormLayout(optionsGroup);
+    
+    QLineEdit *branchEdit = new QLineEdit();
+    branchEdit->setPlaceholderText("Default branch");
+    optionsLayout->addRow("Branch:", branchEdit);
+    
+    QSpinBox *depthSpin = new QSpinBox();
+    depthSpin->setRange(0, 1000000);
+    depthSpin->setSpecialValueText("Full history");
+    optionsLayout->addRow("Depth:", depthSpin);
+    
+    QComboBox *filterCombo = new QComboBox();
+    filterCombo->addItem("None", QString());
+    filterCombo->addItem("Blobless (blob:none)", QString("blob:none"));
+    filterCombo->addItem("Treeless (tree:0)", QString("tree:0"));
+    optionsLayout->addRow("Partial clone:", filterCombo);
+    
+    QCheckBox *singleBranchCheck = new QCheckBox("Fetch only the selected branch");
+    optionsLayout->addRow("Single branch:", singleBranchCheck);
+    
+    QLineEdit *sparseEdit = new QLineEdit();
+    sparseEdit->setPlaceholderText("e.g. src docs/api (empty for full checkout)");
+    optionsLayout->addRow("Sparse directories:", sparseEdit);
+    
+    layout->addWidget(optionsGroup);
+    
     QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
     layout->addWidget(buttonBox);
     
     connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
     connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
     
-    if (dialog.exec() == QDialog::Accepted && !urlEdit->text().isEmpty()) {
-        QString url = urlEdit->text();
-        QString dir = QFileDialog::getExistingDirectory(this, "Choose Clone Directory", QString(), QFileDialog::ShowDirsOnly);
-        if (!dir.isEmpty()) {
-            if (m_gitManager->cloneRepository(url, dir)) {
-                m_statusLabel->setText("Repository cloned: " + url);
-                openRepository();
-            } else {
-                QMessageBox::warning(this, "Error", "Failed to clone repository.");
-            }
+    if (dialog.exec() != QDialog::Accepted || urlEdit->text().trimmed().isEmpty()) {
+        return;
+    }
+    
+    QString dir = pathEdit->text().trimmed();
+    if (dir.isEmpty()) {
+        dir = QFileDialog::getExistingDirectory(this, "Choose Clone Directory", QString(), QFileDialog::ShowDirsOnly);
+        if (dir.isEmpty()) {
+            return;
         }
     }
+    
+    GitCloneOptions options;
+    options.url = urlEdit->text().trimmed();
+    options.path = QDir(dir).absolutePath();
+    options.branch = branchEdit->text().trimmed();
+    options.depth = depthSpin->value();
+    options.filter = filterCombo->currentData().toString();
+    options.singleBranch = singleBranchCheck->isChecked();
+    options.sparseDirectories = sparseEdit->text().split(QRegularExpression("[\\s,]+"), Qt::SkipEmptyParts);
+    
+    m_remoteJobId = remoteManager()->startClone(options);
+}
+
+void MainWindow::onCloneFinished(int jobId, bool success, const QString &path, qint64 elapsedMs, qint64 diskBytes, const QString &message)
+{
+    Q_UNUSED(jobId);
+    Q_UNUSED(message);
+    
+    if (!success) {
+        return;
+    }
+    
+    const QString summary = QString("Cloned in %1 s, %2 on disk")
+        .arg(elapsedMs / 1000.0, 0, 'f', 1)
+        .arg(GitProgressParser::formatBytes(diskBytes));
+    
+    openRepositoryPath(path);
+    
+    m_statusLabel->setText("Repository cloned: " + summary);
+    QMessageBox::information(this, "Clone Complete", path + "\n\n" + summary);
+}
+
+void MainWindow::openFileViewer(const QString &filePath, const QString &revision)
+{
+    FileViewer *viewer = new FileViewer(m_gitManager, this);
+    viewer->setWindowFlag(Qt::Window);
+    viewer->setAttribute(Qt::WA_DeleteOnClose);
+    viewer->resize(900, 700);
+    viewer->show();
+    viewer->openFile(filePath, revision);
 }
 
 void MainWindow::refreshRepository()
 {
+    GitTraceAction action("Refresh");
+    
     if (m_gitManager->isRepositoryOpen()) {
         m_repositoryBrowser->refresh();
         m_commitHistory->refresh();
@@ -232,9 +703,262 @@ void MainWindow::refreshRepository()
     }
 }
 
+void MainWindow::manageBranches()
+{
+    GitTraceAction action("Manage branches");
+    
+    if (!m_gitManager->isRepositoryOpen()) {
+        QMessageBox::information(this, "Branches", "Open a repository first.");
+        return;
+    }
+    
+    branchManager()->showBranchDialog();
+    refreshRepository();
+}
+
+void MainWindow::manageSparseCheckout()
+{
+    GitTraceAction action("Sparse checkout");
+    
+    if (!m_gitManager->isRepositoryOpen()) {
+        QMessageBox::information(this, "Sparse Checkout", "Open a repository first.");
+        return;
+    }
+    
+    if (!m_sparseCheckoutDialog) {
+        m_sparseCheckoutDialog = new SparseCheckoutDialog(m_gitManager, this);
+    }
+    
+    m_sparseCheckoutDialog->reload();
+    m_sparseCheckoutDialog->exec();
+}
+
+void MainWindow::showAnalytics()
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        QMessageBox::information(this, "Repository Analytics", "Open a repository first.");
+        return;
+    }
+    
+    if (!m_analyticsDashboard) {
+        m_analyticsDashboard = new AnalyticsDashboard(m_gitManager, this);
+        m_analyticsDashboard->setWindowFlag(Qt::Window);
+        m_analyticsDashboard->resize(900, 600);
+    }
+    
+    m_analyticsDashboard->show();
+    m_analyticsDashboard->raise();
+    m_analyticsDashboard->refresh();
+}
+
+void MainWindow::showRepositorySize()
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        QMessageBox::information(this, "Repository Size", "Open a repository first.");
+        return;
+    }
+    
+    if (!m_repositorySizePanel) {
+        m_repositorySizePanel = new RepositorySizePanel(m_gitManager, this);
+        m_repositorySizePanel->setWindowFlag(Qt::Window);
+        m_repositorySizePanel->resize(1000, 650);
+    }
+    
+    m_repositorySizePanel->show();
+    m_repositorySizePanel->raise();
+    m_repositorySizePanel->analyze();
+}
+
+void MainWindow::toggleFsMonitor(bool enabled)
+{
+    GitTraceAction action(enabled ? "Enable file system monitor" : "Disable file system monitor");
+    
+    if (!m_gitManager->isRepositoryOpen()) {
+        m_fsMonitorAction->setChecked(false);
+        QMessageBox::information(this, "File System Monitor", "Please open a repository first.");
+        return;
+    }
+    
+    if (!m_gitManager->setFsMonitorEnabled(enabled)) {
+        m_fsMonitorAction->setChecked(!enabled);
+        QMessageBox::warning(this, "File System Monitor", "Failed to update the file system monitor: " + m_gitManager->getLastError());
+        return;
+    }
+    
+    m_statusLabel->setText(enabled ? "File system monitor enabled" : "File system monitor disabled");
+}
+
+void MainWindow::onFsMonitorStateChanged(bool enabled)
+{
+    m_fsMonitorAction->setChecked(enabled);
+    m_statusTimingLabel->setVisible(enabled);
+    m_statusTimingLabel->clear();
+}
+
+void MainWindow::onFileStatusTimed(qint64 elapsedMs, qint64 baselineMs)
+{
+    if (baselineMs < 0) {
+        m_statusTimingLabel->setText(QString("Status: %1 ms").arg(elapsedMs));
+    } else {
+        m_statusTimingLabel->setText(QString("Status: %1 ms (%2 ms saved by the file system monitor)")
+            .arg(elapsedMs)
+            .arg(baselineMs - elapsedMs));
+    }
+    m_statusTimingLabel->show();
+}
+
+void MainWindow::onRepositoryHealthChanged(const RepositoryHealth &health)
+{
+    const QStringList warnings = health.warnings();
+    if (warnings.isEmpty()) {
+        m_healthLabel->hide();
+        return;
+    }
+    
+    m_healthLabel->setText(QString("Maintenance recommended (%1)").arg(warnings.size()));
+    m_healthLabel->setToolTip(warnings.join("\n"));
+    m_healthLabel->show();
+}
+
+QString MainWindow::chooseRemote(const QString &title)
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        QMessageBox::information(this, title, "Open a repository first.");
+        return QString();
+    }
+    
+    if (remoteManager()->isRunning(m_remoteJobId)) {
+        QMessageBox::information(this, title, "Another remote operation is still running.");
+        return QString();
+    }
+    
+    QStringList remotes = m_gitManager->getRemotes();
+    if (remotes.isEmpty()) {
+        QMessageBox::warning(this, title, "This repository has no remotes.");
+        return QString();
+    }
+    
+    if (remotes.size() == 1) {
+        return remotes.first();
+    }
+    
+    bool ok = false;
+    int current = qMax(0, remotes.indexOf("origin"));
+    QString remote = QInputDialog::getItem(this, title, "Remote:", remotes, current, false, &ok);
+    return ok ? remote : QString();
+}
+
+void MainWindow::fetchRemote()
+{
+    GitTraceAction action("Fetch");
+    
+    QString remote = chooseRemote("Fetch");
+    if (!remote.isEmpty()) {
+        m_remoteJobId = remoteManager()->startFetch(remote);
+    }
+}
+
+void MainWindow::fetchAllRemotes()
+{
+    GitTraceAction action("Fetch all");
+    
+    if (!m_gitManager->isRepositoryOpen()) {
+        QMessageBox::information(this, "Fetch All", "Open a repository first.");
+        return;
+    }
+    
+    remoteManager()->showFetchAllDialog();
+}
+
+void MainWindow::pullRemote()
+{
+    GitTraceAction action("Pull");
+    
+    QString remote = chooseRemote("Pull");
+    if (!remote.isEmpty()) {
+        m_remoteJobId = remoteManager()->startPull(remote);
+    }
+}
+
+void MainWindow::pushRemote()
+{
+    GitTraceAction action("Push");
+    
+    QString remote = chooseRemote("Push");
+    if (!remote.isEmpty()) {
+        m_remoteJobId = remoteManager()->startPush(remote, m_gitManager->getCurrentBranch());
+    }
+}
+
+void MainWindow::cancelRemoteOperation()
+{
+    remoteManager()->cancel(m_remoteJobId);
+}
+
+void MainWindow::onRemoteJobStarted(int jobId, const QString &description)
+{
+    Q_UNUSED(jobId);
+    
+    m_statusLabel->setText(description + "...");
+    m_remoteProgress->setRange(0, 0);
+    m_remoteProgress->setFormat(description);
+    m_remoteProgress->show();
+    m_remoteRateLabel->clear();
+    m_remoteRateLabel->show();
+    m_remoteCancelButton->show();
+}
+
+void MainWindow::onRemoteJobProgress(int jobId, const GitProgressInfo &progress)
+{
+    if (jobId != m_remoteJobId) {
+        return;
+    }
+    
+    if (progress.percent >= 0) {
+        m_remoteProgress->setRange(0, 100);
+        m_remoteProgress->setValue(progress.percent);
+        m_remoteProgress->setFormat(QString("%1: %p% (%2/%3)")
+            .arg(progress.phase)
+            .arg(progress.current)
+            .arg(progress.total));
+    } else {
+        m_remoteProgress->setRange(0, 0);
+        m_remoteProgress->setFormat(QString("%1: %2").arg(progress.phase).arg(progress.current));
+    }
+    
+    if (progress.bytes >= 0) {
+        QString rate = GitProgressParser::formatBytes(progress.bytes);
+        if (progress.bytesPerSecond >= 0) {
+            rate += " at " + GitProgressParser::formatBytes(progress.bytesPerSecond) + "/s";
+        } else {
+            const qint64 elapsed = remoteManager()->elapsed(jobId);
+            if (elapsed > 0) {
+                rate += " at " + GitProgressParser::formatBytes(progress.bytes * 1000 / elapsed) + "/s";
+            }
+        }
+        m_remoteRateLabel->setText(rate);
+    }
+}
+
+void MainWindow::onRemoteJobFinished(int jobId, bool success, const QString &message)
+{
+    if (jobId != m_remoteJobId) {
+        return;
+    }
+    
+    m_remoteProgress->hide();
+    m_remoteRateLabel->hide();
+    m_remoteCancelButton->hide();
+    m_statusLabel->setText(message.section('\n', 0, 0));
+    
+    if (!success && !message.endsWith("cancelled")) {
+        QMessageBox::warning(this, "Remote Operation Failed", message);
+    }
+}
+
 void MainWindow::showSettings()
 {
-    m_settings->show();
+    settingsDialog()->show();
 }
 
 void MainWindow::showAbout()
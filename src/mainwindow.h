@@ -13,6 +13,10 @@
 #include <QTextEdit>
 #include <QAction>
 #include <QLabel>
+#include <QDockWidget>
+#include <QProgressBar>
+#include <QToolButton>
+#include "gitprogress.h"
 
 class GitManager;
 class RepositoryBrowser;
@@ -22,6 +26,15 @@ class BranchManager;
 class RemoteManager;
 class DiffViewer;
 class Settings;
+class SparseCheckoutDialog;
+class WorkspacePanel;
+class PerformancePanel;
+class AnalyticsDashboard;
+class RepositorySizePanel;
+class RepositoryMaintenance;
+class MaintenancePanel;
+class TagPanel;
+struct RepositoryHealth;
 
 class MainWindow : public QMainWindow
 {
@@ -31,12 +44,40 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+protected:
+    void showEvent(QShowEvent *event) override;
+    void closeEvent(QCloseEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private slots:
+    void restoreSession();
+    void onRepositoryRefreshed();
     void openRepository();
+    void openRepositoryPath(const QString &path);
+    void onRepositoryStateChanged();
+    void onBranchChanged();
     void cloneRepository();
     void showSettings();
     void showAbout();
     void refreshRepository();
+    void manageBranches();
+    void manageSparseCheckout();
+    void showAnalytics();
+    void showRepositorySize();
+    void toggleFsMonitor(bool enabled);
+    void onFsMonitorStateChanged(bool enabled);
+    void onFileStatusTimed(qint64 elapsedMs, qint64 baselineMs);
+    void onRepositoryHealthChanged(const RepositoryHealth &health);
+    void fetchRemote();
+    void fetchAllRemotes();
+    void pullRemote();
+    void pushRemote();
+    void cancelRemoteOperation();
+    void onRemoteJobStarted(int jobId, const QString &description);
+    void onRemoteJobProgress(int jobId, const GitProgressInfo &progress);
+    void onRemoteJobFinished(int jobId, bool success, const QString &message);
+    void openFileViewer(const QString &filePath, const QString &revision);
+    void onCloneFinished(int jobId, bool success, const QString &path, qint64 elapsedMs, qint64 diskBytes, const QString &message);
 
 private:
     void setupUI();
@@ -45,6 +86,15 @@ private:
     void setupStatusBar();
     void createActions();
     void connectSignals();
+    QString chooseRemote(const QString &title);
+    BranchManager *branchManager();
+    RemoteManager *remoteManager();
+    Settings *settingsDialog();
+    void createWorkspacePanel();
+    void createPerformancePanel();
+    void createMaintenancePanel();
+    void createTagPanel();
+    void saveSession() const;
 
     QWidget *m_centralWidget;
     QSplitter *m_mainSplitter;
@@ -55,15 +105,36 @@ private:
     CommitHistory *m_commitHistory;
     StagingArea *m_stagingArea;
     DiffViewer *m_diffViewer;
+    WorkspacePanel *m_workspacePanel;
+    QDockWidget *m_workspaceDock;
+    PerformancePanel *m_performancePanel;
+    QDockWidget *m_performanceDock;
+    MaintenancePanel *m_maintenancePanel;
+    QDockWidget *m_maintenanceDock;
+    TagPanel *m_tagPanel;
+    QDockWidget *m_tagDock;
     
     GitManager *m_gitManager;
+    RepositoryMaintenance *m_maintenance;
     BranchManager *m_branchManager;
     RemoteManager *m_remoteManager;
     Settings *m_settings;
+    SparseCheckoutDialog *m_sparseCheckoutDialog;
+    AnalyticsDashboard *m_analyticsDashboard;
+    RepositorySizePanel *m_repositorySizePanel;
     
     QAction *m_openAction;
     QAction *m_cloneAction;
     QAction *m_refreshAction;
+    QAction *m_branchesAction;
+    QAction *m_sparseAction;
+    QAction *m_fsMonitorAction;
+    QAction *m_analyticsAction;
+    QAction *m_repositorySizeAction;
+    QAction *m_fetchAction;
+    QAction *m_fetchAllAction;
+    QAction *m_pullAction;
+    QAction *m_pushAction;
     QAction *m_settingsAction;
     QAction *m_aboutAction;
     QAction *m_exitAction;
@@ -71,6 +142,14 @@ private:
     QLabel *m_statusLabel;
     QLabel *m_branchLabel;
     QLabel *m_repoLabel;
+    QLabel *m_statusTimingLabel;
+    QLabel *m_healthLabel;
+    QProgressBar *m_remoteProgress;
+    QLabel *m_remoteRateLabel;
+    QToolButton *m_remoteCancelButton;
+    int m_remoteJobId;
+    bool m_sessionRestoreScheduled;
+    bool m_awaitingFreshData;
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
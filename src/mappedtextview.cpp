@@ -0,0 +1,389 @@
+#include "mappedtextview.h"
+#include "tokencache.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPointer>
+#include <QScrollBar>
+#include <QThreadPool>
+#include <climits>
+#include <cstring>
+
+MappedTextView::MappedTextView(QWidget *parent)
+    : QAbstractScrollArea(parent)
+    , m_lineCount(0)
+    , m_indexedBytes(0)
+    , m_currentLine(-1)
+    , m_pendingLine(-1)
+    , m_indexing(false)
+    , m_maxLineWidth(0)
+    , m_language(SyntaxTokenizer::PlainText)
+{
+    setFont(QFont("Courier New", 9));
+    viewport()->setBackgroundRole(QPalette::Base);
+    viewport()->setAutoFillBackground(true);
+}
+
+MappedTextView::~MappedTextView()
+{
+    closeFile();
+}
+
+bool MappedTextView::openFile(const QString &path, QString *error)
+{
+    closeFile();
+    
+    QSharedPointer<Document> document(new Document);
+    document->file.setFileName(path);
+    if (!document->file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = document->file.errorString();
+        }
+        return false;
+    }
+    
+    document->size = document->file.size();
+    if (document->size > 0) {
+        document->data = document->file.map(0, document->size);
+        if (!document->data) {
+            if (error) {
+                *error = "Cannot map " + path + ": " + document->file.errorString();
+            }
+            return false;
+        }
+    }
+    
+    m_document = document;
+    startIndexing();
+    return true;
+}
+
+void MappedTextView::closeFile()
+{
+    if (m_document) {
+        m_document->cancelled = true;
+    }
+    
+    m_document.reset();
+    m_checkpoints.clear();
+    m_lineCount = 0;
+    m_indexedBytes = 0;
+    m_currentLine = -1;
+    m_pendingLine = -1;
+    m_indexing = false;
+    m_maxLineWidth = 0;
+    m_language = SyntaxTokenizer::PlainText;
+    m_blobKey.clear();
+    m_pendingChunks.clear();
+    m_chunkEndStates.clear();
+    updateScrollBars();
+    viewport()->update();
+}
+
+void MappedTextView::setSyntax(SyntaxTokenizer::Language language, const QString &blobKey)
+{
+    m_language = language;
+    m_blobKey = blobKey;
+    m_pendingChunks.clear();
+    m_chunkEndStates.clear();
+    viewport()->update();
+}
+
+qint64 MappedTextView::fileSize() const
+{
+    return m_document ? m_document->size : 0;
+}
+
+qint64 MappedTextView::lineCount() const
+{
+    return m_lineCount;
+}
+
+bool MappedTextView::isIndexing() const
+{
+    return m_indexing;
+}
+
+void MappedTextView::goToLine(qint64 line)
+{
+    if (!m_document || line < 0) {
+        return;
+    }
+    
+    if (line >= m_lineCount) {
+        if (m_indexing) {
+            m_pendingLine = line;
+            return;
+        }
+        line = qMax<qint64>(0, m_lineCount - 1);
+    }
+    
+    m_pendingLine = -1;
+    m_currentLine = line;
+    verticalScrollBar()->setValue(int(qMax<qint64>(0, line - visibleLines() / 2)));
+    viewport()->update();
+}
+
+void MappedTextView::startIndexing()
+{
+    m_checkpoints = {0};
+    m_indexing = true;
+    
+    QSharedPointer<Document> document = m_document;
+    QPointer<MappedTextView> self(this);
+    
+    QThreadPool::globalInstance()->start([document, self]() {
+        const uchar *data = document->data;
+        const qint64 size = document->size;
+        qint64 newlines = 0;
+        qint64 position = 0;
+        
+        while (position < size && !document->cancelled) {
+            const qint64 blockEnd = qMin(size, position + IndexBlockBytes);
+            QVector<qint64> checkpoints;
+            
+            while (position < blockEnd) {
+                const void *found = memchr(data + position, '\n', size_t(blockEnd - position));
+                if (!found) {
+                    position = blockEnd;
+                    break;
+                }
+                position = static_cast<const uchar*>(found) - data + 1;
+                ++newlines;
+                if (newlines % CheckpointInterval == 0 && position < size) {
+                    checkpoints.append(position);
+                }
+            }
+            
+            const bool finished = position >= size;
+            const qint64 lines = finished && size > 0 && data[size - 1] != '\n' ? newlines + 1 : newlines;
+            if (!self) {
+                return;
+            }
+            QMetaObject::invokeMethod(self, [self, document, checkpoints, lines, position, finished]() {
+                if (self && self->m_document == document) {
+                    self->appendCheckpoints(checkpoints, lines, position, finished);
+                }
+            }, Qt::QueuedConnection);
+        }
+        
+        if (size == 0 && self) {
+            QMetaObject::invokeMethod(self, [self, document]() {
+                if (self && self->m_document == document) {
+                    self->appendCheckpoints(QVector<qint64>(), 0, 0, true);
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+void MappedTextView::appendCheckpoints(const QVector<qint64> &checkpoints, qint64 lines, qint64 bytes, bool finished)
+{
+    m_checkpoints += checkpoints;
+    m_lineCount = lines;
+    m_indexedBytes = bytes;
+    m_indexing = !finished;
+    updateScrollBars();
+    
+    if (m_pendingLine >= 0 && (m_pendingLine < m_lineCount || finished)) {
+        goToLine(m_pendingLine);
+    }
+    
+    viewport()->update();
+    emit indexingProgress(lines, bytes, finished);
+}
+
+void MappedTextView::requestTokens(int chunk)
+{
+    if (m_language == SyntaxTokenizer::PlainText || m_blobKey.isEmpty() || m_pendingChunks.contains(chunk)) {
+        return;
+    }
+    
+    const qint64 firstLine = qint64(chunk) * TokenCache::ChunkLines;
+    if (firstLine >= m_lineCount || (m_indexing && firstLine + TokenCache::ChunkLines > m_lineCount)) {
+        return;
+    }
+    
+    const qint64 offset = lineStart(firstLine);
+    if (offset < 0) {
+        return;
+    }
+    
+    const int count = int(qMin<qint64>(TokenCache::ChunkLines, m_lineCount - firstLine));
+    const int startState = chunk == 0 ? SyntaxTokenizer::Normal : m_chunkEndStates.value(chunk - 1, SyntaxTokenizer::Normal);
+    const SyntaxTokenizer::Language language = m_language;
+    const QString blobKey = m_blobKey;
+    QSharedPointer<Document> document = m_document;
+    QPointer<MappedTextView> self(this);
+    
+    m_pendingChunks.insert(chunk);
+    QThreadPool::globalInstance()->start([self, document, language, blobKey, chunk, offset, count, startState]() {
+        QStringList lines;
+        qint64 position = offset;
+        for (int i = 0; i < count && position <= document->size && !document->cancelled; ++i) {
+            const void *found = memchr(document->data + position, '\n', size_t(document->size - position));
+            const qint64 end = found ? static_cast<const uchar*>(found) - document->data : document->size;
+            lines.append(decodeLine(document->data, position, end));
+            position = end + 1;
+        }
+        
+        const TokenChunk tokens = TokenCache::tokenize(language, lines, startState);
+        TokenCache::instance()->insert(blobKey, chunk, tokens);
+        
+        if (!self) {
+            return;
+        }
+        QMetaObject::invokeMethod(self, [self, document, blobKey, chunk, tokens]() {
+            if (self && self->m_document == document && self->m_blobKey == blobKey) {
+                self->m_pendingChunks.remove(chunk);
+                self->m_chunkEndStates.insert(chunk, tokens.endState);
+                self->viewport()->update();
+            }
+        }, Qt::QueuedConnection);
+    });
+}
+
+qint64 MappedTextView::lineStart(qint64 line) const
+{
+    const qint64 checkpoint = line / CheckpointInterval;
+    if (!m_document || line >= m_lineCount || checkpoint >= m_checkpoints.size()) {
+        return -1;
+    }
+    
+    qint64 offset = m_checkpoints.at(checkpoint);
+    for (qint64 skip = line % CheckpointInterval; skip > 0; --skip) {
+        offset = lineEnd(offset) + 1;
+        if (offset >= m_document->size) {
+            return -1;
+        }
+    }
+    return offset;
+}
+
+qint64 MappedTextView::lineEnd(qint64 start) const
+{
+    const void *found = memchr(m_document->data + start, '\n', size_t(m_document->size - start));
+    return found ? static_cast<const uchar*>(found) - m_document->data : m_document->size;
+}
+
+QString MappedTextView::decodeLine(const uchar *data, qint64 start, qint64 end)
+{
+    QByteArray bytes(reinterpret_cast<const char*>(data + start), int(qMin<qint64>(end - start, MaxLineBytes)));
+    if (bytes.endsWith('\r')) {
+        bytes.chop(1);
+    }
+    return QString::fromUtf8(bytes).replace('\t', "    ");
+}
+
+int MappedTextView::visibleLines() const
+{
+    return qMax(1, viewport()->height() / fontMetrics().height());
+}
+
+int MappedTextView::gutterWidth() const
+{
+    const int digits = QString::number(qMax<qint64>(1, m_lineCount)).size();
+    return fontMetrics().horizontalAdvance(QChar('9')) * (digits + 2);
+}
+
+void MappedTextView::updateScrollBars()
+{
+    const qint64 maximum = qMax<qint64>(0, m_lineCount - visibleLines() + 1);
+    verticalScrollBar()->setRange(0, int(qMin<qint64>(maximum, INT_MAX)));
+    verticalScrollBar()->setPageStep(visibleLines());
+    
+    horizontalScrollBar()->setRange(0, qMax(0, gutterWidth() + m_maxLineWidth - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+}
+
+void MappedTextView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void MappedTextView::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    
+    QPainter painter(viewport());
+    if (!m_document) {
+        return;
+    }
+    
+    const QFontMetrics metrics = fontMetrics();
+    const int lineHeight = metrics.height();
+    const int gutter = gutterWidth();
+    const int xOffset = horizontalScrollBar()->value();
+    const qint64 firstLine = verticalScrollBar()->value();
+    const qint64 lastLine = qMin(m_lineCount, firstLine + visibleLines() + 1);
+    
+    painter.fillRect(0, 0, gutter - 4, viewport()->height(), palette().alternateBase());
+    
+    QHash<int, TokenChunk> chunks;
+    if (m_language != SyntaxTokenizer::PlainText && firstLine < lastLine) {
+        const int firstChunk = int(firstLine / TokenCache::ChunkLines);
+        const int lastChunk = int((lastLine - 1) / TokenCache::ChunkLines);
+        for (int chunk = firstChunk; chunk <= lastChunk; ++chunk) {
+            const qint64 expectedLines = qMin<qint64>(TokenCache::ChunkLines, m_lineCount - qint64(chunk) * TokenCache::ChunkLines);
+            const int expectedState = chunk == 0 ? int(SyntaxTokenizer::Normal) : m_chunkEndStates.value(chunk - 1, -1);
+            TokenChunk tokens;
+            if (TokenCache::instance()->lookup(m_blobKey, chunk, tokens) && tokens.lines.size() >= expectedLines
+                && (expectedState < 0 || tokens.startState == expectedState)) {
+                m_chunkEndStates.insert(chunk, tokens.endState);
+                chunks.insert(chunk, tokens);
+            } else {
+                requestTokens(chunk);
+            }
+        }
+    }
+    
+    qint64 offset = lineStart(firstLine);
+    int widest = m_maxLineWidth;
+    for (qint64 line = firstLine; line < lastLine && offset >= 0 && offset <= m_document->size; ++line) {
+        const int y = int(line - firstLine) * lineHeight;
+        const qint64 end = lineEnd(qMin(offset, m_document->size));
+        const QString text = decodeLine(m_document->data, offset, end);
+        
+        if (line == m_currentLine) {
+            painter.fillRect(0, y, viewport()->width(), lineHeight, palette().highlight());
+        }
+        
+        painter.setPen(palette().color(QPalette::PlaceholderText));
+        painter.drawText(QRect(0, y, gutter - 8, lineHeight), Qt::AlignRight | Qt::AlignVCenter, QString::number(line + 1));
+        
+        const QColor textColor = line == m_currentLine ? palette().color(QPalette::HighlightedText) : palette().color(QPalette::Text);
+        painter.setClipRect(gutter, y, viewport()->width() - gutter, lineHeight);
+        
+        const auto chunk = chunks.constFind(int(line / TokenCache::ChunkLines));
+        const SyntaxLineTokens tokens = chunk != chunks.constEnd()
+            ? chunk->lines.value(int(line % TokenCache::ChunkLines))
+            : SyntaxLineTokens();
+        
+        int x = gutter - xOffset;
+        int position = 0;
+        auto drawRun = [&](int length, const QColor &color) {
+            if (length <= 0) {
+                return;
+            }
+            const QString run = text.mid(position, length);
+            painter.setPen(color);
+            painter.drawText(x, y + metrics.ascent(), run);
+            x += metrics.horizontalAdvance(run);
+            position += length;
+        };
+        for (const SyntaxToken &token : tokens) {
+            drawRun(token.start - position, textColor);
+            drawRun(token.length, SyntaxTokenizer::color(token.kind));
+        }
+        drawRun(text.size() - position, textColor);
+        painter.setClipping(false);
+        
+        widest = qMax(widest, x + xOffset - gutter);
+        offset = end + 1;
+    }
+    
+    if (widest != m_maxLineWidth) {
+        m_maxLineWidth = widest;
+        updateScrollBars();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef MAPPEDTEXTVIEW_H
+#define MAPPEDTEXTVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QFile>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QVector>
+#include <atomic>
+#include "syntaxtokenizer.h"
+
+class MappedTextView : public QAbstractScrollArea
+{
+    Q_OBJECT
+
+public:
+    explicit MappedTextView(QWidget *parent = nullptr);
+    ~MappedTextView();
+    
+    bool openFile(const QString &path, QString *error = nullptr);
+    void closeFile();
+    void setSyntax(SyntaxTokenizer::Language language, const QString &blobKey);
+    
+    qint64 fileSize() const;
+    qint64 lineCount() const;
+    bool isIndexing() const;
+    void goToLine(qint64 line);
+
+signals:
+    void indexingProgress(qint64 lines, qint64 bytes, bool finished);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    struct Document {
+        QFile file;
+        const uchar *data = nullptr;
+        qint64 size = 0;
+        std::atomic<bool> cancelled{false};
+    };
+    
+    static const int CheckpointInterval = 64;
+    static const int MaxLineBytes = 4096;
+    static const qint64 IndexBlockBytes = 16 * 1024 * 1024;
+    
+    void startIndexing();
+    void requestTokens(int chunk);
+    void appendCheckpoints(const QVector<qint64> &checkpoints, qint64 lines, qint64 bytes, bool finished);
+    qint64 lineStart(qint64 line) const;
+    qint64 lineEnd(qint64 start) const;
+    static QString decodeLine(const uchar *data, qint64 start, qint64 end);
+    int visibleLines() const;
+    int gutterWidth() const;
+    void updateScrollBars();
+    
+    QSharedPointer<Document> m_document;
+    QVector<qint64> m_checkpoints;
+    qint64 m_lineCount;
+    qint64 m_indexedBytes;
+    qint64 m_currentLine;
+    qint64 m_pendingLine;
+    bool m_indexing;
+    int m_maxLineWidth;
+    
+    SyntaxTokenizer::Language m_language;
+    QString m_blobKey;
+    QSet<int> m_pendingChunks;
+    QHash<int, int> m_chunkEndStates;
+};
+
+#endif // MAPPEDTEXTVIEW_H
\ No newline at end of file
@@ -0,0 +1,375 @@
+#include "objectsizeanalyzer.h"
+#include "gitmanager.h"
+#include "gittracer.h"
+#include <QElapsedTimer>
+#include <QProcess>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+namespace {
+
+const char *OtherDirectories = "(other directories)";
+
+bool blobHeapOrder(const ObjectSizeEntry &a, const ObjectSizeEntry &b)
+{
+    return a.diskSize > b.diskSize;
+}
+
+// Partial clones fetch absent objects on demand; a size scan must only
+// look at what is already on disk.
+void disableLazyFetch(QProcess &process)
+{
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("GIT_NO_LAZY_FETCH", "1");
+    process.setProcessEnvironment(environment);
+}
+
+bool isCancelled(const QAtomicInt *cancelled)
+{
+    return cancelled && cancelled->loadRelaxed();
+}
+
+bool streamLines(QProcess &process, const QAtomicInt *cancelled, const std::function<void(const char *, int)> &handler)
+{
+    QByteArray pending;
+    auto consumeLines = [&pending, &handler]() {
+        int start = 0;
+        int newline;
+        while ((newline = pending.indexOf('\n', start)) >= 0) {
+            handler(pending.constData() + start, newline - start);
+            start = newline + 1;
+        }
+        pending.remove(0, start);
+    };
+    
+    for (;;) {
+        if (isCancelled(cancelled)) {
+            process.kill();
+            process.waitForFinished(-1);
+            return false;
+        }
+        const bool readable = process.waitForReadyRead(250);
+        pending += process.readAllStandardOutput();
+        consumeLines();
+        if (!readable && process.state() == QProcess::NotRunning) {
+            break;
+        }
+    }
+    
+    process.waitForFinished(-1);
+    pending += process.readAllStandardOutput();
+    consumeLines();
+    if (!pending.isEmpty()) {
+        handler(pending.constData(), pending.size());
+    }
+    return true;
+}
+
+QList<ObjectSizeEntry> sortedEntries(const QHash<QString, ObjectSizeEntry> &entries)
+{
+    QList<ObjectSizeEntry> result = entries.values();
+    std::sort(result.begin(), result.end(), blobHeapOrder);
+    return result;
+}
+
+}
+
+ObjectSizeEntry::ObjectSizeEntry()
+    : count(0)
+    , size(0)
+    , diskSize(0)
+{
+}
+
+ObjectSizeReport::ObjectSizeReport()
+    : totalObjects(0)
+    , totalDiskSize(0)
+    , reachableDiskSize(0)
+    , foldedBlobs(0)
+    , missingObjects(0)
+    , elapsedMs(0)
+    , truncated(false)
+    , success(false)
+{
+}
+
+ObjectSizeAnalyzer::ObjectSizeAnalyzer(int blobLimit, int pathLimit)
+    : m_blobLimit(blobLimit)
+    , m_pathLimit(pathLimit)
+    , m_foldedBlobs(0)
+{
+}
+
+bool ObjectSizeAnalyzer::analyze(const QString &workingDirectory, ObjectSizeReport &report, const QAtomicInt *cancelled)
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    m_heap.clear();
+    m_paths.clear();
+    m_directories.clear();
+    m_foldedBlobs = 0;
+    report = ObjectSizeReport();
+    
+    if (!scanAllObjects(workingDirectory, report, cancelled)
+        || !scanReachableBlobs(workingDirectory, report, cancelled)) {
+        report.elapsedMs = timer.elapsed();
+        return false;
+    }
+    
+    std::sort_heap(m_heap.begin(), m_heap.end(), blobHeapOrder);
+    report.largestBlobs = m_heap;
+    m_heap.clear();
+    
+    QHash<QString, ObjectSizeEntry> paths;
+    paths.reserve(m_paths.size());
+    for (auto it = m_paths.constBegin(); it != m_paths.constEnd(); ++it) {
+        ObjectSizeEntry entry;
+        entry.name = it.key();
+        entry.path = it.key();
+        entry.count = it.value().count;
+        entry.size = it.value().size;
+        entry.diskSize = it.value().diskSize;
+        paths.insert(it.key(), entry);
+    }
+    m_paths.clear();
+    report.paths = sortedEntries(paths);
+    
+    QHash<QString, ObjectSizeEntry> directories;
+    for (auto it = m_directories.constBegin(); it != m_directories.constEnd(); ++it) {
+        ObjectSizeEntry entry;
+        entry.name = it.key();
+        entry.path = it.key();
+        entry.count = it.value().count;
+        entry.size = it.value().size;
+        entry.diskSize = it.value().diskSize;
+        directories.insert(it.key(), entry);
+    }
+    m_directories.clear();
+    report.directories = sortedEntries(directories);
+    
+    report.foldedBlobs = m_foldedBlobs;
+    report.truncated = m_foldedBlobs > 0;
+    report.elapsedMs = timer.elapsed();
+    report.success = true;
+    return true;
+}
+
+QStringList ObjectSizeAnalyzer::introducingCommitArguments(const QString &objectId)
+{
+    return {"log", "--all", "--find-object=" + objectId, "--format=%H%x1f%an%x1f%ad%x1f%s", "--date=short"};
+}
+
+bool ObjectSizeAnalyzer::scanAllObjects(const QString &workingDirectory, ObjectSizeReport &report, const QAtomicInt *cancelled)
+{
+    const QStringList args = {"cat-file", "--batch-all-objects", "--unordered",
+                              "--batch-check=%(objecttype) %(objectsize) %(objectsize:disk)"};
+    
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, args);
+    
+    QProcess process;
+    process.setWorkingDirectory(workingDirectory);
+    disableLazyFetch(process);
+    process.start("git", args);
+    if (!process.waitForStarted()) {
+        report.error = "Failed to start git: " + process.errorString();
+        trace.finish(-1, false, report.error);
+        return false;
+    }
+    trace.markStarted();
+    
+    QHash<QByteArray, ObjectSizeEntry> types;
+    qint64 outputBytes = 0;
+    const bool completed = streamLines(process, cancelled, [&types, &report, &outputBytes](const char *data, int size) {
+        outputBytes += size + 1;
+        const QList<QByteArray> fields = QByteArray::fromRawData(data, size).split(' ');
+        if (fields.size() < 3) {
+            return;
+        }
+        ObjectSizeEntry &entry = types[fields.at(0)];
+        ++entry.count;
+        entry.size += fields.at(1).toLongLong();
+        entry.diskSize += fields.at(2).toLongLong();
+        ++report.totalObjects;
+        report.totalDiskSize += fields.at(2).toLongLong();
+    });
+    trace.addOutput(outputBytes);
+    
+    if (!completed) {
+        report.error = "Cancelled";
+        trace.finish(-1, false, report.error);
+        return false;
+    }
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        report.error = QString::fromUtf8(process.readAllStandardError()).trimmed();
+        trace.finish(process.exitCode(), false, report.error);
+        return false;
+    }
+    trace.finish(0, true);
+    
+    for (auto it = types.begin(); it != types.end(); ++it) {
+        it.value().name = QString::fromLatin1(it.key());
+        report.types.append(it.value());
+    }
+    std::sort(report.types.begin(), report.types.end(), blobHeapOrder);
+    return true;
+}
+
+bool ObjectSizeAnalyzer::scanReachableBlobs(const QString &workingDirectory, ObjectSizeReport &report, const QAtomicInt *cancelled)
+{
+    // In a partial clone the objects left behind by the filter are listed
+    // as "?<id>", which cat-file then reports as missing.
+    QStringList revListArgs = {"rev-list", "--objects", "--all"};
+    if (GitManager::isPartialClone(workingDirectory)) {
+        revListArgs << "--missing=print";
+    }
+    const QStringList catFileArgs = {"cat-file", "--batch-check=%(objectname) %(objecttype) %(objectsize) %(objectsize:disk) %(rest)"};
+    
+    GitProcessTrace trace;
+    trace.begin(workingDirectory, QStringList(revListArgs) << "|" << catFileArgs);
+    
+    QProcess revList;
+    QProcess catFile;
+    revList.setWorkingDirectory(workingDirectory);
+    catFile.setWorkingDirectory(workingDirectory);
+    disableLazyFetch(revList);
+    disableLazyFetch(catFile);
+    revList.setStandardOutputProcess(&catFile);
+    
+    catFile.start("git", catFileArgs);
+    revList.start("git", revListArgs);
+    if (!catFile.waitForStarted() || !revList.waitForStarted()) {
+        report.error = "Failed to start git: " + (catFile.error() == QProcess::FailedToStart ? catFile.errorString() : revList.errorString());
+        revList.kill();
+        catFile.kill();
+        revList.waitForFinished();
+        catFile.waitForFinished();
+        trace.finish(-1, false, report.error);
+        return false;
+    }
+    trace.markStarted();
+    
+    qint64 outputBytes = 0;
+    const bool completed = streamLines(catFile, cancelled, [this, &report, &outputBytes](const char *data, int size) {
+        outputBytes += size + 1;
+        const char *end = data + size;
+        const char *firstSpace = static_cast<const char*>(memchr(data, ' ', size));
+        if (firstSpace && end - firstSpace == 8 && memcmp(firstSpace, " missing", 8) == 0) {
+            ++report.missingObjects;
+            return;
+        }
+        
+        const char *starts[4];
+        const char *ends[4];
+        const char *cursor = data;
+        for (int i = 0; i < 4; ++i) {
+            const char *space = static_cast<const char*>(memchr(cursor, ' ', end - cursor));
+            if (!space && i < 3) {
+                return;
+            }
+            starts[i] = cursor;
+            ends[i] = space ? space : end;
+            cursor = space ? space + 1 : end;
+        }
+        
+        if (ends[1] - starts[1] != 4 || memcmp(starts[1], "blob", 4) != 0) {
+            return;
+        }
+        
+        const qint64 objectSize = QByteArray::fromRawData(starts[2], int(ends[2] - starts[2])).toLongLong();
+        const qint64 diskSize = QByteArray::fromRawData(starts[3], int(ends[3] - starts[3])).toLongLong();
+        const QString path = ends[3] < end ? QString::fromUtf8(cursor, int(end - cursor)) : QString();
+        
+        report.reachableDiskSize += diskSize;
+        addBlob(QByteArray(starts[0], int(ends[0] - starts[0])), path, objectSize, diskSize);
+    });
+    
+    if (!completed) {
+        revList.kill();
+        revList.waitForFinished(-1);
+        report.error = "Cancelled";
+        trace.finish(-1, false, report.error);
+        return false;
+    }
+    revList.waitForFinished(-1);
+    trace.addOutput(outputBytes);
+    
+    if (revList.exitStatus() != QProcess::NormalExit || revList.exitCode() != 0) {
+        report.error = QString::fromUtf8(revList.readAllStandardError()).trimmed();
+        trace.finish(revList.exitCode(), false, report.error);
+        return false;
+    }
+    if (catFile.exitStatus() != QProcess::NormalExit || catFile.exitCode() != 0) {
+        report.error = QString::fromUtf8(catFile.readAllStandardError()).trimmed();
+        trace.finish(catFile.exitCode(), false, report.error);
+        return false;
+    }
+    
+    trace.finish(0, true);
+    return true;
+}
+
+void ObjectSizeAnalyzer::addBlob(const QByteArray &objectId, const QString &path, qint64 size, qint64 diskSize)
+{
+    if (m_heap.size() < m_blobLimit || diskSize > m_heap.first().diskSize) {
+        ObjectSizeEntry entry;
+        entry.name = QString::fromLatin1(objectId);
+        entry.path = path;
+        entry.count = 1;
+        entry.size = size;
+        entry.diskSize = diskSize;
+        
+        if (m_heap.size() >= m_blobLimit) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), blobHeapOrder);
+            m_heap.removeLast();
+        }
+        m_heap.append(entry);
+        std::push_heap(m_heap.begin(), m_heap.end(), blobHeapOrder);
+    }
+    
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    auto it = m_paths.find(path);
+    if (it == m_paths.end()) {
+        if (m_paths.size() >= m_pathLimit) {
+            ++m_foldedBlobs;
+            addToDirectories(path, size, diskSize);
+            return;
+        }
+        it = m_paths.insert(path, Totals{0, 0, 0});
+    }
+    ++it->count;
+    it->size += size;
+    it->diskSize += diskSize;
+    
+    addToDirectories(path, size, diskSize);
+}
+
+void ObjectSizeAnalyzer::addToDirectories(const QString &path, qint64 size, qint64 diskSize)
+{
+    int slash = path.lastIndexOf('/');
+    while (slash > 0) {
+        QString directory = path.left(slash);
+        const bool folded = !m_directories.contains(directory) && m_directories.size() >= m_pathLimit;
+        if (folded) {
+            directory = OtherDirectories;
+        }
+        
+        auto it = m_directories.find(directory);
+        if (it == m_directories.end()) {
+            it = m_directories.insert(directory, Totals{0, 0, 0});
+        }
+        ++it->count;
+        it->size += size;
+        it->diskSize += diskSize;
+        
+        if (folded) {
+            break;
+        }
+        slash = path.lastIndexOf('/', slash - 1);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef OBJECTSIZEANALYZER_H
+#define OBJECTSIZEANALYZER_H
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+struct ObjectSizeEntry {
+    QString name;
+    QString path;
+    qint64 count;
+    qint64 size;
+    qint64 diskSize;
+    
+    ObjectSizeEntry();
+};
+
+struct ObjectSizeReport {
+    QList<ObjectSizeEntry> largestBlobs;
+    QList<ObjectSizeEntry> paths;
+    QList<ObjectSizeEntry> directories;
+    QList<ObjectSizeEntry> types;
+    qint64 totalObjects;
+    qint64 totalDiskSize;
+    qint64 reachableDiskSize;
+    qint64 foldedBlobs;
+    qint64 missingObjects;
+    qint64 elapsedMs;
+    bool truncated;
+    bool success;
+    QString error;
+    
+    ObjectSizeReport();
+};
+
+class ObjectSizeAnalyzer
+{
+public:
+    static const int DefaultBlobLimit = 500;
+    static const int DefaultPathLimit = 250000;
+    
+    ObjectSizeAnalyzer(int blobLimit = DefaultBlobLimit, int pathLimit = DefaultPathLimit);
+    
+    bool analyze(const QString &workingDirectory, ObjectSizeReport &report, const QAtomicInt *cancelled = nullptr);
+    
+    static QStringList introducingCommitArguments(const QString &objectId);
+
+private:
+    struct Totals {
+        qint64 count;
+        qint64 size;
+        qint64 diskSize;
+    };
+    
+    bool scanAllObjects(const QString &workingDirectory, ObjectSizeReport &report, const QAtomicInt *cancelled);
+    bool scanReachableBlobs(const QString &workingDirectory, ObjectSizeReport &report, const QAtomicInt *cancelled);
+    void addBlob(const QByteArray &objectId, const QString &path, qint64 size, qint64 diskSize);
+    void addToDirectories(const QString &path, qint64 size, qint64 diskSize);
+    
+    int m_blobLimit;
+    int m_pathLimit;
+    QList<ObjectSizeEntry> m_heap;
+    QHash<QString, Totals> m_paths;
+    QHash<QString, Totals> m_directories;
+    qint64 m_foldedBlobs;
+};
+
+#endif // OBJECTSIZEANALYZER_H
\ No newline at end of file
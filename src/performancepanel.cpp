@@ -0,0 +1,233 @@
+#include "performancepanel.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QBrush>
+#include <QColor>
+#include <QDir>
+
+namespace {
+
+const int PollIntervalMs = 250;
+
+enum Role {
+    SortRole = Qt::UserRole + 1,
+    FailedRole
+};
+
+QStandardItem *numberItem(double value, const QString &text)
+{
+    QStandardItem *item = new QStandardItem(text);
+    item->setData(value, SortRole);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString formatMs(qint64 us)
+{
+    return QString::number(us / 1000.0, 'f', 1);
+}
+
+}
+
+PerformancePanel::PerformancePanel(QWidget *parent)
+    : QWidget(parent)
+    , m_treeView(nullptr)
+    , m_model(nullptr)
+    , m_proxyModel(nullptr)
+    , m_summaryLabel(nullptr)
+    , m_failuresOnlyCheck(nullptr)
+    , m_clearButton(nullptr)
+    , m_exportButton(nullptr)
+    , m_lastEventId(0)
+    , m_gitCount(0)
+    , m_failureCount(0)
+    , m_gitTotalUs(0)
+    , m_slowestUs(0)
+{
+    setupUI();
+    
+    connect(&m_pollTimer, &QTimer::timeout, this, &PerformancePanel::pollEvents);
+}
+
+void PerformancePanel::setupUI()
+{
+    setWindowTitle("Performance");
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    QHBoxLayout *headerLayout = new QHBoxLayout;
+    m_summaryLabel = new QLabel;
+    m_failuresOnlyCheck = new QCheckBox("Failures only");
+    m_clearButton = new QPushButton("Clear");
+    m_clearButton->setMaximumWidth(70);
+    m_exportButton = new QPushButton("Export Trace...");
+    
+    headerLayout->addWidget(m_summaryLabel);
+    headerLayout->addStretch();
+    headerLayout->addWidget(m_failuresOnlyCheck);
+    headerLayout->addWidget(m_clearButton);
+    headerLayout->addWidget(m_exportButton);
+    
+    m_model = new QStandardItemModel(0, ColumnCount, this);
+    m_model->setHorizontalHeaderLabels({"Time (s)", "Category", "Action", "Command", "Spawn (ms)", "Wall (ms)", "Output", "Exit"});
+    
+    m_proxyModel = new QSortFilterProxyModel(this);
+    m_proxyModel->setSourceModel(m_model);
+    m_proxyModel->setSortRole(SortRole);
+    m_proxyModel->setFilterRole(FailedRole);
+    m_proxyModel->setFilterKeyColumn(TimeColumn);
+    
+    m_treeView = new QTreeView;
+    m_treeView->setModel(m_proxyModel);
+    m_treeView->setRootIsDecorated(false);
+    m_treeView->setUniformRowHeights(true);
+    m_treeView->setAlternatingRowColors(true);
+    m_treeView->setSortingEnabled(true);
+    m_treeView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_treeView->sortByColumn(TimeColumn, Qt::DescendingOrder);
+    m_treeView->header()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    m_treeView->header()->setStretchLastSection(false);
+    
+    layout->addLayout(headerLayout);
+    layout->addWidget(m_treeView);
+    
+    connect(m_clearButton, &QPushButton::clicked, this, &PerformancePanel::clearEvents);
+    connect(m_exportButton, &QPushButton::clicked, this, &PerformancePanel::exportChromeTrace);
+    connect(m_failuresOnlyCheck, &QCheckBox::toggled, this, [this](bool checked) {
+        m_proxyModel->setFilterFixedString(checked ? "1" : QString());
+    });
+    
+    updateSummary();
+}
+
+void PerformancePanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    pollEvents();
+    m_pollTimer.start(PollIntervalMs);
+}
+
+void PerformancePanel::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_pollTimer.stop();
+}
+
+void PerformancePanel::pollEvents()
+{
+    const QList<GitTraceEvent> events = GitTracer::instance()->events(m_lastEventId);
+    if (events.isEmpty()) {
+        return;
+    }
+    
+    for (const GitTraceEvent &event : events) {
+        appendEvent(event);
+        m_lastEventId = event.id;
+    }
+    
+    const int excess = m_model->rowCount() - GitTracer::instance()->capacity();
+    if (excess > 0) {
+        m_model->removeRows(0, excess);
+    }
+    
+    updateSummary();
+}
+
+void PerformancePanel::appendEvent(const GitTraceEvent &event)
+{
+    QString name = event.name;
+    if (event.category == "git") {
+        name = "git " + event.arguments.join(' ');
+    } else if (!event.arguments.isEmpty()) {
+        name += " (" + event.arguments.join(' ') + ")";
+    }
+    
+    QList<QStandardItem*> row;
+    row << numberItem(event.startUs, QString::number(event.startUs / 1000000.0, 'f', 3));
+    row << new QStandardItem(event.category);
+    row << new QStandardItem(event.action);
+    row << new QStandardItem(name);
+    row << (event.spawnUs >= 0 ? numberItem(event.spawnUs, formatMs(event.spawnUs)) : numberItem(-1, QString()));
+    row << numberItem(event.durationUs, formatMs(event.durationUs));
+    if (event.outputBytes >= 0) {
+        row << numberItem(event.outputBytes, QString::number(event.outputBytes) + " B");
+    } else if (event.itemCount >= 0) {
+        row << numberItem(event.itemCount, QString::number(event.itemCount) + " items");
+    } else {
+        row << numberItem(-1, QString());
+    }
+    row << numberItem(event.exitCode, event.category == "git" ? QString::number(event.exitCode) : QString());
+    
+    for (QStandardItem *item : row) {
+        if (!item->data(SortRole).isValid()) {
+            item->setData(item->text(), SortRole);
+        }
+        if (!event.success) {
+            item->setForeground(QBrush(QColor(200, 0, 0)));
+        }
+    }
+    row[TimeColumn]->setData(event.success ? "0" : "1", FailedRole);
+    
+    QString toolTip = event.workingDirectory;
+    if (!event.error.isEmpty()) {
+        toolTip += (toolTip.isEmpty() ? "" : "\n") + event.error;
+    }
+    row[NameColumn]->setToolTip(toolTip);
+    
+    m_model->appendRow(row);
+    
+    if (event.category == "git") {
+        ++m_gitCount;
+        m_gitTotalUs += event.durationUs;
+        if (!event.success) {
+            ++m_failureCount;
+        }
+        if (event.durationUs > m_slowestUs) {
+            m_slowestUs = event.durationUs;
+            m_slowestName = name;
+        }
+    }
+}
+
+void PerformancePanel::updateSummary()
+{
+    QString text = QString("%1 git commands, %2 ms total, %3 failed")
+        .arg(m_gitCount)
+        .arg(formatMs(m_gitTotalUs))
+        .arg(m_failureCount);
+    if (m_slowestUs > 0) {
+        text += QString(" | slowest: %1 ms").arg(formatMs(m_slowestUs));
+        m_summaryLabel->setToolTip(m_slowestName);
+    }
+    m_summaryLabel->setText(text);
+}
+
+void PerformancePanel::clearEvents()
+{
+    GitTracer::instance()->clear();
+    m_model->removeRows(0, m_model->rowCount());
+    m_gitCount = 0;
+    m_failureCount = 0;
+    m_gitTotalUs = 0;
+    m_slowestUs = 0;
+    m_slowestName.clear();
+    m_summaryLabel->setToolTip(QString());
+    updateSummary();
+}
+
+void PerformancePanel::exportChromeTrace()
+{
+    const QString filePath = QFileDialog::getSaveFileName(this, "Export Chrome Trace",
+        QDir::home().filePath("srikok-trace.json"), "Chrome trace (*.json)");
+    if (filePath.isEmpty()) {
+        return;
+    }
+    
+    QString error;
+    if (!GitTracer::instance()->exportChromeTrace(filePath, &error)) {
+        QMessageBox::warning(this, "Export Chrome Trace", "Failed to write trace:\n" + error);
+    }
+}
\ No newline at end of file
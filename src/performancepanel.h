@@ -0,0 +1,64 @@
+#ifndef PERFORMANCEPANEL_H
+#define PERFORMANCEPANEL_H
+
+#include <QWidget>
+#include <QTreeView>
+#include <QStandardItemModel>
+#include <QSortFilterProxyModel>
+#include <QPushButton>
+#include <QCheckBox>
+#include <QLabel>
+#include <QTimer>
+#include "gittracer.h"
+
+class PerformancePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerformancePanel(QWidget *parent = nullptr);
+
+private slots:
+    void pollEvents();
+    void clearEvents();
+    void exportChromeTrace();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    enum Column {
+        TimeColumn,
+        CategoryColumn,
+        ActionColumn,
+        NameColumn,
+        SpawnColumn,
+        WallColumn,
+        OutputColumn,
+        ExitColumn,
+        ColumnCount
+    };
+    
+    void setupUI();
+    void appendEvent(const GitTraceEvent &event);
+    void updateSummary();
+    
+    QTreeView *m_treeView;
+    QStandardItemModel *m_model;
+    QSortFilterProxyModel *m_proxyModel;
+    QLabel *m_summaryLabel;
+    QCheckBox *m_failuresOnlyCheck;
+    QPushButton *m_clearButton;
+    QPushButton *m_exportButton;
+    
+    QTimer m_pollTimer;
+    quint64 m_lastEventId;
+    int m_gitCount;
+    int m_failureCount;
+    qint64 m_gitTotalUs;
+    qint64 m_slowestUs;
+    QString m_slowestName;
+};
+
+#endif // PERFORMANCEPANEL_H
\ No newline at end of file
@@ -1,8 +1,550 @@
 #include "remotemanager.h"
-#include "gitmanager.h"
+#include <QProcessEnvironment>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QPointer>
+#include <QThreadPool>
+#include <QProgressBar>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QSettings>
+#include <QBrush>
+#include <QColor>
+#include <QTimer>
+
+namespace {
+
+const int TerminateGracePeriodMs = 5000;
+
+}
 
 RemoteManager::RemoteManager(GitManager *gitManager, QObject *parent)
     : QObject(parent)
     , m_gitManager(gitManager)
+    , m_nextJobId(1)
+    , m_fetchLimit(4)
+    , m_fetchRunning(0)
+    , m_fetchSucceeded(0)
+    , m_fetchFailed(0)
+    , m_fetchDialog(nullptr)
+    , m_fetchTree(nullptr)
+    , m_fetchSummaryLabel(nullptr)
+    , m_fetchStartButton(nullptr)
+    , m_fetchCancelButton(nullptr)
+{
+    connect(this, &RemoteManager::fetchAllStarted, this, &RemoteManager::onFetchAllStarted);
+    connect(this, &RemoteManager::fetchAllProgress, this, &RemoteManager::onFetchAllProgress);
+    connect(this, &RemoteManager::fetchAllRemoteFinished, this, &RemoteManager::onFetchAllRemoteFinished);
+    connect(this, &RemoteManager::fetchAllFinished, this, &RemoteManager::onFetchAllFinished);
+}
+
+RemoteManager::~RemoteManager()
+{
+    for (Job *job : m_jobs) {
+        job->process->disconnect(this);
+        job->process->terminate();
+    }
+    for (Job *job : m_jobs) {
+        if (!job->process->waitForFinished(TerminateGracePeriodMs)) {
+            job->process->kill();
+            job->process->waitForFinished(1000);
+        }
+        delete job;
+    }
+    m_jobs.clear();
+    
+    delete m_fetchDialog;
+}
+
+int RemoteManager::startFetch(const QString &remote)
+{
+    if (!m_gitManager->isRepositoryOpen()) return 0;
+    
+    QStringList args;
+    args << "fetch" << "--progress" << remote;
+    
+    return startJob("Fetch " + remote, m_gitManager->getRepositoryPath(), args);
+}
+
+int RemoteManager::startPull(const QString &remote, const QString &branch)
+{
+    if (!m_gitManager->isRepositoryOpen()) return 0;
+    
+    QStringList args;
+    args << "pull" << "--progress" << remote;
+    if (!branch.isEmpty()) {
+        args << branch;
+    }
+    
+    return startJob("Pull " + remote, m_gitManager->getRepositoryPath(), args);
+}
+
+int RemoteManager::startPush(const QString &remote, const QString &branch)
+{
+    if (!m_gitManager->isRepositoryOpen()) return 0;
+    
+    QStringList args;
+    args << "push" << "--progress" << remote;
+    if (!branch.isEmpty()) {
+        args << branch;
+    }
+    
+    return startJob("Push " + remote, m_gitManager->getRepositoryPath(), args);
+}
+
+int RemoteManager::startClone(const GitCloneOptions &options)
+{
+    QStringList args = options.cloneArguments();
+    args.insert(1, "--progress");
+    
+    const int jobId = startJob("Clone " + options.url, QString(), args);
+    Job *job = m_jobs.value(jobId);
+    if (job) {
+        job->clonePath = options.path;
+        job->followUpArgs = options.sparseCheckoutArguments();
+    }
+    return jobId;
+}
+
+int RemoteManager::startJob(const QString &description, const QString &workingDirectory, const QStringList &args, const QString &batchRemote)
+{
+    Job *job = new Job;
+    job->id = m_nextJobId++;
+    job->description = description;
+    job->remote = batchRemote;
+    job->batch = !batchRemote.isEmpty();
+    job->cancelled = false;
+    job->finished = false;
+    job->process = new QProcess(this);
+    job->process->setWorkingDirectory(workingDirectory);
+    job->process->setProperty("jobId", job->id);
+    
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("GIT_TERMINAL_PROMPT", "0");
+    env.insert("LC_ALL", "C");
+    job->process->setProcessEnvironment(env);
+    
+    connect(job->process, &QProcess::started, this, &RemoteManager::onProcessStarted);
+    connect(job->process, &QProcess::readyReadStandardError, this, &RemoteManager::onReadyReadStandardError);
+    connect(job->process, &QProcess::finished, this, &RemoteManager::onProcessFinished);
+    connect(job->process, &QProcess::errorOccurred, this, &RemoteManager::onProcessError);
+    
+    m_jobs.insert(job->id, job);
+    if (!job->batch) {
+        emit jobStarted(job->id, description);
+    }
+    
+    const int jobId = job->id;
+    job->trace.begin(workingDirectory, args);
+    job->timer.start();
+    job->process->start("git", args);
+    return jobId;
+}
+
+bool RemoteManager::fetchAll(int maxConcurrent)
+{
+    if (!m_gitManager->isRepositoryOpen() || isFetchingAll()) return false;
+    
+    const QStringList remotes = m_gitManager->getRemotes();
+    if (remotes.isEmpty()) {
+        return false;
+    }
+    
+    m_fetchQueue = remotes;
+    m_fetchLimit = qMax(1, maxConcurrent);
+    m_fetchRunning = 0;
+    m_fetchSucceeded = 0;
+    m_fetchFailed = 0;
+    
+    emit fetchAllStarted(remotes);
+    startQueuedFetches();
+    return true;
+}
+
+bool RemoteManager::isFetchingAll() const
+{
+    return m_fetchRunning > 0 || !m_fetchQueue.isEmpty();
+}
+
+void RemoteManager::startQueuedFetches()
+{
+    while (m_fetchRunning < m_fetchLimit && !m_fetchQueue.isEmpty()) {
+        const QString remote = m_fetchQueue.takeFirst();
+        
+        QStringList args;
+        args << "fetch" << "--progress" << "--no-write-fetch-head" << remote;
+        
+        ++m_fetchRunning;
+        startJob("Fetch " + remote, m_gitManager->getRepositoryPath(), args, remote);
+    }
+}
+
+void RemoteManager::cancel(int jobId)
+{
+    Job *job = m_jobs.value(jobId);
+    if (!job || job->finished) {
+        return;
+    }
+    
+    stopJob(job);
+}
+
+void RemoteManager::cancelAll()
+{
+    for (Job *job : m_jobs) {
+        if (!job->finished) {
+            stopJob(job);
+        }
+    }
+}
+
+void RemoteManager::stopJob(Job *job)
+{
+    if (job->cancelled) {
+        return;
+    }
+    
+    job->cancelled = true;
+    QProcess *process = job->process;
+    process->terminate();
+    QTimer::singleShot(TerminateGracePeriodMs, process, [process]() {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+        }
+    });
+}
+
+bool RemoteManager::isRunning(int jobId) const
+{
+    Job *job = m_jobs.value(jobId);
+    return job && !job->finished;
+}
+
+bool RemoteManager::hasRunningJobs() const
+{
+    for (Job *job : m_jobs) {
+        if (!job->finished) {
+            return true;
+        }
+    }
+    return false;
+}
+
+qint64 RemoteManager::elapsed(int jobId) const
+{
+    Job *job = m_jobs.value(jobId);
+    return job ? job->timer.elapsed() : 0;
+}
+
+RemoteManager::Job *RemoteManager::jobForSender() const
+{
+    QObject *process = sender();
+    if (!process) {
+        return nullptr;
+    }
+    return m_jobs.value(process->property("jobId").toInt());
+}
+
+void RemoteManager::onProcessStarted()
+{
+    Job *job = jobForSender();
+    if (job) {
+        job->trace.markStarted();
+    }
+}
+
+void RemoteManager::onReadyReadStandardError()
+{
+    Job *job = jobForSender();
+    if (!job) {
+        return;
+    }
+    
+    const QByteArray data = job->process->readAllStandardError();
+    job->trace.addOutput(data.size());
+    const QList<GitProgressInfo> updates = job->parser.feed(data);
+    for (const GitProgressInfo &progress : updates) {
+        emit jobProgress(job->id, progress);
+        if (job->batch) {
+            emit fetchAllProgress(job->remote, progress);
+        }
+    }
+}
+
+void RemoteManager::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    Job *job = jobForSender();
+    if (!job || job->finished) {
+        return;
+    }
+    
+    const QByteArray data = job->process->readAllStandardError();
+    job->trace.addOutput(data.size() + job->process->readAllStandardOutput().size());
+    job->parser.feed(data);
+    job->parser.finish();
+    
+    const bool succeeded = !job->cancelled && exitStatus == QProcess::NormalExit && exitCode == 0;
+    job->trace.finish(exitCode, succeeded, succeeded ? QString() : job->cancelled ? QString("Cancelled") : job->parser.messages().join("\n"));
+    
+    if (!job->cancelled && exitStatus == QProcess::NormalExit && exitCode == 0 && !job->followUpArgs.isEmpty()) {
+        startFollowUp(job);
+        return;
+    }
+    
+    if (job->cancelled) {
+        finishJob(job, false, job->description + " cancelled");
+    } else if (exitStatus != QProcess::NormalExit || exitCode != 0) {
+        const QStringList messages = job->parser.messages();
+        finishJob(job, false, messages.isEmpty() ? job->description + " failed" : messages.join("\n"));
+    } else {
+        finishJob(job, true, QString("%1 finished in %2 s")
+            .arg(job->description)
+            .arg(job->timer.elapsed() / 1000.0, 0, 'f', 1));
+    }
+}
+
+void RemoteManager::startFollowUp(Job *job)
+{
+    const QStringList args = job->followUpArgs;
+    job->followUpArgs.clear();
+    
+    const int jobId = job->id;
+    QMetaObject::invokeMethod(this, [this, jobId, args]() {
+        Job *pending = m_jobs.value(jobId);
+        if (!pending || pending->finished) {
+            return;
+        }
+        
+        GitProgressInfo info;
+        info.phase = "Applying sparse checkout";
+        emit jobProgress(jobId, info);
+        
+        pending->process->setWorkingDirectory(pending->clonePath);
+        pending->trace.begin(pending->clonePath, args, pending->description);
+        pending->process->start("git", args);
+    }, Qt::QueuedConnection);
+}
+
+qint64 RemoteManager::directorySize(const QString &path)
+{
+    qint64 total = 0;
+    QDirIterator it(path, QDir::Files | QDir::Hidden | QDir::System | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        total += it.fileInfo().size();
+    }
+    return total;
+}
+
+void RemoteManager::onProcessError(QProcess::ProcessError error)
+{
+    Job *job = jobForSender();
+    if (!job || job->finished || error != QProcess::FailedToStart) {
+        return;
+    }
+    
+    job->trace.finish(-1, false, "Failed to start git: " + job->process->errorString());
+    finishJob(job, false, "Failed to start git: " + job->process->errorString());
+}
+
+void RemoteManager::finishJob(Job *job, bool success, const QString &message)
+{
+    job->finished = true;
+    m_jobs.remove(job->id);
+    job->process->deleteLater();
+    
+    const int jobId = job->id;
+    const bool batch = job->batch;
+    const QString remote = job->remote;
+    const QString clonePath = job->clonePath;
+    const qint64 elapsedMs = job->timer.elapsed();
+    delete job;
+    
+    emit jobFinished(jobId, success, message);
+    
+    if (!clonePath.isEmpty()) {
+        if (!success) {
+            emit cloneFinished(jobId, false, clonePath, elapsedMs, 0, message);
+            return;
+        }
+        
+        QPointer<RemoteManager> self(this);
+        QThreadPool::globalInstance()->start([self, jobId, clonePath, elapsedMs, message]() {
+            const qint64 diskBytes = directorySize(clonePath);
+            if (self) {
+                QMetaObject::invokeMethod(self, [self, jobId, clonePath, elapsedMs, diskBytes, message]() {
+                    if (self) {
+                        emit self->cloneFinished(jobId, true, clonePath, elapsedMs, diskBytes, message);
+                    }
+                }, Qt::QueuedConnection);
+            }
+        });
+        return;
+    }
+    
+    if (!batch) {
+        if (success) {
+            m_gitManager->notifyRepositoryChanged();
+        }
+        return;
+    }
+    
+    --m_fetchRunning;
+    if (success) {
+        ++m_fetchSucceeded;
+    } else {
+        ++m_fetchFailed;
+    }
+    emit fetchAllRemoteFinished(remote, success, message);
+    
+    startQueuedFetches();
+    if (m_fetchRunning == 0 && m_fetchQueue.isEmpty()) {
+        emit fetchAllFinished(m_fetchSucceeded, m_fetchFailed);
+        if (m_fetchSucceeded > 0) {
+            m_gitManager->notifyRepositoryChanged();
+        }
+    }
+}
+
+void RemoteManager::setupFetchAllDialog()
+{
+    m_fetchDialog = new QDialog();
+    m_fetchDialog->setWindowTitle("Fetch All Remotes");
+    m_fetchDialog->resize(600, 300);
+    
+    QVBoxLayout *layout = new QVBoxLayout(m_fetchDialog);
+    
+    m_fetchTree = new QTreeWidget;
+    m_fetchTree->setHeaderLabels({"Remote", "Progress", "Status"});
+    m_fetchTree->setRootIsDecorated(false);
+    m_fetchTree->header()->setSectionResizeMode(2, QHeaderView::Stretch);
+    
+    m_fetchSummaryLabel = new QLabel;
+    
+    QHBoxLayout *buttonLayout = new QHBoxLayout;
+    m_fetchStartButton = new QPushButton("Fetch All");
+    m_fetchCancelButton = new QPushButton("Cancel");
+    QPushButton *closeButton = new QPushButton("Close");
+    
+    buttonLayout->addWidget(m_fetchSummaryLabel);
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_fetchStartButton);
+    buttonLayout->addWidget(m_fetchCancelButton);
+    buttonLayout->addWidget(closeButton);
+    
+    layout->addWidget(m_fetchTree);
+    layout->addLayout(buttonLayout);
+    
+    connect(m_fetchStartButton, &QPushButton::clicked, this, &RemoteManager::startFetchAllFromDialog);
+    connect(m_fetchCancelButton, &QPushButton::clicked, this, [this]() {
+        m_fetchQueue.clear();
+        for (Job *job : m_jobs) {
+            if (job->batch) {
+                cancel(job->id);
+            }
+        }
+    });
+    connect(closeButton, &QPushButton::clicked, m_fetchDialog, &QDialog::hide);
+}
+
+void RemoteManager::showFetchAllDialog()
+{
+    if (!m_fetchDialog) {
+        setupFetchAllDialog();
+    }
+    
+    m_fetchDialog->show();
+    m_fetchDialog->raise();
+    
+    if (!isFetchingAll()) {
+        startFetchAllFromDialog();
+    }
+}
+
+void RemoteManager::startFetchAllFromDialog()
+{
+    QSettings settings;
+    const int limit = settings.value("remote/maxParallelFetches", 4).toInt();
+    
+    if (!fetchAll(limit) && m_fetchSummaryLabel && !isFetchingAll()) {
+        m_fetchSummaryLabel->setText("No remotes to fetch");
+    }
+}
+
+void RemoteManager::onFetchAllStarted(const QStringList &remotes)
+{
+    if (!m_fetchDialog) {
+        return;
+    }
+    
+    m_fetchTree->clear();
+    for (const QString &remote : remotes) {
+        QTreeWidgetItem *item = new QTreeWidgetItem(m_fetchTree, {remote, QString(), "Queued"});
+        QProgressBar *bar = new QProgressBar;
+        bar->setRange(0, 100);
+        bar->setValue(0);
+        m_fetchTree->setItemWidget(item, 1, bar);
+    }
+    
+    m_fetchSummaryLabel->setText(QString("Fetching %1 remotes, %2 at a time").arg(remotes.size()).arg(m_fetchLimit));
+    m_fetchStartButton->setEnabled(false);
+    m_fetchCancelButton->setEnabled(true);
+}
+
+void RemoteManager::onFetchAllProgress(const QString &remote, const GitProgressInfo &progress)
+{
+    if (!m_fetchDialog) {
+        return;
+    }
+    
+    const QList<QTreeWidgetItem*> items = m_fetchTree->findItems(remote, Qt::MatchExactly, 0);
+    if (items.isEmpty()) {
+        return;
+    }
+    
+    QTreeWidgetItem *item = items.first();
+    QProgressBar *bar = qobject_cast<QProgressBar*>(m_fetchTree->itemWidget(item, 1));
+    if (bar) {
+        if (progress.percent >= 0) {
+            bar->setRange(0, 100);
+            bar->setValue(progress.percent);
+        } else {
+            bar->setRange(0, 0);
+        }
+    }
+    item->setText(2, progress.toString());
+}
+
+void RemoteManager::onFetchAllRemoteFinished(const QString &remote, bool success, const QString &message)
+{
+    if (!m_fetchDialog) {
+        return;
+    }
+    
+    const QList<QTreeWidgetItem*> items = m_fetchTree->findItems(remote, Qt::MatchExactly, 0);
+    if (items.isEmpty()) {
+        return;
+    }
+    
+    QTreeWidgetItem *item = items.first();
+    QProgressBar *bar = qobject_cast<QProgressBar*>(m_fetchTree->itemWidget(item, 1));
+    if (bar) {
+        bar->setRange(0, 100);
+        bar->setValue(success ? 100 : 0);
+    }
+    item->setText(2, success ? message : "Failed: " + message.section('\n', 0, 0));
+    item->setToolTip(2, message);
+    item->setForeground(2, success ? QBrush() : QBrush(QColor(200, 0, 0)));
+}
+
+void RemoteManager::onFetchAllFinished(int succeeded, int failed)
 {
-}
\ No newline at end of file
+    if (!m_fetchDialog) {
+        return;
+    }
+    
+    m_fetchSummaryLabel->setText(QString("%1 succeeded, %2 failed").arg(succeeded).arg(failed));
+    m_fetchStartButton->setEnabled(true);
+    m_fetchCancelButton->setEnabled(false);
+}
@@ -2,8 +2,18 @@
 #define REMOTEMANAGER_H
 
 #include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include <QProcess>
+#include <QStringList>
+#include <QDialog>
+#include <QTreeWidget>
+#include <QPushButton>
+#include <QLabel>
+#include "gitprogress.h"
+#include "gitmanager.h"
+#include "gittracer.h"
 
-class GitManager;
 
 class RemoteManager : public QObject
 {
@@ -11,9 +21,85 @@ class RemoteManager : public QObject
 
 public:
     explicit RemoteManager(GitManager *gitManager, QObject *parent = nullptr);
+    ~RemoteManager();
+    
+    int startFetch(const QString &remote = "origin");
+    int startPull(const QString &remote = "origin", const QString &branch = "");
+    int startPush(const QString &remote = "origin", const QString &branch = "");
+    
+    int startClone(const GitCloneOptions &options);
+    
+    bool fetchAll(int maxConcurrent);
+    void showFetchAllDialog();
+    bool isFetchingAll() const;
+    
+    void cancel(int jobId);
+    void cancelAll();
+    bool isRunning(int jobId) const;
+    bool hasRunningJobs() const;
+    qint64 elapsed(int jobId) const;
+
+signals:
+    void jobStarted(int jobId, const QString &description);
+    void jobProgress(int jobId, const GitProgressInfo &progress);
+    void jobFinished(int jobId, bool success, const QString &message);
+    void cloneFinished(int jobId, bool success, const QString &path, qint64 elapsedMs, qint64 diskBytes, const QString &message);
+    void fetchAllStarted(const QStringList &remotes);
+    void fetchAllProgress(const QString &remote, const GitProgressInfo &progress);
+    void fetchAllRemoteFinished(const QString &remote, bool success, const QString &message);
+    void fetchAllFinished(int succeeded, int failed);
+
+private slots:
+    void onProcessStarted();
+    void onReadyReadStandardError();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessError(QProcess::ProcessError error);
+    void onFetchAllStarted(const QStringList &remotes);
+    void onFetchAllProgress(const QString &remote, const GitProgressInfo &progress);
+    void onFetchAllRemoteFinished(const QString &remote, bool success, const QString &message);
+    void onFetchAllFinished(int succeeded, int failed);
+    void startFetchAllFromDialog();
 
 private:
+    struct Job {
+        int id;
+        QString description;
+        QString remote;
+        bool batch;
+        QString clonePath;
+        QStringList followUpArgs;
+        QProcess *process;
+        GitProgressParser parser;
+        QElapsedTimer timer;
+        GitProcessTrace trace;
+        bool cancelled;
+        bool finished;
+    };
+    
+    int startJob(const QString &description, const QString &workingDirectory, const QStringList &args, const QString &batchRemote = QString());
+    Job *jobForSender() const;
+    void finishJob(Job *job, bool success, const QString &message);
+    void stopJob(Job *job);
+    void startQueuedFetches();
+    void startFollowUp(Job *job);
+    static qint64 directorySize(const QString &path);
+    void setupFetchAllDialog();
+    
     GitManager *m_gitManager;
+    QHash<int, Job*> m_jobs;
+    int m_nextJobId;
+    
+    QStringList m_fetchQueue;
+    int m_fetchLimit;
+    int m_fetchRunning;
+    int m_fetchSucceeded;
+    int m_fetchFailed;
+    
+    QDialog *m_fetchDialog;
+    QTreeWidget *m_fetchTree;
+    QLabel *m_fetchSummaryLabel;
+    QPushButton *m_fetchStartButton;
+    QPushButton *m_fetchCancelButton;
 };
 
-#endif // REMOTEMANAGER_H
\ No newline at end of file
+#endif // REMOTEMANAGER_H
@@ -1,25 +1,44 @@
 #include "repositorybrowser.h"
 #include "gitmanager.h"
+#include "gittracer.h"
+#include "gitrefwatcher.h"
+#include "gitfsmonitor.h"
 #include <QHeaderView>
 #include <QDesktopServices>
 #include <QUrl>
 #include <QMessageBox>
-#include <QIcon>
-#include <QFileInfo>
+#include <QInputDialog>
+
+namespace {
+
+const int SubmodulePathRole = Qt::UserRole + 1;
+
+}
 
 RepositoryBrowser::RepositoryBrowser(GitManager *gitManager, QWidget *parent)
     : QWidget(parent)
     , m_gitManager(gitManager)
     , m_treeView(nullptr)
     , m_model(nullptr)
+    , m_index(nullptr)
     , m_titleLabel(nullptr)
     , m_refreshButton(nullptr)
     , m_contextMenu(nullptr)
+    , m_submoduleMenu(nullptr)
+    , m_submodulesItem(nullptr)
+    , m_submodulesStatusItem(nullptr)
+    , m_submoduleScanMs(-1)
 {
     setupUI();
     
     connect(m_gitManager, &GitManager::repositoryChanged, this, &RepositoryBrowser::refresh);
-    connect(m_gitManager, &GitManager::fileStatusChanged, this, &RepositoryBrowser::refresh);
+    connect(m_gitManager, &GitManager::fileStatusChanged, this, &RepositoryBrowser::refreshStatus);
+}
+
+RepositoryBrowser::~RepositoryBrowser()
+{
+    clearSubmodules();
+    delete m_index;
 }
 
 void RepositoryBrowser::setupUI()
@@ -43,6 +62,7 @@ void RepositoryBrowser::setupUI()
     m_treeView = new QTreeView;
     m_model = new QStandardItemModel(this);
     m_model->setHorizontalHeaderLabels({"File", "Status"});
+    m_index = new FileTreeIndex(m_model);
     
     m_treeView->setModel(m_model);
     m_treeView->setContextMenuPolicy(Qt::CustomContextMenu);
@@ -66,170 +86,365 @@ void RepositoryBrowser::setupUI()
     m_discardAction = m_contextMenu->addAction("Discard Changes");
     m_contextMenu->addSeparator();
     m_openAction = m_contextMenu->addAction("Open File");
+    m_viewAction = m_contextMenu->addAction("View File");
+    m_viewRevisionAction = m_contextMenu->addAction("View at Revision...");
     
     connect(m_stageAction, &QAction::triggered, this, &RepositoryBrowser::stageFile);
     connect(m_unstageAction, &QAction::triggered, this, &RepositoryBrowser::unstageFile);
     connect(m_discardAction, &QAction::triggered, this, &RepositoryBrowser::discardChanges);
     connect(m_openAction, &QAction::triggered, this, &RepositoryBrowser::openFile);
+    connect(m_viewAction, &QAction::triggered, this, &RepositoryBrowser::viewFile);
+    connect(m_viewRevisionAction, &QAction::triggered, this, &RepositoryBrowser::viewFileAtRevision);
+    
+    m_submoduleMenu = new QMenu(this);
+    QAction *refreshSubmoduleAction = m_submoduleMenu->addAction("Refresh Submodule");
+    QAction *openSubmoduleAction = m_submoduleMenu->addAction("Open Submodule");
+    
+    connect(refreshSubmoduleAction, &QAction::triggered, this, &RepositoryBrowser::refreshSelectedSubmodule);
+    connect(openSubmoduleAction, &QAction::triggered, this, &RepositoryBrowser::openSelectedSubmodule);
 }
 
 void RepositoryBrowser::refresh()
+{
+    refreshStatus();
+    refreshSubmodules();
+}
+
+void RepositoryBrowser::refreshStatus()
 {
     if (!m_gitManager->isRepositoryOpen()) {
-        m_model->clear();
-        m_model->setHorizontalHeaderLabels({"File", "Status"});
+        m_index->clear();
+        m_files.clear();
         return;
     }
     
-    populateTree();
+    m_gitManager->requestFileStatus(this, [this](const QList<GitFileStatus> &files) {
+        populateTree(files);
+        emit refreshed();
+    });
 }
 
-void RepositoryBrowser::populateTree()
+void RepositoryBrowser::refreshSubmodules()
 {
-    m_model->clear();
-    m_model->setHorizontalHeaderLabels({"File", "Status"});
+    if (!m_gitManager->isRepositoryOpen()) {
+        clearSubmodules();
+        return;
+    }
     
-    QStandardItem *rootItem = m_model->invisibleRootItem();
+    m_gitManager->requestSubmodules(this, [this](const QList<GitSubmodule> &submodules) {
+        updateSubmodules(submodules);
+    });
+}
+
+void RepositoryBrowser::refreshSubmodule(const QString &path)
+{
+    SubmoduleNode *node = m_submodules.value(path);
+    if (!node) {
+        return;
+    }
     
-    QList<GitFileStatus> files = m_gitManager->getFileStatus();
+    if (!node->submodule.initialized) {
+        updateSubmoduleLabel(node);
+        return;
+    }
     
-    for (const GitFileStatus &file : files) {
-        addFileToTree(file.filePath, file.status, rootItem);
+    if (m_scanningSubmodules.isEmpty()) {
+        m_submoduleScanTimer.start();
+    }
+    m_scanningSubmodules.insert(path);
+    if (node->status.path.isEmpty()) {
+        node->statusItem->setText("Scanning...");
     }
     
-    m_treeView->expandAll();
+    m_gitManager->requestSubmoduleStatus(path, this, [this](const GitSubmoduleStatus &status) {
+        onSubmoduleScanned(status);
+    });
 }
 
-void RepositoryBrowser::addFileToTree(const QString &filePath, const QString &status, QStandardItem *parent)
+void RepositoryBrowser::updateSubmodules(const QList<GitSubmodule> &submodules)
 {
-    QStringList pathParts = filePath.split('/', Qt::SkipEmptyParts);
-    QStandardItem *currentParent = parent ? parent : m_model->invisibleRootItem();
-    
-    for (int i = 0; i < pathParts.size() - 1; ++i) {
-        currentParent = findOrCreatePath(pathParts[i], currentParent);
-    }
-    
-    QStandardItem *fileItem = new QStandardItem(pathParts.last());
-    QStandardItem *statusItem = new QStandardItem(status);
-    
-    QFileInfo fileInfo(filePath);
-    if (fileInfo.isFile()) {
-        QString extension = fileInfo.suffix().toLower();
-        if (extension == "cpp" || extension == "cc" || extension == "cxx") {
-            fileItem->setIcon(QIcon(":/icons/cpp.png"));
-        } else if (extension == "h" || extension == "hpp") {
-            fileItem->setIcon(QIcon(":/icons/header.png"));
-        } else if (extension == "txt") {
-            fileItem->setIcon(QIcon(":/icons/text.png"));
-        } else {
-            fileItem->setIcon(QIcon(":/icons/file.png"));
+    GitTraceSpan span("model", "RepositoryBrowser::updateSubmodules");
+    span.setItemCount(submodules.size());
+    
+    if (m_submoduleRepository != m_gitManager->getRepositoryPath()) {
+        clearSubmodules();
+        m_submoduleRepository = m_gitManager->getRepositoryPath();
+    }
+    
+    if (submodules.isEmpty()) {
+        clearSubmodules();
+        return;
+    }
+    
+    QSet<QString> paths;
+    for (const GitSubmodule &submodule : submodules) {
+        paths.insert(submodule.path);
+    }
+    for (const QString &path : m_submodules.keys()) {
+        if (!paths.contains(path)) {
+            removeSubmodule(path);
         }
-    } else {
-        fileItem->setIcon(QIcon(":/icons/folder.png"));
     }
     
-    fileItem->setData(filePath, Qt::UserRole);
-    statusItem->setData(status, Qt::UserRole);
+    if (!m_submodulesItem) {
+        m_submodulesItem = new QStandardItem("Submodules");
+        m_submodulesItem->setIcon(QIcon(":/icons/folder.png"));
+        m_submodulesStatusItem = new QStandardItem;
+        m_model->insertRow(0, {m_submodulesItem, m_submodulesStatusItem});
+        m_treeView->expand(m_submodulesItem->index());
+    }
     
-    if (status.contains('M')) {
-        statusItem->setBackground(QBrush(QColor(255, 255, 0, 100)));
-    } else if (status.contains('A')) {
-        statusItem->setBackground(QBrush(QColor(0, 255, 0, 100)));
-    } else if (status.contains('D')) {
-        statusItem->setBackground(QBrush(QColor(255, 0, 0, 100)));
-    } else if (status.contains('?')) {
-        statusItem->setBackground(QBrush(QColor(128, 128, 128, 100)));
+    for (const GitSubmodule &submodule : submodules) {
+        SubmoduleNode *node = m_submodules.value(submodule.path);
+        if (!node) {
+            node = new SubmoduleNode;
+            node->item = new QStandardItem(submodule.path);
+            node->item->setIcon(QIcon(":/icons/folder.png"));
+            node->item->setData(submodule.path, SubmodulePathRole);
+            node->statusItem = new QStandardItem;
+            node->index = new FileTreeIndex(m_model, node->item);
+            node->watcher = nullptr;
+            m_submodulesItem->appendRow({node->item, node->statusItem});
+            m_submodules.insert(submodule.path, node);
+        }
+        node->submodule = submodule;
+        
+        if (submodule.initialized && !node->watcher) {
+            const QString path = submodule.path;
+            node->watcher = new GitRefWatcher(this);
+            node->watcher->setRepository(GitFsMonitor::resolveGitDirectory(QDir(m_submoduleRepository).filePath(path)));
+            connect(node->watcher, &GitRefWatcher::changed, this, [this, path](GitRefWatcher::Changes changes) {
+                refreshSubmodule(path);
+                if (changes & GitRefWatcher::HeadMoved) {
+                    refreshStatus();
+                }
+            });
+        }
+        
+        refreshSubmodule(submodule.path);
     }
     
-    currentParent->appendRow({fileItem, statusItem});
+    updateSubmoduleSummary();
 }
 
-QStandardItem *RepositoryBrowser::findOrCreatePath(const QString &path, QStandardItem *parent)
+void RepositoryBrowser::removeSubmodule(const QString &path)
 {
-    QStandardItem *currentParent = parent ? parent : m_model->invisibleRootItem();
+    SubmoduleNode *node = m_submodules.take(path);
+    if (!node) {
+        return;
+    }
     
-    for (int i = 0; i < currentParent->rowCount(); ++i) {
-        QStandardItem *child = currentParent->child(i, 0);
-        if (child && child->text() == path) {
-            return child;
-        }
+    m_scanningSubmodules.remove(path);
+    delete node->watcher;
+    delete node->index;
+    m_submodulesItem->removeRow(node->item->row());
+    delete node;
+}
+
+void RepositoryBrowser::clearSubmodules()
+{
+    const QStringList paths = m_submodules.keys();
+    for (const QString &path : paths) {
+        removeSubmodule(path);
+    }
+    
+    if (m_submodulesItem) {
+        m_model->removeRow(m_submodulesItem->row());
+        m_submodulesItem = nullptr;
+        m_submodulesStatusItem = nullptr;
+    }
+    m_scanningSubmodules.clear();
+    m_submoduleScanMs = -1;
+}
+
+void RepositoryBrowser::onSubmoduleScanned(const GitSubmoduleStatus &status)
+{
+    m_scanningSubmodules.remove(status.path);
+    if (m_scanningSubmodules.isEmpty()) {
+        m_submoduleScanMs = m_submoduleScanTimer.elapsed();
     }
     
-    QStandardItem *newItem = new QStandardItem(path);
-    QStandardItem *statusItem = new QStandardItem("");
-    newItem->setIcon(QIcon(":/icons/folder.png"));
+    SubmoduleNode *node = m_submodules.value(status.path);
+    if (node) {
+        GitTraceSpan span("model", "RepositoryBrowser::onSubmoduleScanned");
+        span.setItemCount(status.files.size());
+        
+        node->status = status;
+        node->index->update(status.files);
+        updateSubmoduleLabel(node);
+    }
     
-    currentParent->appendRow({newItem, statusItem});
-    return newItem;
+    updateSubmoduleSummary();
 }
 
-void RepositoryBrowser::onItemClicked(const QModelIndex &index)
+void RepositoryBrowser::updateSubmoduleLabel(SubmoduleNode *node)
 {
-    if (index.isValid()) {
-        QStandardItem *item = m_model->itemFromIndex(index);
-        if (item) {
-            QString filePath = item->data(Qt::UserRole).toString();
-            if (!filePath.isEmpty()) {
-                m_selectedFile = filePath;
-                emit fileSelected(filePath);
-            }
+    QString text;
+    if (!node->submodule.initialized) {
+        text = "not initialized";
+    } else if (!node->status.success) {
+        text = "status failed: " + node->status.error.trimmed().section('\n', 0, 0);
+    } else {
+        const GitRepositorySummary &summary = node->status.summary;
+        QString branch = summary.branch;
+        if (branch.isEmpty() || branch == "(detached)") {
+            branch = "detached at " + node->status.headCommit.left(7);
         }
+        if (!summary.upstream.isEmpty()) {
+            branch += QString(" +%1 -%2").arg(summary.ahead).arg(summary.behind);
+        }
+        
+        QStringList parts = {branch};
+        const QString changes = node->index->changeSummary();
+        if (!changes.isEmpty()) {
+            parts.append(changes);
+        }
+        text = parts.join(", ");
     }
+    
+    node->statusItem->setText(text);
+    node->item->setToolTip(node->submodule.url);
 }
 
-void RepositoryBrowser::onItemDoubleClicked(const QModelIndex &index)
+void RepositoryBrowser::updateSubmoduleSummary()
 {
-    if (index.isValid()) {
-        QStandardItem *item = m_model->itemFromIndex(index);
-        if (item) {
-            QString filePath = item->data(Qt::UserRole).toString();
-            if (!filePath.isEmpty()) {
-                emit fileDoubleClicked(filePath);
-            }
+    if (!m_submodulesStatusItem) {
+        return;
+    }
+    
+    int dirty = 0;
+    for (const SubmoduleNode *node : std::as_const(m_submodules)) {
+        if (node->index->fileCount() > 0) {
+            ++dirty;
         }
     }
+    
+    QString text = QString("%1 submodules").arg(m_submodules.size());
+    if (dirty > 0) {
+        text += QString(", %1 with changes").arg(dirty);
+    }
+    if (!m_scanningSubmodules.isEmpty()) {
+        text += QString(", scanning %1...").arg(m_scanningSubmodules.size());
+    } else if (m_submoduleScanMs >= 0) {
+        text += QString(", scanned in %1 ms").arg(m_submoduleScanMs);
+    }
+    m_submodulesStatusItem->setText(text);
 }
 
-void RepositoryBrowser::showContextMenu(const QPoint &point)
+void RepositoryBrowser::showFiles(const QList<GitFileStatus> &files)
 {
-    QModelIndex index = m_treeView->indexAt(point);
-    if (index.isValid()) {
-        QStandardItem *item = m_model->itemFromIndex(index);
-        if (item) {
-            QString filePath = item->data(Qt::UserRole).toString();
-            if (!filePath.isEmpty()) {
-                m_selectedFile = filePath;
-                
-                QString status = getFileStatus(filePath);
-                m_stageAction->setEnabled(!status.isEmpty() && !status.at(0).isSpace());
-                m_unstageAction->setEnabled(!status.isEmpty() && status.at(0) != ' ' && status.at(0) != '?');
-                m_discardAction->setEnabled(!status.isEmpty() && status.contains('M'));
-                
-                m_contextMenu->exec(m_treeView->mapToGlobal(point));
-            }
+    populateTree(files);
+}
+
+QList<GitFileStatus> RepositoryBrowser::files() const
+{
+    return m_files;
+}
+
+void RepositoryBrowser::populateTree(const QList<GitFileStatus> &files)
+{
+    GitTraceSpan span("model", "RepositoryBrowser::populateTree");
+    span.setItemCount(files.size());
+    
+    m_files = files;
+    m_index->update(files);
+    
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        QStandardItem *item = m_model->item(row);
+        if (item != m_submodulesItem) {
+            m_treeView->expandRecursively(item->index());
         }
     }
 }
 
-QString RepositoryBrowser::getFileStatus(const QString &filePath) const
+QString RepositoryBrowser::fileForIndex(const QModelIndex &index) const
 {
-    QList<GitFileStatus> files = m_gitManager->getFileStatus();
+    if (!index.isValid() || !submoduleForIndex(index).isEmpty()) {
+        return QString();
+    }
     
-    for (const GitFileStatus &file : files) {
-        if (file.filePath == filePath) {
-            return file.status;
+    QStandardItem *item = m_model->itemFromIndex(index);
+    return item ? item->data(Qt::UserRole).toString() : QString();
+}
+
+QString RepositoryBrowser::submoduleForIndex(const QModelIndex &index) const
+{
+    for (QModelIndex current = index.siblingAtColumn(0); current.isValid(); current = current.parent()) {
+        const QString path = current.data(SubmodulePathRole).toString();
+        if (!path.isEmpty()) {
+            return path;
         }
     }
-    
     return QString();
 }
 
+void RepositoryBrowser::onItemClicked(const QModelIndex &index)
+{
+    QString filePath = fileForIndex(index);
+    if (!filePath.isEmpty()) {
+        m_selectedFile = filePath;
+        emit fileSelected(filePath);
+    }
+}
+
+void RepositoryBrowser::onItemDoubleClicked(const QModelIndex &index)
+{
+    QString filePath = fileForIndex(index);
+    if (!filePath.isEmpty()) {
+        emit fileDoubleClicked(filePath);
+    }
+}
+
+void RepositoryBrowser::showContextMenu(const QPoint &point)
+{
+    QModelIndex index = m_treeView->indexAt(point);
+    
+    const QString submodule = submoduleForIndex(index);
+    if (!submodule.isEmpty()) {
+        m_selectedSubmodule = submodule;
+        m_submoduleMenu->exec(m_treeView->mapToGlobal(point));
+        return;
+    }
+    
+    QString filePath = fileForIndex(index);
+    if (!filePath.isEmpty()) {
+        m_selectedFile = filePath;
+        
+        QString status = getFileStatus(filePath);
+        m_stageAction->setEnabled(!status.isEmpty() && !status.at(0).isSpace());
+        m_unstageAction->setEnabled(!status.isEmpty() && status.at(0) != ' ' && status.at(0) != '?');
+        m_discardAction->setEnabled(!status.isEmpty() && status.contains('M'));
+        
+        m_contextMenu->exec(m_treeView->mapToGlobal(point));
+    }
+}
+
+void RepositoryBrowser::refreshSelectedSubmodule()
+{
+    if (!m_selectedSubmodule.isEmpty()) {
+        refreshSubmodule(m_selectedSubmodule);
+        updateSubmoduleSummary();
+    }
+}
+
+void RepositoryBrowser::openSelectedSubmodule()
+{
+    if (!m_selectedSubmodule.isEmpty()) {
+        emit submoduleOpenRequested(QDir(m_gitManager->getRepositoryPath()).filePath(m_selectedSubmodule));
+    }
+}
+
+QString RepositoryBrowser::getFileStatus(const QString &filePath) const
+{
+    return m_index->status(filePath);
+}
+
 void RepositoryBrowser::stageFile()
 {
+    GitTraceAction action("Stage file");
+    
     if (!m_selectedFile.isEmpty()) {
-        if (m_gitManager->stageFile(m_selectedFile)) {
-            refresh();
-        } else {
+        if (!m_gitManager->stageFile(m_selectedFile)) {
             QMessageBox::warning(this, "Error", "Failed to stage file: " + m_gitManager->getLastError());
         }
     }
@@ -237,10 +452,10 @@ void RepositoryBrowser::stageFile()
 
 void RepositoryBrowser::unstageFile()
 {
+    GitTraceAction action("Unstage file");
+    
     if (!m_selectedFile.isEmpty()) {
-        if (m_gitManager->unstageFile(m_selectedFile)) {
-            refresh();
-        } else {
+        if (!m_gitManager->unstageFile(m_selectedFile)) {
             QMessageBox::warning(this, "Error", "Failed to unstage file: " + m_gitManager->getLastError());
         }
     }
@@ -248,6 +463,8 @@ void RepositoryBrowser::unstageFile()
 
 void RepositoryBrowser::discardChanges()
 {
+    GitTraceAction action("Discard changes");
+    
     if (!m_selectedFile.isEmpty()) {
         int ret = QMessageBox::question(this, "Discard Changes", 
             "Are you sure you want to discard changes to " + m_selectedFile + "?\nThis action cannot be undone.",
@@ -265,4 +482,24 @@ void RepositoryBrowser::openFile()
         QString fullPath = m_gitManager->getRepositoryPath() + "/" + m_selectedFile;
         QDesktopServices::openUrl(QUrl::fromLocalFile(fullPath));
     }
+}
+
+void RepositoryBrowser::viewFile()
+{
+    if (!m_selectedFile.isEmpty()) {
+        emit fileViewRequested(m_selectedFile, QString());
+    }
+}
+
+void RepositoryBrowser::viewFileAtRevision()
+{
+    if (m_selectedFile.isEmpty()) {
+        return;
+    }
+    
+    bool ok = false;
+    QString revision = QInputDialog::getText(this, "View at Revision", "Revision:", QLineEdit::Normal, "HEAD", &ok).trimmed();
+    if (ok && !revision.isEmpty()) {
+        emit fileViewRequested(m_selectedFile, revision);
+    }
 }
\ No newline at end of file
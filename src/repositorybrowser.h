@@ -11,8 +11,12 @@
 #include <QMenu>
 #include <QAction>
 #include <QContextMenuEvent>
+#include <QElapsedTimer>
+#include <QSet>
+#include "gitmanager.h"
+#include "filetreeindex.h"
 
-class GitManager;
+class GitRefWatcher;
 
 class RepositoryBrowser : public QWidget
 {
@@ -20,12 +24,21 @@ class RepositoryBrowser : public QWidget
 
 public:
     explicit RepositoryBrowser(GitManager *gitManager, QWidget *parent = nullptr);
+    ~RepositoryBrowser();
     
     void refresh();
+    void refreshStatus();
+    void refreshSubmodules();
+    void refreshSubmodule(const QString &path);
+    void showFiles(const QList<GitFileStatus> &files);
+    QList<GitFileStatus> files() const;
 
 signals:
+    void refreshed();
     void fileSelected(const QString &filePath);
     void fileDoubleClicked(const QString &filePath);
+    void fileViewRequested(const QString &filePath, const QString &revision);
+    void submoduleOpenRequested(const QString &path);
 
 private slots:
     void onItemClicked(const QModelIndex &index);
@@ -35,17 +48,37 @@ private slots:
     void unstageFile();
     void discardChanges();
     void openFile();
+    void viewFile();
+    void viewFileAtRevision();
+    void refreshSelectedSubmodule();
+    void openSelectedSubmodule();
 
 private:
+    struct SubmoduleNode {
+        GitSubmodule submodule;
+        GitSubmoduleStatus status;
+        QStandardItem *item;
+        QStandardItem *statusItem;
+        FileTreeIndex *index;
+        GitRefWatcher *watcher;
+    };
+    
     void setupUI();
-    void populateTree();
-    void addFileToTree(const QString &filePath, const QString &status, QStandardItem *parent = nullptr);
+    void populateTree(const QList<GitFileStatus> &files);
     QString getFileStatus(const QString &filePath) const;
-    QStandardItem *findOrCreatePath(const QString &path, QStandardItem *parent = nullptr);
+    QString fileForIndex(const QModelIndex &index) const;
+    QString submoduleForIndex(const QModelIndex &index) const;
+    void updateSubmodules(const QList<GitSubmodule> &submodules);
+    void removeSubmodule(const QString &path);
+    void clearSubmodules();
+    void onSubmoduleScanned(const GitSubmoduleStatus &status);
+    void updateSubmoduleLabel(SubmoduleNode *node);
+    void updateSubmoduleSummary();
     
     GitManager *m_gitManager;
     QTreeView *m_treeView;
     QStandardItemModel *m_model;
+    FileTreeIndex *m_index;
     QLabel *m_titleLabel;
     QPushButton *m_refreshButton;
     
@@ -54,8 +87,21 @@ private:
     QAction *m_unstageAction;
     QAction *m_discardAction;
     QAction *m_openAction;
+    QAction *m_viewAction;
+    QAction *m_viewRevisionAction;
+    QMenu *m_submoduleMenu;
     
     QString m_selectedFile;
+    QString m_selectedSubmodule;
+    QList<GitFileStatus> m_files;
+    
+    QStandardItem *m_submodulesItem;
+    QStandardItem *m_submodulesStatusItem;
+    QHash<QString, SubmoduleNode*> m_submodules;
+    QSet<QString> m_scanningSubmodules;
+    QString m_submoduleRepository;
+    QElapsedTimer m_submoduleScanTimer;
+    qint64 m_submoduleScanMs;
 };
 
 #endif // REPOSITORYBROWSER_H
\ No newline at end of file
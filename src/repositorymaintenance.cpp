@@ -0,0 +1,607 @@
+#include "repositorymaintenance.h"
+#include "gitcommandscheduler.h"
+#include "gitmanager.h"
+#include "gittracer.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QSettings>
+#include <QThreadPool>
+#include <algorithm>
+
+namespace {
+
+const int DefaultIdleIntervalMs = 2 * 60 * 1000;
+const qint64 BackoffBaseSecs = 10 * 60;
+const qint64 BackoffMaximumSecs = 24 * 60 * 60;
+const int LooseObjectWarning = 6700;
+const int PackCountWarning = 50;
+const qint64 IndexSizeWarning = 64 * 1024 * 1024;
+const int LooseRefWarning = 1000;
+const int BenchmarkSamples = 5;
+
+qint64 medianOf(QList<qint64> samples)
+{
+    if (samples.isEmpty() || samples.contains(-1)) {
+        return -1;
+    }
+    std::sort(samples.begin(), samples.end());
+    const int middle = int(samples.size()) / 2;
+    return samples.size() % 2 ? samples.at(middle) : (samples.at(middle - 1) + samples.at(middle)) / 2;
+}
+
+}
+
+RepositoryHealth::RepositoryHealth()
+    : looseObjects(0)
+    , looseBytes(0)
+    , packCount(0)
+    , packBytes(0)
+    , garbageFiles(0)
+    , indexBytes(0)
+    , looseRefs(0)
+    , hasCommitGraph(false)
+    , hasMultiPackIndex(false)
+    , valid(false)
+{
+}
+
+QStringList RepositoryHealth::warnings() const
+{
+    QStringList result;
+    if (!valid) {
+        return result;
+    }
+    
+    if (looseObjects >= LooseObjectWarning) {
+        result << QString("%1 loose objects should be packed").arg(looseObjects);
+    }
+    if (packCount >= PackCountWarning) {
+        result << QString("%1 pack files slow down every object lookup").arg(packCount);
+    }
+    if (garbageFiles > 0) {
+        result << QString("%1 garbage files in the object directory").arg(garbageFiles);
+    }
+    if (indexBytes >= IndexSizeWarning) {
+        result << QString("The index is %1 MB and is rewritten by many commands").arg(indexBytes / (1024 * 1024));
+    }
+    if (looseRefs >= LooseRefWarning) {
+        result << QString("%1 loose refs should be packed").arg(looseRefs);
+    }
+    if (!hasCommitGraph && (packCount > 0 || looseObjects > 0)) {
+        result << "No commit-graph; history queries parse every commit";
+    }
+    return result;
+}
+
+MaintenanceTiming::MaintenanceTiming()
+    : statusMs(-1)
+    , logMs(-1)
+{
+}
+
+bool MaintenanceTiming::isValid() const
+{
+    return statusMs >= 0 && logMs >= 0;
+}
+
+RepositoryMaintenance::RepositoryMaintenance(GitCommandScheduler *scheduler, QObject *parent)
+    : QObject(parent)
+    , m_scheduler(scheduler)
+    , m_enabled(false)
+    , m_requestId(0)
+    , m_running(false)
+    , m_forced(false)
+    , m_stopRequested(false)
+    , m_currentTask(TaskCount)
+{
+    for (TaskRecord &record : m_records) {
+        record.failures = 0;
+    }
+    
+    m_idleTimer.setSingleShot(true);
+    m_idleTimer.setInterval(DefaultIdleIntervalMs);
+    connect(&m_idleTimer, &QTimer::timeout, this, &RepositoryMaintenance::onIdle);
+}
+
+RepositoryMaintenance::~RepositoryMaintenance()
+{
+    if (m_scheduler && m_requestId) {
+        m_scheduler->cancel(m_requestId);
+    }
+}
+
+void RepositoryMaintenance::setRepository(const QString &path)
+{
+    if (path == m_repositoryPath) {
+        return;
+    }
+    
+    cancel();
+    m_repositoryPath = path;
+    m_health = RepositoryHealth();
+    m_before = MaintenanceTiming();
+    m_after = MaintenanceTiming();
+    loadRecords();
+    checkHealth();
+    
+    if (m_enabled) {
+        m_idleTimer.start();
+    }
+}
+
+QString RepositoryMaintenance::repository() const
+{
+    return m_repositoryPath;
+}
+
+void RepositoryMaintenance::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (enabled) {
+        m_idleTimer.start();
+    } else {
+        m_idleTimer.stop();
+        if (m_running && !m_forced) {
+            requestStop();
+        }
+    }
+}
+
+bool RepositoryMaintenance::isEnabled() const
+{
+    return m_enabled;
+}
+
+void RepositoryMaintenance::setIdleInterval(int ms)
+{
+    m_idleTimer.setInterval(ms);
+}
+
+void RepositoryMaintenance::notifyActivity()
+{
+    if (m_running && !m_forced) {
+        requestStop();
+    }
+    if (m_enabled) {
+        m_idleTimer.start();
+    }
+}
+
+void RepositoryMaintenance::requestStop()
+{
+    m_stopRequested = true;
+}
+
+void RepositoryMaintenance::runNow()
+{
+    startRun(true);
+}
+
+void RepositoryMaintenance::cancel()
+{
+    if (!m_running) {
+        return;
+    }
+    
+    if (m_scheduler && m_requestId) {
+        m_scheduler->cancel(m_requestId);
+    }
+    m_requestId = 0;
+    
+    if (!m_steps.isEmpty() && m_steps.first().kind == TaskStep) {
+        const Task task = m_steps.first().task;
+        recordTask(task, false, "Cancelled");
+        emit taskFinished(task, false, m_taskTimer.elapsed());
+    }
+    
+    finishRun(false);
+}
+
+bool RepositoryMaintenance::isRunning() const
+{
+    return m_running;
+}
+
+void RepositoryMaintenance::checkHealth()
+{
+    if (m_repositoryPath.isEmpty()) {
+        return;
+    }
+    
+    const QString repositoryPath = m_repositoryPath;
+    const QString action = GitTracer::currentAction();
+    QPointer<RepositoryMaintenance> self(this);
+    
+    QThreadPool::globalInstance()->start([self, repositoryPath, action]() {
+        GitTraceAction traceAction(action);
+        RepositoryHealth health;
+        loadHealth(repositoryPath, health);
+        
+        if (self) {
+            QMetaObject::invokeMethod(self, [self, repositoryPath, health]() {
+                if (self && self->m_repositoryPath == repositoryPath) {
+                    self->m_health = health;
+                    emit self->healthChanged(health);
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
+}
+
+RepositoryHealth RepositoryMaintenance::health() const
+{
+    return m_health;
+}
+
+MaintenanceTiming RepositoryMaintenance::timingBefore() const
+{
+    return m_before;
+}
+
+MaintenanceTiming RepositoryMaintenance::timingAfter() const
+{
+    return m_after;
+}
+
+QDateTime RepositoryMaintenance::lastRun(Task task) const
+{
+    return m_records[task].lastRun;
+}
+
+QDateTime RepositoryMaintenance::nextDue(Task task) const
+{
+    return m_records[task].nextDue;
+}
+
+int RepositoryMaintenance::failureCount(Task task) const
+{
+    return m_records[task].failures;
+}
+
+QString RepositoryMaintenance::lastError(Task task) const
+{
+    return m_records[task].error;
+}
+
+QString RepositoryMaintenance::taskName(Task task)
+{
+    switch (task) {
+    case CommitGraph: return "Commit-graph";
+    case MultiPackIndex: return "Multi-pack-index";
+    case IncrementalRepack: return "Incremental repack";
+    case PackRefs: return "Pack refs";
+    case LooseObjects: return "Loose objects";
+    default: return QString();
+    }
+}
+
+QList<QStringList> RepositoryMaintenance::taskCommands(Task task)
+{
+    switch (task) {
+    case CommitGraph:
+        return {{"commit-graph", "write", "--reachable", "--changed-paths", "--split", "--no-progress"}};
+    case MultiPackIndex:
+        return {{"multi-pack-index", "write", "--no-progress"}};
+    case IncrementalRepack:
+        return {{"multi-pack-index", "expire", "--no-progress"},
+                {"multi-pack-index", "repack", "--no-progress", "--batch-size=2g"}};
+    case PackRefs:
+        return {{"pack-refs", "--all", "--prune"}};
+    case LooseObjects:
+        return {{"repack", "-d", "-l", "-q"}};
+    default:
+        return {};
+    }
+}
+
+bool RepositoryMaintenance::loadHealth(const QString &workingDirectory, RepositoryHealth &health)
+{
+    QString output;
+    if (!GitManager::runGitCommand(workingDirectory, {"count-objects", "-v"}, output)) {
+        return false;
+    }
+    
+    for (const QString &line : output.split('\n', Qt::SkipEmptyParts)) {
+        const int colon = line.indexOf(':');
+        if (colon < 0) {
+            continue;
+        }
+        const QString key = line.left(colon);
+        const qint64 value = line.mid(colon + 1).trimmed().toLongLong();
+        if (key == "count") {
+            health.looseObjects = int(value);
+        } else if (key == "size") {
+            health.looseBytes = value * 1024;
+        } else if (key == "packs") {
+            health.packCount = int(value);
+        } else if (key == "size-pack") {
+            health.packBytes = value * 1024;
+        } else if (key == "garbage") {
+            health.garbageFiles = int(value);
+        }
+    }
+    
+    if (!GitManager::runGitCommand(workingDirectory, {"rev-parse", "--git-common-dir", "--git-path", "index"}, output)) {
+        return false;
+    }
+    const QStringList paths = output.split('\n', Qt::SkipEmptyParts);
+    if (paths.size() < 2) {
+        return false;
+    }
+    
+    const QDir workingDir(workingDirectory);
+    const QDir commonDir(workingDir.absoluteFilePath(paths.at(0).trimmed()));
+    health.indexBytes = QFileInfo(workingDir.absoluteFilePath(paths.at(1).trimmed())).size();
+    health.hasCommitGraph = QFileInfo::exists(commonDir.filePath("objects/info/commit-graph"))
+        || QFileInfo::exists(commonDir.filePath("objects/info/commit-graphs/commit-graph-chain"));
+    health.hasMultiPackIndex = QFileInfo::exists(commonDir.filePath("objects/pack/multi-pack-index"));
+    
+    QDirIterator refs(commonDir.filePath("refs"), QDir::Files, QDirIterator::Subdirectories);
+    while (refs.hasNext()) {
+        refs.next();
+        ++health.looseRefs;
+    }
+    
+    health.valid = true;
+    return true;
+}
+
+void RepositoryMaintenance::onIdle()
+{
+    if (!m_enabled || m_running || m_repositoryPath.isEmpty() || !m_scheduler) {
+        return;
+    }
+    
+    if (m_scheduler->runningCount() > 0 || m_scheduler->queuedCount() > 0) {
+        m_idleTimer.start();
+        return;
+    }
+    
+    startRun(false);
+}
+
+void RepositoryMaintenance::startRun(bool force)
+{
+    if (m_running || m_repositoryPath.isEmpty() || !m_scheduler) {
+        return;
+    }
+    
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    QList<Step> taskSteps;
+    for (int i = 0; i < TaskCount; ++i) {
+        const Task task = Task(i);
+        const TaskRecord &record = m_records[task];
+        bool due = force || !record.nextDue.isValid() || record.nextDue <= now;
+        if (task == CommitGraph && m_health.valid && !m_health.hasCommitGraph && record.failures == 0) {
+            due = true;
+        }
+        if (!due) {
+            continue;
+        }
+        
+        const QList<QStringList> commands = taskCommands(task);
+        for (int c = 0; c < commands.size(); ++c) {
+            taskSteps.append({TaskStep, task, commands.at(c), c == commands.size() - 1});
+        }
+    }
+    
+    if (taskSteps.isEmpty()) {
+        return;
+    }
+    
+    m_steps.clear();
+    m_steps.append(benchmarkSteps(BeforeStatus, BeforeLog));
+    m_steps.append(taskSteps);
+    m_steps.append(benchmarkSteps(AfterStatus, AfterLog));
+    
+    m_before = MaintenanceTiming();
+    m_after = MaintenanceTiming();
+    m_samples.clear();
+    m_currentTask = TaskCount;
+    m_forced = force;
+    m_stopRequested = false;
+    m_running = true;
+    m_idleTimer.stop();
+    
+    emit runStarted();
+    runNextStep();
+}
+
+// Each benchmark starts with an untimed pass so the first sample does not
+// pay for a cold page cache, then reports the median of several samples.
+QList<RepositoryMaintenance::Step> RepositoryMaintenance::benchmarkSteps(StepKind statusKind, StepKind logKind)
+{
+    const QStringList statusArgs = {"--no-optional-locks", "status", "--porcelain"};
+    const QStringList logArgs = {"log", "--topo-order", "--format=%H", "-n", "2000"};
+    
+    QList<Step> steps;
+    steps.append({WarmUp, TaskCount, statusArgs, false});
+    steps.append({WarmUp, TaskCount, logArgs, false});
+    for (int i = 0; i < BenchmarkSamples; ++i) {
+        steps.append({statusKind, TaskCount, statusArgs, false});
+    }
+    for (int i = 0; i < BenchmarkSamples; ++i) {
+        steps.append({logKind, TaskCount, logArgs, false});
+    }
+    return steps;
+}
+
+void RepositoryMaintenance::runNextStep()
+{
+    if (m_steps.isEmpty()) {
+        finishRun(true);
+        return;
+    }
+    
+    const Step &step = m_steps.first();
+    if (step.kind == TaskStep && step.task != m_currentTask) {
+        m_currentTask = step.task;
+        m_taskTimer.start();
+        emit taskStarted(step.task);
+    }
+    
+    GitTraceAction action("Maintenance");
+    m_requestId = m_scheduler->submit(m_repositoryPath, step.args, GitCommandScheduler::Background, this,
+        [this](const GitCommandResult &result) {
+            onStepFinished(result);
+        });
+}
+
+void RepositoryMaintenance::onStepFinished(const GitCommandResult &result)
+{
+    m_requestId = 0;
+    if (!m_running || m_steps.isEmpty()) {
+        return;
+    }
+    
+    const Step step = m_steps.takeFirst();
+    QList<qint64> &samples = m_samples[step.kind];
+    samples.append(result.success ? result.elapsedMs : -1);
+    
+    switch (step.kind) {
+    case WarmUp:
+        break;
+    case BeforeStatus:
+        m_before.statusMs = medianOf(samples);
+        break;
+    case BeforeLog:
+        m_before.logMs = medianOf(samples);
+        break;
+    case AfterStatus:
+        m_after.statusMs = medianOf(samples);
+        break;
+    case AfterLog:
+        m_after.logMs = medianOf(samples);
+        break;
+    case TaskStep:
+        if (!result.success) {
+            recordTask(step.task, false, result.error.trimmed());
+            emit taskFinished(step.task, false, m_taskTimer.elapsed());
+            skipTask(step.task);
+        } else if (step.lastOfTask) {
+            recordTask(step.task, true, QString());
+            emit taskFinished(step.task, true, m_taskTimer.elapsed());
+        }
+        break;
+    }
+    
+    if (m_stopRequested) {
+        if (!m_steps.isEmpty() && m_steps.first().kind == TaskStep && m_steps.first().task == step.task) {
+            emit taskFinished(step.task, false, m_taskTimer.elapsed());
+        }
+        finishRun(false);
+        return;
+    }
+    
+    runNextStep();
+}
+
+void RepositoryMaintenance::finishRun(bool completed)
+{
+    m_running = false;
+    m_forced = false;
+    m_stopRequested = false;
+    m_steps.clear();
+    m_currentTask = TaskCount;
+    saveRecords();
+    
+    emit runFinished(completed);
+    if (completed && m_before.isValid() && m_after.isValid()) {
+        emit timingsMeasured(m_before, m_after);
+    }
+    
+    checkHealth();
+    if (m_enabled) {
+        m_idleTimer.start();
+    }
+}
+
+void RepositoryMaintenance::recordTask(Task task, bool success, const QString &error)
+{
+    TaskRecord &record = m_records[task];
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    
+    if (success) {
+        record.lastRun = now;
+        record.failures = 0;
+        record.error.clear();
+        record.nextDue = now.addSecs(taskIntervalSecs(task));
+        return;
+    }
+    
+    ++record.failures;
+    record.error = error;
+    const qint64 backoff = qMin(BackoffBaseSecs << qMin(record.failures - 1, 16), BackoffMaximumSecs);
+    record.nextDue = now.addSecs(backoff);
+}
+
+void RepositoryMaintenance::skipTask(Task task)
+{
+    while (!m_steps.isEmpty() && m_steps.first().kind == TaskStep && m_steps.first().task == task) {
+        m_steps.removeFirst();
+    }
+}
+
+void RepositoryMaintenance::loadRecords()
+{
+    QSettings settings;
+    settings.beginGroup(settingsGroup());
+    for (int i = 0; i < TaskCount; ++i) {
+        TaskRecord &record = m_records[i];
+        const QString key = taskKey(Task(i));
+        record.lastRun = settings.value(key + "/lastRun").toDateTime();
+        record.nextDue = settings.value(key + "/nextDue").toDateTime();
+        record.failures = settings.value(key + "/failures", 0).toInt();
+        record.error = settings.value(key + "/error").toString();
+    }
+}
+
+void RepositoryMaintenance::saveRecords() const
+{
+    if (m_repositoryPath.isEmpty()) {
+        return;
+    }
+    
+    QSettings settings;
+    settings.beginGroup(settingsGroup());
+    for (int i = 0; i < TaskCount; ++i) {
+        const TaskRecord &record = m_records[i];
+        const QString key = taskKey(Task(i));
+        settings.setValue(key + "/lastRun", record.lastRun);
+        settings.setValue(key + "/nextDue", record.nextDue);
+        settings.setValue(key + "/failures", record.failures);
+        settings.setValue(key + "/error", record.error);
+    }
+}
+
+QString RepositoryMaintenance::settingsGroup() const
+{
+    const QByteArray key = QCryptographicHash::hash(QDir(m_repositoryPath).absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return "maintenance/" + QString::fromLatin1(key.left(16));
+}
+
+qint64 RepositoryMaintenance::taskIntervalSecs(Task task)
+{
+    switch (task) {
+    case CommitGraph: return 60 * 60;
+    case MultiPackIndex: return 24 * 60 * 60;
+    case IncrementalRepack: return 24 * 60 * 60;
+    case PackRefs: return 7 * 24 * 60 * 60;
+    case LooseObjects: return 24 * 60 * 60;
+    default: return 24 * 60 * 60;
+    }
+}
+
+QString RepositoryMaintenance::taskKey(Task task)
+{
+    switch (task) {
+    case CommitGraph: return "commitGraph";
+    case MultiPackIndex: return "multiPackIndex";
+    case IncrementalRepack: return "incrementalRepack";
+    case PackRefs: return "packRefs";
+    case LooseObjects: return "looseObjects";
+    default: return "unknown";
+    }
+}
\ No newline at end of file
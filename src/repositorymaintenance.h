@@ -0,0 +1,153 @@
+#ifndef REPOSITORYMAINTENANCE_H
+#define REPOSITORYMAINTENANCE_H
+
+#include <QObject>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+class GitCommandScheduler;
+struct GitCommandResult;
+
+struct RepositoryHealth {
+    int looseObjects;
+    qint64 looseBytes;
+    int packCount;
+    qint64 packBytes;
+    int garbageFiles;
+    qint64 indexBytes;
+    int looseRefs;
+    bool hasCommitGraph;
+    bool hasMultiPackIndex;
+    bool valid;
+    
+    RepositoryHealth();
+    QStringList warnings() const;
+};
+
+struct MaintenanceTiming {
+    qint64 statusMs;
+    qint64 logMs;
+    
+    MaintenanceTiming();
+    bool isValid() const;
+};
+
+class RepositoryMaintenance : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Task {
+        CommitGraph,
+        MultiPackIndex,
+        IncrementalRepack,
+        PackRefs,
+        LooseObjects,
+        TaskCount
+    };
+    Q_ENUM(Task)
+    
+    explicit RepositoryMaintenance(GitCommandScheduler *scheduler, QObject *parent = nullptr);
+    ~RepositoryMaintenance();
+    
+    void setRepository(const QString &path);
+    QString repository() const;
+    
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    void setIdleInterval(int ms);
+    
+    void notifyActivity();
+    void runNow();
+    void cancel();
+    bool isRunning() const;
+    void checkHealth();
+    
+    RepositoryHealth health() const;
+    MaintenanceTiming timingBefore() const;
+    MaintenanceTiming timingAfter() const;
+    QDateTime lastRun(Task task) const;
+    QDateTime nextDue(Task task) const;
+    int failureCount(Task task) const;
+    QString lastError(Task task) const;
+    
+    static QString taskName(Task task);
+    static QList<QStringList> taskCommands(Task task);
+    static bool loadHealth(const QString &workingDirectory, RepositoryHealth &health);
+
+signals:
+    void healthChanged(const RepositoryHealth &health);
+    void runStarted();
+    void runFinished(bool completed);
+    void taskStarted(RepositoryMaintenance::Task task);
+    void taskFinished(RepositoryMaintenance::Task task, bool success, qint64 elapsedMs);
+    void timingsMeasured(const MaintenanceTiming &before, const MaintenanceTiming &after);
+
+private slots:
+    void onIdle();
+
+private:
+    enum StepKind {
+        WarmUp,
+        BeforeStatus,
+        BeforeLog,
+        TaskStep,
+        AfterStatus,
+        AfterLog
+    };
+    
+    struct Step {
+        StepKind kind;
+        Task task;
+        QStringList args;
+        bool lastOfTask;
+    };
+    
+    struct TaskRecord {
+        QDateTime lastRun;
+        QDateTime nextDue;
+        int failures;
+        QString error;
+    };
+    
+    void startRun(bool force);
+    void requestStop();
+    static QList<Step> benchmarkSteps(StepKind statusKind, StepKind logKind);
+    void runNextStep();
+    void onStepFinished(const GitCommandResult &result);
+    void finishRun(bool completed);
+    void recordTask(Task task, bool success, const QString &error);
+    void skipTask(Task task);
+    void loadRecords();
+    void saveRecords() const;
+    QString settingsGroup() const;
+    static qint64 taskIntervalSecs(Task task);
+    static QString taskKey(Task task);
+    
+    QPointer<GitCommandScheduler> m_scheduler;
+    QString m_repositoryPath;
+    QTimer m_idleTimer;
+    bool m_enabled;
+    
+    QList<Step> m_steps;
+    quint64 m_requestId;
+    bool m_running;
+    bool m_forced;
+    bool m_stopRequested;
+    Task m_currentTask;
+    QElapsedTimer m_taskTimer;
+    
+    TaskRecord m_records[TaskCount];
+    RepositoryHealth m_health;
+    MaintenanceTiming m_before;
+    MaintenanceTiming m_after;
+    QHash<int, QList<qint64>> m_samples;
+};
+
+#endif // REPOSITORYMAINTENANCE_H
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "repositorysizepanel.h"
+#include "gitcommandscheduler.h"
+#include "gitmanager.h"
+#include "gittracer.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLocale>
+
+namespace {
+
+const int MaximumRows = 5000;
+
+enum Role {
+    SortRole = Qt::UserRole + 1,
+    ObjectIdRole,
+    LookupStartedRole
+};
+
+enum BlobColumn {
+    ObjectColumn,
+    PathColumn,
+    SizeColumn,
+    DiskSizeColumn,
+    IntroducedColumn
+};
+
+QStandardItem *sizeItem(qint64 bytes)
+{
+    QStandardItem *item = new QStandardItem(QLocale().formattedDataSize(bytes));
+    item->setData(bytes, SortRole);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QStandardItem *countItem(qint64 count)
+{
+    QStandardItem *item = new QStandardItem(QLocale().toString(count));
+    item->setData(count, SortRole);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QStandardItem *textItem(const QString &text)
+{
+    QStandardItem *item = new QStandardItem(text);
+    item->setData(text, SortRole);
+    item->setToolTip(text);
+    return item;
+}
+
+}
+
+RepositorySizePanel::RepositorySizePanel(GitManager *gitManager, QWidget *parent)
+    : QWidget(parent)
+    , m_gitManager(gitManager)
+    , m_scheduler(gitManager->scheduler())
+    , m_summaryLabel(nullptr)
+    , m_analyzeButton(nullptr)
+    , m_cancelButton(nullptr)
+    , m_tabWidget(nullptr)
+    , m_blobModel(nullptr)
+    , m_pathModel(nullptr)
+    , m_directoryModel(nullptr)
+    , m_typeModel(nullptr)
+    , m_blobView(nullptr)
+    , m_requestId(0)
+    , m_requestSerial(0)
+{
+    setupUI();
+}
+
+RepositorySizePanel::~RepositorySizePanel()
+{
+    cancel();
+}
+
+void RepositorySizePanel::setupUI()
+{
+    setWindowTitle("Repository Size");
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    QHBoxLayout *headerLayout = new QHBoxLayout;
+    m_summaryLabel = new QLabel;
+    m_summaryLabel->setWordWrap(true);
+    m_analyzeButton = new QPushButton("Analyze");
+    m_cancelButton = new QPushButton("Cancel");
+    m_cancelButton->setEnabled(false);
+    
+    headerLayout->addWidget(m_summaryLabel, 1);
+    headerLayout->addWidget(m_analyzeButton);
+    headerLayout->addWidget(m_cancelButton);
+    
+    m_blobModel = new QStandardItemModel(this);
+    m_pathModel = new QStandardItemModel(this);
+    m_directoryModel = new QStandardItemModel(this);
+    m_typeModel = new QStandardItemModel(this);
+    
+    m_blobView = createView(m_blobModel, {"Object", "Path", "Size", "On Disk", "Introduced By"});
+    
+    m_tabWidget = new QTabWidget;
+    m_tabWidget->addTab(m_blobView, "Largest Blobs");
+    m_tabWidget->addTab(createView(m_pathModel, {"Path", "Versions", "Size", "On Disk"}), "Paths");
+    m_tabWidget->addTab(createView(m_directoryModel, {"Directory", "Blobs", "Size", "On Disk"}), "Directories");
+    m_tabWidget->addTab(createView(m_typeModel, {"Type", "Objects", "Size", "On Disk"}), "Object Types");
+    
+    layout->addLayout(headerLayout);
+    layout->addWidget(m_tabWidget);
+    
+    connect(m_analyzeButton, &QPushButton::clicked, this, &RepositorySizePanel::analyze);
+    connect(m_cancelButton, &QPushButton::clicked, this, &RepositorySizePanel::cancel);
+    connect(m_blobView, &QTreeView::activated, this, &RepositorySizePanel::onBlobActivated);
+    connect(m_blobView, &QTreeView::clicked, this, &RepositorySizePanel::onBlobActivated);
+}
+
+QTreeView *RepositorySizePanel::createView(QStandardItemModel *model, const QStringList &headers)
+{
+    model->setHorizontalHeaderLabels(headers);
+    
+    QSortFilterProxyModel *proxyModel = new QSortFilterProxyModel(this);
+    proxyModel->setSourceModel(model);
+    proxyModel->setSortRole(SortRole);
+    
+    QTreeView *view = new QTreeView;
+    view->setModel(proxyModel);
+    view->setRootIsDecorated(false);
+    view->setUniformRowHeights(true);
+    view->setAlternatingRowColors(true);
+    view->setSortingEnabled(true);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    view->sortByColumn(headers.size() == 5 ? DiskSizeColumn : 3, Qt::DescendingOrder);
+    view->header()->setSectionResizeMode(headers.size() == 5 ? PathColumn : 0, QHeaderView::Stretch);
+    view->header()->setStretchLastSection(false);
+    return view;
+}
+
+void RepositorySizePanel::analyze()
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        m_summaryLabel->setText("No repository open");
+        return;
+    }
+    
+    GitTraceAction action("Analyze repository size");
+    
+    cancel();
+    const quint64 serial = ++m_requestSerial;
+    m_analyzeButton->setEnabled(false);
+    m_cancelButton->setEnabled(true);
+    m_summaryLabel->setText("Scanning objects...");
+    
+    m_requestId = m_gitManager->requestObjectSizeReport(this, [this, serial](const ObjectSizeReport &report) {
+        if (serial != m_requestSerial) {
+            return;
+        }
+        m_requestId = 0;
+        m_analyzeButton->setEnabled(true);
+        m_cancelButton->setEnabled(false);
+        showReport(report);
+    });
+}
+
+void RepositorySizePanel::cancel()
+{
+    if (m_requestId && m_scheduler) {
+        m_scheduler->cancel(m_requestId);
+    }
+    m_requestId = 0;
+    if (m_analyzeButton) {
+        m_analyzeButton->setEnabled(true);
+        m_cancelButton->setEnabled(false);
+    }
+}
+
+void RepositorySizePanel::showReport(const ObjectSizeReport &report)
+{
+    if (!report.success) {
+        m_summaryLabel->setText("Analysis failed: " + report.error);
+        return;
+    }
+    
+    const QLocale locale;
+    QString text = QString("%1 objects, %2 on disk, %3 reachable from refs (%4 ms)")
+        .arg(locale.toString(report.totalObjects))
+        .arg(locale.formattedDataSize(report.totalDiskSize))
+        .arg(locale.formattedDataSize(report.reachableDiskSize))
+        .arg(report.elapsedMs);
+    if (report.truncated) {
+        text += QString("\n%1 blobs at rarely seen paths were only counted towards their directories")
+            .arg(locale.toString(report.foldedBlobs));
+    }
+    if (report.missingObjects > 0) {
+        text += QString("\n%1 objects are not local to this partial clone and were not counted")
+            .arg(locale.toString(report.missingObjects));
+    }
+    if (report.paths.size() > MaximumRows || report.directories.size() > MaximumRows) {
+        text += QString("\nShowing the largest %1 paths and directories").arg(locale.toString(MaximumRows));
+    }
+    m_summaryLabel->setText(text);
+    
+    fillModel(m_blobModel, report.largestBlobs, true);
+    fillModel(m_pathModel, report.paths, false);
+    fillModel(m_directoryModel, report.directories, false);
+    fillModel(m_typeModel, report.types, false);
+}
+
+void RepositorySizePanel::fillModel(QStandardItemModel *model, const QList<ObjectSizeEntry> &entries, bool blobs)
+{
+    model->removeRows(0, model->rowCount());
+    
+    const int rows = qMin(MaximumRows, int(entries.size()));
+    for (int i = 0; i < rows; ++i) {
+        const ObjectSizeEntry &entry = entries.at(i);
+        QList<QStandardItem*> row;
+        if (blobs) {
+            QStandardItem *objectItem = textItem(entry.name.left(12));
+            objectItem->setData(entry.name, ObjectIdRole);
+            row << objectItem << textItem(entry.path) << sizeItem(entry.size) << sizeItem(entry.diskSize)
+                << textItem("Select to look up");
+        } else {
+            row << textItem(entry.name) << countItem(entry.count) << sizeItem(entry.size) << sizeItem(entry.diskSize);
+        }
+        model->appendRow(row);
+    }
+}
+
+void RepositorySizePanel::onBlobActivated(const QModelIndex &index)
+{
+    const QSortFilterProxyModel *proxyModel = static_cast<const QSortFilterProxyModel*>(index.model());
+    const QModelIndex sourceIndex = proxyModel->mapToSource(index);
+    QStandardItem *objectItem = m_blobModel->item(sourceIndex.row(), ObjectColumn);
+    QStandardItem *introducedItem = m_blobModel->item(sourceIndex.row(), IntroducedColumn);
+    if (!objectItem || !introducedItem || objectItem->data(LookupStartedRole).toBool()) {
+        return;
+    }
+    
+    GitTraceAction action("Find introducing commit");
+    
+    objectItem->setData(true, LookupStartedRole);
+    introducedItem->setText("Searching...");
+    
+    const QString objectId = objectItem->data(ObjectIdRole).toString();
+    m_gitManager->requestIntroducingCommit(objectId, this, [this, objectId](const QString &commit) {
+        for (int row = 0; row < m_blobModel->rowCount(); ++row) {
+            if (m_blobModel->item(row, ObjectColumn)->data(ObjectIdRole).toString() == objectId) {
+                QStandardItem *item = m_blobModel->item(row, IntroducedColumn);
+                item->setText(commit.isEmpty() ? "Not reachable from any ref" : commit);
+                item->setData(item->text(), SortRole);
+                item->setToolTip(item->text());
+                break;
+            }
+        }
+    });
+}
\ No newline at end of file
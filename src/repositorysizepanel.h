@@ -0,0 +1,53 @@
+#ifndef REPOSITORYSIZEPANEL_H
+#define REPOSITORYSIZEPANEL_H
+
+#include <QWidget>
+#include <QTreeView>
+#include <QStandardItemModel>
+#include <QSortFilterProxyModel>
+#include <QTabWidget>
+#include <QPushButton>
+#include <QLabel>
+#include <QPointer>
+#include "objectsizeanalyzer.h"
+
+class GitManager;
+class GitCommandScheduler;
+
+class RepositorySizePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RepositorySizePanel(GitManager *gitManager, QWidget *parent = nullptr);
+    ~RepositorySizePanel();
+    
+    void analyze();
+
+private slots:
+    void cancel();
+    void onBlobActivated(const QModelIndex &index);
+
+private:
+    void setupUI();
+    QTreeView *createView(QStandardItemModel *model, const QStringList &headers);
+    void showReport(const ObjectSizeReport &report);
+    void fillModel(QStandardItemModel *model, const QList<ObjectSizeEntry> &entries, bool blobs);
+    
+    GitManager *m_gitManager;
+    QPointer<GitCommandScheduler> m_scheduler;
+    QLabel *m_summaryLabel;
+    QPushButton *m_analyzeButton;
+    QPushButton *m_cancelButton;
+    QTabWidget *m_tabWidget;
+    QStandardItemModel *m_blobModel;
+    QStandardItemModel *m_pathModel;
+    QStandardItemModel *m_directoryModel;
+    QStandardItemModel *m_typeModel;
+    QTreeView *m_blobView;
+    
+    quint64 m_requestId;
+    quint64 m_requestSerial;
+};
+
+#endif // REPOSITORYSIZEPANEL_H
\ No newline at end of file
@@ -0,0 +1,329 @@
+#include "repositorystats.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+const quint32 CacheMagic = 0x53524b53;
+const int CacheVersion = 1;
+const char RecordSeparator = '\x1e';
+const char FieldSeparator = '\x1f';
+
+quint32 parseCount(const char *begin, const char *end)
+{
+    quint32 value = 0;
+    for (const char *p = begin; p < end; ++p) {
+        if (*p < '0' || *p > '9') {
+            return 0;
+        }
+        value = value * 10 + quint32(*p - '0');
+    }
+    return value;
+}
+
+}
+
+ChurnTotals::ChurnTotals()
+    : commits(0)
+    , added(0)
+    , deleted(0)
+{
+}
+
+RepositoryStatsSummary::RepositoryStatsSummary()
+    : commitCount(0)
+    , processedCommits(0)
+    , batchCount(0)
+    , elapsedMs(0)
+    , success(false)
+{
+}
+
+RepositoryStatsCache::RepositoryStatsCache()
+{
+    m_pending.time = 0;
+    m_pending.author = 0;
+}
+
+void RepositoryStatsCache::clear()
+{
+    m_paths.clear();
+    m_pathLookup.clear();
+    m_authors.clear();
+    m_authorLookup.clear();
+    m_records.clear();
+    m_pendingId.clear();
+    m_pending.changes.clear();
+}
+
+int RepositoryStatsCache::size() const
+{
+    return m_records.size();
+}
+
+bool RepositoryStatsCache::contains(const QByteArray &commitId) const
+{
+    return m_records.contains(commitId);
+}
+
+bool RepositoryStatsCache::appendLogLine(const char *data, int size)
+{
+    if (size <= 0) {
+        return true;
+    }
+    
+    const char *end = data + size;
+    
+    if (data[0] == RecordSeparator) {
+        finishLog();
+        
+        const char *idEnd = static_cast<const char*>(memchr(data + 1, FieldSeparator, size - 1));
+        if (!idEnd) {
+            return false;
+        }
+        const char *timeEnd = static_cast<const char*>(memchr(idEnd + 1, FieldSeparator, end - idEnd - 1));
+        if (!timeEnd) {
+            return false;
+        }
+        
+        m_pendingId = QByteArray(data + 1, int(idEnd - data - 1));
+        m_pending.time = QByteArray(idEnd + 1, int(timeEnd - idEnd - 1)).toLongLong();
+        m_pending.author = internAuthor(QString::fromUtf8(timeEnd + 1, int(end - timeEnd - 1)));
+        m_pending.changes.clear();
+        return true;
+    }
+    
+    if (m_pendingId.isEmpty()) {
+        return false;
+    }
+    
+    const char *addedEnd = static_cast<const char*>(memchr(data, '\t', size));
+    if (!addedEnd) {
+        return false;
+    }
+    const char *deletedEnd = static_cast<const char*>(memchr(addedEnd + 1, '\t', end - addedEnd - 1));
+    if (!deletedEnd) {
+        return false;
+    }
+    
+    Change change;
+    change.added = parseCount(data, addedEnd);
+    change.deleted = parseCount(addedEnd + 1, deletedEnd);
+    change.path = internPath(QString::fromUtf8(deletedEnd + 1, int(end - deletedEnd - 1)));
+    m_pending.changes.append(change);
+    return true;
+}
+
+void RepositoryStatsCache::finishLog()
+{
+    if (m_pendingId.isEmpty()) {
+        return;
+    }
+    
+    m_pending.changes.squeeze();
+    m_records.insert(m_pendingId, m_pending);
+    m_pendingId.clear();
+    m_pending.changes.clear();
+}
+
+void RepositoryStatsCache::merge(const RepositoryStatsCache &other)
+{
+    QVector<quint32> pathMap(other.m_paths.size());
+    for (int i = 0; i < other.m_paths.size(); ++i) {
+        pathMap[i] = internPath(other.m_paths.at(i));
+    }
+    QVector<quint32> authorMap(other.m_authors.size());
+    for (int i = 0; i < other.m_authors.size(); ++i) {
+        authorMap[i] = internAuthor(other.m_authors.at(i));
+    }
+    
+    m_records.reserve(m_records.size() + other.m_records.size());
+    for (auto it = other.m_records.constBegin(); it != other.m_records.constEnd(); ++it) {
+        Record record = it.value();
+        record.author = authorMap.at(record.author);
+        for (Change &change : record.changes) {
+            change.path = pathMap.at(change.path);
+        }
+        m_records.insert(it.key(), record);
+    }
+}
+
+RepositoryStatsSummary RepositoryStatsCache::summarize(const QList<QByteArray> &commitIds) const
+{
+    RepositoryStatsSummary summary;
+    
+    QVector<QStringList> directoriesByPath(m_paths.size());
+    QVector<bool> directoriesResolved(m_paths.size(), false);
+    QSet<QString> touchedDirectories;
+    
+    for (const QByteArray &commitId : commitIds) {
+        auto it = m_records.constFind(commitId);
+        if (it == m_records.constEnd()) {
+            continue;
+        }
+        const Record &record = it.value();
+        ++summary.commitCount;
+        
+        ChurnTotals &author = summary.authors[m_authors.at(record.author)];
+        ++author.commits;
+        
+        const QDate date = QDateTime::fromSecsSinceEpoch(record.time).date();
+        ++summary.activity[QDate(date.year(), date.month(), 1)];
+        
+        touchedDirectories.clear();
+        for (const Change &change : record.changes) {
+            const QString &path = m_paths.at(change.path);
+            author.added += change.added;
+            author.deleted += change.deleted;
+            
+            ChurnTotals &file = summary.files[path];
+            ++file.commits;
+            file.added += change.added;
+            file.deleted += change.deleted;
+            
+            if (!directoriesResolved.at(change.path)) {
+                QStringList directories;
+                int slash = path.lastIndexOf('/');
+                while (slash > 0) {
+                    directories.append(path.left(slash));
+                    slash = path.lastIndexOf('/', slash - 1);
+                }
+                directoriesByPath[change.path] = directories;
+                directoriesResolved[change.path] = true;
+            }
+            
+            for (const QString &directory : directoriesByPath.at(change.path)) {
+                ChurnTotals &totals = summary.directories[directory];
+                if (!touchedDirectories.contains(directory)) {
+                    touchedDirectories.insert(directory);
+                    ++totals.commits;
+                }
+                totals.added += change.added;
+                totals.deleted += change.deleted;
+            }
+        }
+    }
+    
+    summary.success = true;
+    return summary;
+}
+
+bool RepositoryStatsCache::load(const QString &path)
+{
+    clear();
+    
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    
+    QDataStream in(&file);
+    quint32 magic = 0;
+    qint32 version = 0;
+    in >> magic >> version;
+    if (magic != CacheMagic || version != CacheVersion) {
+        return false;
+    }
+    
+    in >> m_paths >> m_authors;
+    for (int i = 0; i < m_paths.size(); ++i) {
+        m_pathLookup.insert(m_paths.at(i), quint32(i));
+    }
+    for (int i = 0; i < m_authors.size(); ++i) {
+        m_authorLookup.insert(m_authors.at(i), quint32(i));
+    }
+    
+    quint32 recordCount = 0;
+    in >> recordCount;
+    m_records.reserve(int(recordCount));
+    for (quint32 i = 0; i < recordCount && in.status() == QDataStream::Ok; ++i) {
+        QByteArray commitId;
+        Record record;
+        quint32 changeCount = 0;
+        in >> commitId >> record.time >> record.author >> changeCount;
+        if (record.author >= quint32(m_authors.size())) {
+            break;
+        }
+        record.changes.resize(int(changeCount));
+        for (Change &change : record.changes) {
+            in >> change.path >> change.added >> change.deleted;
+            if (change.path >= quint32(m_paths.size())) {
+                in.setStatus(QDataStream::ReadCorruptData);
+                break;
+            }
+        }
+        m_records.insert(commitId, record);
+    }
+    
+    if (in.status() != QDataStream::Ok || quint32(m_records.size()) != recordCount) {
+        clear();
+        return false;
+    }
+    return true;
+}
+
+bool RepositoryStatsCache::save(const QString &path) const
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    
+    QDataStream out(&file);
+    out << CacheMagic << qint32(CacheVersion) << m_paths << m_authors << quint32(m_records.size());
+    for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+        const Record &record = it.value();
+        out << it.key() << record.time << record.author << quint32(record.changes.size());
+        for (const Change &change : record.changes) {
+            out << change.path << change.added << change.deleted;
+        }
+    }
+    
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+QString RepositoryStatsCache::filePath(const QString &repositoryPath)
+{
+    const QByteArray key = QCryptographicHash::hash(QDir(repositoryPath).absolutePath().toUtf8(), QCryptographicHash::Sha1).toHex();
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("stats/" + QString::fromLatin1(key) + ".cache");
+}
+
+QStringList RepositoryStatsCache::logArguments()
+{
+    return {"-c", "core.quotePath=false", "log", "--no-walk=unsorted", "--stdin", "--numstat", "--no-renames",
+            "--format=%x1e%H%x1f%at%x1f%aN"};
+}
+
+quint32 RepositoryStatsCache::internPath(const QString &path)
+{
+    auto it = m_pathLookup.constFind(path);
+    if (it != m_pathLookup.constEnd()) {
+        return it.value();
+    }
+    const quint32 index = quint32(m_paths.size());
+    m_paths.append(path);
+    m_pathLookup.insert(path, index);
+    return index;
+}
+
+quint32 RepositoryStatsCache::internAuthor(const QString &author)
+{
+    auto it = m_authorLookup.constFind(author);
+    if (it != m_authorLookup.constEnd()) {
+        return it.value();
+    }
+    const quint32 index = quint32(m_authors.size());
+    m_authors.append(author);
+    m_authorLookup.insert(author, index);
+    return index;
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#ifndef REPOSITORYSTATS_H
+#define REPOSITORYSTATS_H
+
+#include <QByteArray>
+#include <QDate>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+struct ChurnTotals {
+    int commits;
+    qint64 added;
+    qint64 deleted;
+    
+    ChurnTotals();
+};
+
+struct RepositoryStatsSummary {
+    QHash<QString, ChurnTotals> files;
+    QHash<QString, ChurnTotals> directories;
+    QHash<QString, ChurnTotals> authors;
+    QMap<QDate, int> activity;
+    int commitCount;
+    int processedCommits;
+    int batchCount;
+    qint64 elapsedMs;
+    bool success;
+    QString error;
+    
+    RepositoryStatsSummary();
+};
+
+class RepositoryStatsCache
+{
+public:
+    RepositoryStatsCache();
+    
+    void clear();
+    int size() const;
+    bool contains(const QByteArray &commitId) const;
+    
+    bool appendLogLine(const char *data, int size);
+    void finishLog();
+    void merge(const RepositoryStatsCache &other);
+    RepositoryStatsSummary summarize(const QList<QByteArray> &commitIds) const;
+    
+    bool load(const QString &path);
+    bool save(const QString &path) const;
+    
+    static QString filePath(const QString &repositoryPath);
+    static QStringList logArguments();
+
+private:
+    struct Change {
+        quint32 path;
+        quint32 added;
+        quint32 deleted;
+    };
+    
+    struct Record {
+        qint64 time;
+        quint32 author;
+        QVector<Change> changes;
+    };
+    
+    quint32 internPath(const QString &path);
+    quint32 internAuthor(const QString &author);
+    
+    QStringList m_paths;
+    QHash<QString, quint32> m_pathLookup;
+    QStringList m_authors;
+    QHash<QString, quint32> m_authorLookup;
+    QHash<QByteArray, Record> m_records;
+    QByteArray m_pendingId;
+    Record m_pending;
+};
+
+#endif // REPOSITORYSTATS_H
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "sessionsnapshot.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace {
+
+const int SnapshotVersion = 1;
+const int MaximumSnapshotFiles = 5000;
+
+enum FileFlag {
+    StagedFlag = 1,
+    ModifiedFlag = 2,
+    UntrackedFlag = 4,
+    DeletedFlag = 8
+};
+
+}
+
+bool SessionSnapshot::isValid() const
+{
+    return !repositoryPath.isEmpty() && QDir(repositoryPath).exists(".git");
+}
+
+bool SessionSnapshot::save() const
+{
+    QJsonArray fileArray;
+    for (int i = 0; i < files.size() && i < MaximumSnapshotFiles; ++i) {
+        const GitFileStatus &file = files.at(i);
+        int flags = 0;
+        flags |= file.isStaged ? StagedFlag : 0;
+        flags |= file.isModified ? ModifiedFlag : 0;
+        flags |= file.isUntracked ? UntrackedFlag : 0;
+        flags |= file.isDeleted ? DeletedFlag : 0;
+        fileArray.append(QJsonArray{file.filePath, file.status, flags});
+    }
+    
+    QJsonArray commitArray;
+    for (const GitCommit &commit : commits) {
+        commitArray.append(QJsonArray{commit.hash, commit.author, commit.date, commit.message, commit.parents.join(' ')});
+    }
+    
+    QJsonObject root;
+    root["version"] = SnapshotVersion;
+    root["repositoryPath"] = repositoryPath;
+    root["branch"] = branch;
+    root["savedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    root["files"] = fileArray;
+    root["commits"] = commitArray;
+    
+    const QString path = filePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+SessionSnapshot SessionSnapshot::load()
+{
+    SessionSnapshot snapshot;
+    
+    QFile file(filePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return snapshot;
+    }
+    
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root["version"].toInt() != SnapshotVersion) {
+        return snapshot;
+    }
+    
+    snapshot.repositoryPath = root["repositoryPath"].toString();
+    snapshot.branch = root["branch"].toString();
+    snapshot.savedAt = QDateTime::fromString(root["savedAt"].toString(), Qt::ISODate);
+    
+    const QJsonArray fileArray = root["files"].toArray();
+    snapshot.files.reserve(fileArray.size());
+    for (const QJsonValue &value : fileArray) {
+        const QJsonArray entry = value.toArray();
+        const int flags = entry.at(2).toInt();
+        
+        GitFileStatus status;
+        status.filePath = entry.at(0).toString();
+        status.status = entry.at(1).toString();
+        status.isStaged = flags & StagedFlag;
+        status.isModified = flags & ModifiedFlag;
+        status.isUntracked = flags & UntrackedFlag;
+        status.isDeleted = flags & DeletedFlag;
+        snapshot.files.append(status);
+    }
+    
+    const QJsonArray commitArray = root["commits"].toArray();
+    snapshot.commits.reserve(commitArray.size());
+    for (const QJsonValue &value : commitArray) {
+        const QJsonArray entry = value.toArray();
+        
+        GitCommit commit;
+        commit.hash = entry.at(0).toString();
+        commit.author = entry.at(1).toString();
+        commit.date = entry.at(2).toString();
+        commit.message = entry.at(3).toString();
+        commit.parents = entry.at(4).toString().split(' ', Qt::SkipEmptyParts);
+        snapshot.commits.append(commit);
+    }
+    
+    return snapshot;
+}
+
+void SessionSnapshot::remove()
+{
+    QFile::remove(filePath());
+}
+
+QString SessionSnapshot::filePath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("session.json");
+}
\ No newline at end of file
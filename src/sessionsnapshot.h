@@ -0,0 +1,24 @@
+#ifndef SESSIONSNAPSHOT_H
+#define SESSIONSNAPSHOT_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+#include "gitmanager.h"
+
+struct SessionSnapshot {
+    QString repositoryPath;
+    QString branch;
+    QList<GitFileStatus> files;
+    QList<GitCommit> commits;
+    QDateTime savedAt;
+    
+    bool isValid() const;
+    bool save() const;
+    
+    static SessionSnapshot load();
+    static void remove();
+    static QString filePath();
+};
+
+#endif // SESSIONSNAPSHOT_H
\ No newline at end of file
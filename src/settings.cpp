@@ -10,6 +10,9 @@ Settings::Settings(QWidget *parent)
     , m_userNameEdit(nullptr)
     , m_userEmailEdit(nullptr)
     , m_gitPathEdit(nullptr)
+    , m_restoreSessionCheck(nullptr)
+    , m_parallelFetchSpin(nullptr)
+    , m_maxCommitsSpin(nullptr)
     , m_saveButton(nullptr)
     , m_cancelButton(nullptr)
 {
@@ -54,12 +57,53 @@ void Settings::setupUI()
     pathLayout->addWidget(gitLabel);
     pathLayout->addWidget(m_gitPathEdit);
     
+    QGroupBox *startupGroup = new QGroupBox("Startup");
+    QVBoxLayout *startupLayout = new QVBoxLayout(startupGroup);
+    
+    m_restoreSessionCheck = new QCheckBox("Reopen the last repository on startup");
+    m_restoreSessionCheck->setChecked(true);
+    
+    startupLayout->addWidget(m_restoreSessionCheck);
+    
+    QGroupBox *historyGroup = new QGroupBox("History");
+    QVBoxLayout *historyLayout = new QVBoxLayout(historyGroup);
+    
+    QLabel *maxCommitsLabel = new QLabel("Maximum commits to load:");
+    m_maxCommitsSpin = new QSpinBox;
+    m_maxCommitsSpin->setRange(100, 10000000);
+    m_maxCommitsSpin->setSingleStep(10000);
+    m_maxCommitsSpin->setValue(100000);
+    
+    historyLayout->addWidget(maxCommitsLabel);
+    historyLayout->addWidget(m_maxCommitsSpin);
+    
     generalLayout->addWidget(userGroup);
     generalLayout->addWidget(pathGroup);
+    generalLayout->addWidget(startupGroup);
+    generalLayout->addWidget(historyGroup);
     generalLayout->addStretch();
     
     m_tabWidget->addTab(generalTab, "General");
     
+    QWidget *remoteTab = new QWidget;
+    QVBoxLayout *remoteLayout = new QVBoxLayout(remoteTab);
+    
+    QGroupBox *fetchGroup = new QGroupBox("Fetch All");
+    QVBoxLayout *fetchLayout = new QVBoxLayout(fetchGroup);
+    
+    QLabel *parallelLabel = new QLabel("Maximum parallel fetches:");
+    m_parallelFetchSpin = new QSpinBox;
+    m_parallelFetchSpin->setRange(1, 32);
+    m_parallelFetchSpin->setValue(4);
+    
+    fetchLayout->addWidget(parallelLabel);
+    fetchLayout->addWidget(m_parallelFetchSpin);
+    
+    remoteLayout->addWidget(fetchGroup);
+    remoteLayout->addStretch();
+    
+    m_tabWidget->addTab(remoteTab, "Remote");
+    
     QHBoxLayout *buttonLayout = new QHBoxLayout;
     m_saveButton = new QPushButton("Save");
     m_cancelButton = new QPushButton("Cancel");
@@ -81,6 +125,9 @@ void Settings::saveSettings()
     settings.setValue("user/name", m_userNameEdit->text());
     settings.setValue("user/email", m_userEmailEdit->text());
     settings.setValue("git/path", m_gitPathEdit->text());
+    settings.setValue("session/restoreLastRepository", m_restoreSessionCheck->isChecked());
+    settings.setValue("remote/maxParallelFetches", m_parallelFetchSpin->value());
+    settings.setValue("history/maxCommits", m_maxCommitsSpin->value());
     
     accept();
 }
@@ -91,4 +138,7 @@ void Settings::loadSettings()
     m_userNameEdit->setText(settings.value("user/name").toString());
     m_userEmailEdit->setText(settings.value("user/email").toString());
     m_gitPathEdit->setText(settings.value("git/path", "git").toString());
+    m_restoreSessionCheck->setChecked(settings.value("session/restoreLastRepository", true).toBool());
+    m_parallelFetchSpin->setValue(settings.value("remote/maxParallelFetches", 4).toInt());
+    m_maxCommitsSpin->setValue(settings.value("history/maxCommits", 100000).toInt());
 }
\ No newline at end of file
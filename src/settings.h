@@ -8,6 +8,8 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QTabWidget>
+#include <QSpinBox>
+#include <QCheckBox>
 
 class Settings : public QDialog
 {
@@ -27,6 +29,9 @@ private:
     QLineEdit *m_userNameEdit;
     QLineEdit *m_userEmailEdit;
     QLineEdit *m_gitPathEdit;
+    QCheckBox *m_restoreSessionCheck;
+    QSpinBox *m_parallelFetchSpin;
+    QSpinBox *m_maxCommitsSpin;
     QPushButton *m_saveButton;
     QPushButton *m_cancelButton;
 };
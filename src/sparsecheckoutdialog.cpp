@@ -0,0 +1,273 @@
+#include "sparsecheckoutdialog.h"
+#include "gitmanager.h"
+#include "gitcommandscheduler.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QProcessEnvironment>
+#include <QSet>
+#include <QVBoxLayout>
+
+SparseCheckoutDialog::SparseCheckoutDialog(GitManager *gitManager, QWidget *parent)
+    : QDialog(parent)
+    , m_gitManager(gitManager)
+    , m_enableCheck(nullptr)
+    , m_directoryList(nullptr)
+    , m_progressBar(nullptr)
+    , m_statusLabel(nullptr)
+    , m_resultTable(nullptr)
+    , m_applyButton(nullptr)
+    , m_selectAllButton(nullptr)
+    , m_selectNoneButton(nullptr)
+    , m_closeButton(nullptr)
+    , m_process(nullptr)
+{
+    setupUI();
+}
+
+void SparseCheckoutDialog::setupUI()
+{
+    setWindowTitle("Sparse Checkout");
+    resize(500, 550);
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    m_enableCheck = new QCheckBox("Limit the working tree to the selected top-level directories (cone mode)");
+    
+    m_directoryList = new QListWidget;
+    m_directoryList->setUniformItemSizes(true);
+    
+    QHBoxLayout *selectLayout = new QHBoxLayout;
+    m_selectAllButton = new QPushButton("Select All");
+    m_selectNoneButton = new QPushButton("Select None");
+    selectLayout->addWidget(m_selectAllButton);
+    selectLayout->addWidget(m_selectNoneButton);
+    selectLayout->addStretch();
+    
+    m_progressBar = new QProgressBar;
+    m_progressBar->setRange(0, 100);
+    m_progressBar->setValue(0);
+    m_progressBar->hide();
+    
+    m_statusLabel = new QLabel;
+    
+    m_resultTable = new QTableWidget(2, 2);
+    m_resultTable->setHorizontalHeaderLabels({"Before", "After"});
+    m_resultTable->setVerticalHeaderLabels({"Checked-out files", "Status time"});
+    m_resultTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_resultTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_resultTable->setMaximumHeight(100);
+    
+    QHBoxLayout *buttonLayout = new QHBoxLayout;
+    m_applyButton = new QPushButton("Apply");
+    m_closeButton = new QPushButton("Close");
+    buttonLayout->addStretch();
+    buttonLayout->addWidget(m_applyButton);
+    buttonLayout->addWidget(m_closeButton);
+    
+    layout->addWidget(m_enableCheck);
+    layout->addWidget(m_directoryList);
+    layout->addLayout(selectLayout);
+    layout->addWidget(m_progressBar);
+    layout->addWidget(m_statusLabel);
+    layout->addWidget(m_resultTable);
+    layout->addLayout(buttonLayout);
+    
+    connect(m_enableCheck, &QCheckBox::toggled, m_directoryList, &QWidget::setEnabled);
+    connect(m_selectAllButton, &QPushButton::clicked, this, &SparseCheckoutDialog::selectAll);
+    connect(m_selectNoneButton, &QPushButton::clicked, this, &SparseCheckoutDialog::selectNone);
+    connect(m_applyButton, &QPushButton::clicked, this, &SparseCheckoutDialog::applyChanges);
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+void SparseCheckoutDialog::reload()
+{
+    m_directoryList->clear();
+    m_statusLabel->clear();
+    m_resultTable->clearContents();
+    
+    if (!m_gitManager->isRepositoryOpen()) {
+        return;
+    }
+    
+    const bool enabled = m_gitManager->isSparseCheckoutEnabled();
+    const QStringList selected = m_gitManager->getSparseCheckoutDirectories();
+    const QSet<QString> selectedSet(selected.begin(), selected.end());
+    const QStringList directories = m_gitManager->getTopLevelDirectories();
+    
+    for (const QString &directory : directories) {
+        QListWidgetItem *item = new QListWidgetItem(directory, m_directoryList);
+        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+        item->setCheckState(!enabled || selectedSet.contains(directory) ? Qt::Checked : Qt::Unchecked);
+    }
+    
+    m_enableCheck->setChecked(enabled);
+    m_directoryList->setEnabled(enabled);
+    m_statusLabel->setText(enabled
+        ? QString("Sparse checkout enabled: %1 of %2 directories").arg(selected.size()).arg(directories.size())
+        : QString("Full checkout of %1 directories").arg(directories.size()));
+}
+
+void SparseCheckoutDialog::selectAll()
+{
+    for (int i = 0; i < m_directoryList->count(); ++i) {
+        m_directoryList->item(i)->setCheckState(Qt::Checked);
+    }
+}
+
+void SparseCheckoutDialog::selectNone()
+{
+    for (int i = 0; i < m_directoryList->count(); ++i) {
+        m_directoryList->item(i)->setCheckState(Qt::Unchecked);
+    }
+}
+
+void SparseCheckoutDialog::measure(int column, std::function<void()> done)
+{
+    const QString repositoryPath = m_gitManager->getRepositoryPath();
+    GitCommandScheduler *scheduler = m_gitManager->scheduler();
+    
+    scheduler->submit(repositoryPath, {"ls-files", "-t"}, GitCommandScheduler::Interactive, this,
+        [this, scheduler, repositoryPath, column, done](const GitCommandResult &listing) {
+            int fileCount = 0;
+            if (listing.success) {
+                for (const QByteArray &line : listing.output.split('\n')) {
+                    if (!line.isEmpty() && !line.startsWith("S ")) {
+                        ++fileCount;
+                    }
+                }
+            }
+            
+            scheduler->submit(repositoryPath, {"status", "--porcelain", "--ignore-submodules=dirty"}, GitCommandScheduler::Interactive, this,
+                [this, column, fileCount, done](const GitCommandResult &status) {
+                    Measurement measurement;
+                    measurement.fileCount = fileCount;
+                    measurement.statusMs = status.elapsedMs;
+                    showMeasurement(column, measurement);
+                    done();
+                });
+        });
+}
+
+void SparseCheckoutDialog::showMeasurement(int column, const Measurement &measurement)
+{
+    m_resultTable->setItem(0, column, new QTableWidgetItem(QString::number(measurement.fileCount)));
+    m_resultTable->setItem(1, column, new QTableWidgetItem(QString("%1 ms").arg(measurement.statusMs)));
+}
+
+void SparseCheckoutDialog::setBusy(bool busy)
+{
+    m_applyButton->setEnabled(!busy);
+    m_closeButton->setEnabled(!busy);
+    m_enableCheck->setEnabled(!busy);
+    m_directoryList->setEnabled(!busy && m_enableCheck->isChecked());
+    m_progressBar->setVisible(busy);
+}
+
+void SparseCheckoutDialog::applyChanges()
+{
+    if (!m_gitManager->isRepositoryOpen() || m_process) {
+        return;
+    }
+    
+    QStringList args;
+    args << "sparse-checkout";
+    
+    if (m_enableCheck->isChecked()) {
+        QStringList directories;
+        for (int i = 0; i < m_directoryList->count(); ++i) {
+            QListWidgetItem *item = m_directoryList->item(i);
+            if (item->checkState() == Qt::Checked) {
+                directories.append(item->text());
+            }
+        }
+        args << "set" << "--cone" << "--" << directories;
+    } else {
+        args << "disable";
+    }
+    
+    m_resultTable->clearContents();
+    setBusy(true);
+    m_progressBar->setRange(0, 0);
+    m_statusLabel->setText("Measuring current working tree...");
+    measure(0, [this, args]() {
+        startApply(args);
+    });
+}
+
+void SparseCheckoutDialog::startApply(const QStringList &args)
+{
+    m_statusLabel->setText("Updating working tree...");
+    m_parser.reset();
+    
+    m_process = new QProcess(this);
+    m_process->setWorkingDirectory(m_gitManager->getRepositoryPath());
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    env.insert("LC_ALL", "C");
+    m_process->setProcessEnvironment(env);
+    
+    connect(m_process, &QProcess::started, this, [this]() { m_trace.markStarted(); });
+    connect(m_process, &QProcess::readyReadStandardError, this, &SparseCheckoutDialog::onProcessOutput);
+    connect(m_process, &QProcess::finished, this, &SparseCheckoutDialog::onProcessFinished);
+    connect(m_process, &QProcess::errorOccurred, this, &SparseCheckoutDialog::onProcessError);
+    
+    m_trace.begin(m_gitManager->getRepositoryPath(), args, "Apply sparse checkout");
+    m_timer.start();
+    m_process->start("git", args);
+}
+
+void SparseCheckoutDialog::onProcessOutput()
+{
+    const QList<GitProgressInfo> updates = m_parser.feed(m_process->readAllStandardError());
+    for (const GitProgressInfo &progress : updates) {
+        if (progress.percent >= 0) {
+            m_progressBar->setRange(0, 100);
+            m_progressBar->setValue(progress.percent);
+        }
+        m_statusLabel->setText(progress.toString());
+    }
+}
+
+void SparseCheckoutDialog::onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+    onProcessOutput();
+    m_parser.finish();
+    
+    const qint64 applyMs = m_timer.elapsed();
+    const bool success = exitStatus == QProcess::NormalExit && exitCode == 0;
+    const QString errors = m_parser.messages().join("\n");
+    m_trace.finish(exitCode, success, success ? QString() : errors);
+    
+    m_process->deleteLater();
+    m_process = nullptr;
+    
+    if (!success) {
+        setBusy(false);
+        m_statusLabel->setText("Sparse checkout failed");
+        QMessageBox::warning(this, "Sparse Checkout", "Failed to update sparse checkout:\n" + errors);
+        return;
+    }
+    
+    m_statusLabel->setText("Measuring updated working tree...");
+    measure(1, [this, applyMs]() {
+        setBusy(false);
+        m_statusLabel->setText(QString("Working tree updated in %1 ms").arg(applyMs));
+        m_gitManager->notifyRepositoryChanged();
+    });
+}
+
+void SparseCheckoutDialog::onProcessError(QProcess::ProcessError error)
+{
+    if (error != QProcess::FailedToStart || !m_process) {
+        return;
+    }
+    
+    const QString message = "Failed to start git: " + m_process->errorString();
+    m_trace.finish(-1, false, message);
+    m_process->deleteLater();
+    m_process = nullptr;
+    setBusy(false);
+    
+    m_statusLabel->setText("Sparse checkout failed");
+    QMessageBox::warning(this, "Sparse Checkout", message);
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#ifndef SPARSECHECKOUTDIALOG_H
+#define SPARSECHECKOUTDIALOG_H
+
+#include <QDialog>
+#include <QListWidget>
+#include <QCheckBox>
+#include <QLabel>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QProcess>
+#include <QTableWidget>
+#include <QElapsedTimer>
+#include <functional>
+#include "gitprogress.h"
+#include "gittracer.h"
+
+class GitManager;
+
+class SparseCheckoutDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit SparseCheckoutDialog(GitManager *gitManager, QWidget *parent = nullptr);
+    
+    void reload();
+
+private slots:
+    void applyChanges();
+    void selectAll();
+    void selectNone();
+    void onProcessOutput();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onProcessError(QProcess::ProcessError error);
+
+private:
+    struct Measurement {
+        int fileCount;
+        qint64 statusMs;
+    };
+    
+    void setupUI();
+    void measure(int column, std::function<void()> done);
+    void showMeasurement(int column, const Measurement &measurement);
+    void setBusy(bool busy);
+    void startApply(const QStringList &args);
+    
+    GitManager *m_gitManager;
+    QCheckBox *m_enableCheck;
+    QListWidget *m_directoryList;
+    QProgressBar *m_progressBar;
+    QLabel *m_statusLabel;
+    QTableWidget *m_resultTable;
+    QPushButton *m_applyButton;
+    QPushButton *m_selectAllButton;
+    QPushButton *m_selectNoneButton;
+    QPushButton *m_closeButton;
+    
+    QProcess *m_process;
+    GitProgressParser m_parser;
+    QElapsedTimer m_timer;
+    GitProcessTrace m_trace;
+};
+
+#endif // SPARSECHECKOUTDIALOG_H
\ No newline at end of file
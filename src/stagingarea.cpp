@@ -1,5 +1,6 @@
 #include "stagingarea.h"
 #include "gitmanager.h"
+#include "gittracer.h"
 #include <QMessageBox>
 #include <QGroupBox>
 
@@ -99,14 +100,22 @@ void StagingArea::refresh()
         return;
     }
     
-    populateFileList();
+    m_gitManager->requestFileStatus(this, [this](const QList<GitFileStatus> &files) {
+        populateFileList(files);
+    });
 }
 
-void StagingArea::populateFileList()
+void StagingArea::showFiles(const QList<GitFileStatus> &files)
 {
-    m_model->clear();
+    populateFileList(files);
+}
+
+void StagingArea::populateFileList(const QList<GitFileStatus> &files)
+{
+    GitTraceSpan span("model", "StagingArea::populateFileList");
+    span.setItemCount(files.size());
     
-    QList<GitFileStatus> files = m_gitManager->getFileStatus();
+    m_model->clear();
     
     for (const GitFileStatus &file : files) {
         QStandardItem *item = new QStandardItem();
@@ -133,6 +142,8 @@ void StagingArea::populateFileList()
 
 void StagingArea::commitChanges()
 {
+    GitTraceAction action("Commit");
+    
     QString summary = m_commitSummary->text().trimmed();
     QString description = m_commitMessage->toPlainText().trimmed();
     
@@ -158,6 +169,8 @@ void StagingArea::commitChanges()
 
 void StagingArea::stageAll()
 {
+    GitTraceAction action("Stage all");
+    
     if (m_gitManager->stageAll()) {
         refresh();
     } else {
@@ -167,6 +180,8 @@ void StagingArea::stageAll()
 
 void StagingArea::unstageAll()
 {
+    GitTraceAction action("Unstage all");
+    
     if (m_gitManager->unstageAll()) {
         refresh();
     } else {
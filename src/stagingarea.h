@@ -11,8 +11,7 @@
 #include <QTextEdit>
 #include <QLineEdit>
 #include <QSplitter>
-
-class GitManager;
+#include "gitmanager.h"
 
 class StagingArea : public QWidget
 {
@@ -22,6 +21,7 @@ public:
     explicit StagingArea(GitManager *gitManager, QWidget *parent = nullptr);
     
     void refresh();
+    void showFiles(const QList<GitFileStatus> &files);
 
 private slots:
     void commitChanges();
@@ -31,7 +31,7 @@ private slots:
 
 private:
     void setupUI();
-    void populateFileList();
+    void populateFileList(const QList<GitFileStatus> &files);
     
     GitManager *m_gitManager;
     QListView *m_listView;
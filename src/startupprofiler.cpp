@@ -0,0 +1,74 @@
+#include "startupprofiler.h"
+#include "gittracer.h"
+#include <QDebug>
+#include <QStringList>
+
+StartupProfiler::StartupProfiler()
+    : m_lastMarkUs(0)
+    , m_lastTraceUs(0)
+    , m_finished(false)
+{
+}
+
+StartupProfiler *StartupProfiler::instance()
+{
+    static StartupProfiler profiler;
+    return &profiler;
+}
+
+void StartupProfiler::start()
+{
+    m_timer.start();
+    m_lastMarkUs = 0;
+    m_lastTraceUs = GitTracer::instance()->now();
+    m_phases.clear();
+    m_finished = false;
+}
+
+void StartupProfiler::mark(const QString &phase)
+{
+    if (m_finished || !m_timer.isValid()) {
+        return;
+    }
+    
+    const qint64 nowUs = m_timer.nsecsElapsed() / 1000;
+    m_phases.append(qMakePair(phase, nowUs - m_lastMarkUs));
+    m_lastMarkUs = nowUs;
+    
+    GitTraceEvent event;
+    event.category = "startup";
+    event.name = phase;
+    event.startUs = m_lastTraceUs;
+    event.durationUs = GitTracer::instance()->now() - m_lastTraceUs;
+    GitTracer::instance()->record(event);
+    m_lastTraceUs += event.durationUs;
+}
+
+void StartupProfiler::finish()
+{
+    if (m_finished || !m_timer.isValid()) {
+        return;
+    }
+    
+    m_finished = true;
+    qInfo().noquote() << "Startup:" << summary();
+}
+
+bool StartupProfiler::isFinished() const
+{
+    return m_finished;
+}
+
+qint64 StartupProfiler::elapsedMs() const
+{
+    return m_lastMarkUs / 1000;
+}
+
+QString StartupProfiler::summary() const
+{
+    QStringList parts;
+    for (const auto &phase : m_phases) {
+        parts << QString("%1 %2 ms").arg(phase.first).arg(phase.second / 1000.0, 0, 'f', 1);
+    }
+    return QString("%1 ms total (%2)").arg(elapsedMs()).arg(parts.join(", "));
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+class StartupProfiler
+{
+public:
+    static StartupProfiler *instance();
+    
+    void start();
+    void mark(const QString &phase);
+    void finish();
+    
+    bool isFinished() const;
+    qint64 elapsedMs() const;
+    QString summary() const;
+
+private:
+    StartupProfiler();
+    
+    QElapsedTimer m_timer;
+    qint64 m_lastMarkUs;
+    qint64 m_lastTraceUs;
+    QList<QPair<QString, qint64>> m_phases;
+    bool m_finished;
+};
+
+#endif // STARTUPPROFILER_H
\ No newline at end of file
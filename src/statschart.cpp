@@ -0,0 +1,176 @@
+#include "statschart.h"
+#include <QEvent>
+#include <QHelpEvent>
+#include <QLocale>
+#include <QPainter>
+#include <QToolTip>
+
+namespace {
+
+const int Margin = 8;
+const int RowHeight = 22;
+const int LabelWidth = 240;
+const int AxisHeight = 20;
+
+}
+
+StatsChart::StatsChart(Style style, QWidget *parent)
+    : QWidget(parent)
+    , m_style(style)
+    , m_maximum(0)
+{
+    setMouseTracking(true);
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+}
+
+void StatsChart::setEntries(const QList<QPair<QString, double>> &entries, const QString &unit)
+{
+    m_entries = entries;
+    m_unit = unit;
+    m_maximum = 0;
+    for (const auto &entry : m_entries) {
+        m_maximum = qMax(m_maximum, entry.second);
+    }
+    updateGeometry();
+    update();
+}
+
+void StatsChart::clear()
+{
+    setEntries({}, QString());
+}
+
+QSize StatsChart::sizeHint() const
+{
+    if (m_style == RankedBars) {
+        return QSize(600, Margin * 2 + RowHeight * qMax(1, int(m_entries.size())));
+    }
+    return QSize(600, 240);
+}
+
+QRect StatsChart::plotRect() const
+{
+    const QRect area = rect().adjusted(Margin, Margin, -Margin, -Margin);
+    if (m_style == RankedBars) {
+        return area.adjusted(qMin(LabelWidth, area.width() / 3), 0, -60, 0);
+    }
+    return area.adjusted(0, 0, 0, -AxisHeight);
+}
+
+QRect StatsChart::barRect(int index) const
+{
+    const QRect plot = plotRect();
+    const double fraction = m_maximum > 0 ? m_entries.at(index).second / m_maximum : 0;
+    
+    if (m_style == RankedBars) {
+        const int rowHeight = qMin(RowHeight, plot.height() / qMax(1, int(m_entries.size())));
+        const int width = qMax(1, int(plot.width() * fraction));
+        return QRect(plot.left(), plot.top() + index * rowHeight + 2, width, qMax(1, rowHeight - 4));
+    }
+    
+    const double slot = double(plot.width()) / qMax(1, int(m_entries.size()));
+    const int height = int(plot.height() * fraction);
+    const int left = plot.left() + int(index * slot);
+    const int width = qMax(1, int((index + 1) * slot) - int(index * slot) - (slot > 4 ? 1 : 0));
+    return QRect(left, plot.bottom() - height + 1, width, height);
+}
+
+int StatsChart::entryAt(const QPoint &pos) const
+{
+    const QRect plot = plotRect();
+    if (m_entries.isEmpty()) {
+        return -1;
+    }
+    
+    if (m_style == RankedBars) {
+        const int rowHeight = qMin(RowHeight, plot.height() / qMax(1, int(m_entries.size())));
+        if (rowHeight <= 0 || pos.y() < plot.top()) {
+            return -1;
+        }
+        const int index = (pos.y() - plot.top()) / rowHeight;
+        return index < m_entries.size() ? index : -1;
+    }
+    
+    if (pos.x() < plot.left() || pos.x() > plot.right()) {
+        return -1;
+    }
+    const int index = int(double(pos.x() - plot.left()) * m_entries.size() / qMax(1, plot.width()));
+    return qBound(0, index, int(m_entries.size()) - 1);
+}
+
+QString StatsChart::formatValue(double value) const
+{
+    return QLocale().toString(qint64(value));
+}
+
+void StatsChart::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().base());
+    
+    if (m_entries.isEmpty()) {
+        painter.setPen(palette().color(QPalette::PlaceholderText));
+        painter.drawText(rect(), Qt::AlignCenter, "No data");
+        return;
+    }
+    
+    const QRect plot = plotRect();
+    const QColor barColor = palette().color(QPalette::Highlight);
+    const QFontMetrics metrics(font());
+    
+    if (m_style == RankedBars) {
+        const QRect area = rect().adjusted(Margin, Margin, -Margin, -Margin);
+        for (int i = 0; i < m_entries.size(); ++i) {
+            const QRect bar = barRect(i);
+            if (bar.top() > area.bottom()) {
+                break;
+            }
+            
+            const QRect labelRect(area.left(), bar.top(), plot.left() - area.left() - 6, bar.height());
+            painter.setPen(palette().color(QPalette::Text));
+            painter.drawText(labelRect, Qt::AlignRight | Qt::AlignVCenter,
+                             metrics.elidedText(m_entries.at(i).first, Qt::ElideMiddle, labelRect.width()));
+            
+            painter.fillRect(bar, barColor);
+            painter.drawText(QRect(bar.right() + 4, bar.top(), 120, bar.height()), Qt::AlignLeft | Qt::AlignVCenter,
+                             formatValue(m_entries.at(i).second));
+        }
+        return;
+    }
+    
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawLine(plot.bottomLeft(), plot.bottomRight());
+    for (int i = 0; i < m_entries.size(); ++i) {
+        painter.fillRect(barRect(i), barColor);
+    }
+    
+    painter.setPen(palette().color(QPalette::Text));
+    const int labelWidth = metrics.horizontalAdvance(m_entries.first().first) + 12;
+    const int step = qMax(1, int(m_entries.size() * labelWidth / qMax(1, plot.width())) + 1);
+    for (int i = 0; i < m_entries.size(); i += step) {
+        const QRect bar = barRect(i);
+        painter.drawText(QRect(bar.left(), plot.bottom() + 4, labelWidth, AxisHeight - 4),
+                         Qt::AlignLeft | Qt::AlignTop, m_entries.at(i).first);
+    }
+    painter.drawText(QRect(plot.left(), plot.top(), plot.width(), metrics.height()), Qt::AlignRight | Qt::AlignTop,
+                     "max " + formatValue(m_maximum) + " " + m_unit);
+}
+
+bool StatsChart::event(QEvent *event)
+{
+    if (event->type() == QEvent::ToolTip) {
+        QHelpEvent *helpEvent = static_cast<QHelpEvent*>(event);
+        const int index = entryAt(helpEvent->pos());
+        if (index >= 0) {
+            QToolTip::showText(helpEvent->globalPos(), QString("%1: %2 %3")
+                .arg(m_entries.at(index).first, formatValue(m_entries.at(index).second), m_unit), this);
+        } else {
+            QToolTip::hideText();
+            event->ignore();
+        }
+        return true;
+    }
+    return QWidget::event(event);
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#ifndef STATSCHART_H
+#define STATSCHART_H
+
+#include <QWidget>
+#include <QList>
+#include <QPair>
+#include <QString>
+
+class StatsChart : public QWidget
+{
+    Q_OBJECT
+
+public:
+    enum Style {
+        RankedBars,
+        Timeline
+    };
+    
+    explicit StatsChart(Style style, QWidget *parent = nullptr);
+    
+    void setEntries(const QList<QPair<QString, double>> &entries, const QString &unit);
+    void clear();
+    
+    QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override;
+
+private:
+    QRect plotRect() const;
+    QRect barRect(int index) const;
+    int entryAt(const QPoint &pos) const;
+    QString formatValue(double value) const;
+    
+    Style m_style;
+    QList<QPair<QString, double>> m_entries;
+    QString m_unit;
+    double m_maximum;
+};
+
+#endif // STATSCHART_H
\ No newline at end of file
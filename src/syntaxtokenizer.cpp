@@ -0,0 +1,418 @@
+#include "syntaxtokenizer.h"
+#include <QFileInfo>
+#include <QSet>
+
+namespace {
+
+const QSet<QString> &cppKeywords()
+{
+    static const QSet<QString> keywords = {
+        "alignas", "alignof", "break", "case", "catch", "class", "const", "constexpr", "const_cast",
+        "continue", "decltype", "default", "delete", "do", "dynamic_cast", "else", "enum", "explicit",
+        "export", "extern", "false", "final", "for", "friend", "goto", "if", "inline", "mutable",
+        "namespace", "new", "noexcept", "nullptr", "operator", "override", "private", "protected",
+        "public", "register", "reinterpret_cast", "return", "signals", "sizeof", "slots", "static",
+        "static_assert", "static_cast", "struct", "switch", "template", "this", "thread_local",
+        "throw", "true", "try", "typedef", "typeid", "typename", "union", "using", "virtual",
+        "volatile", "while", "emit", "Q_OBJECT"
+    };
+    return keywords;
+}
+
+const QSet<QString> &cppTypes()
+{
+    static const QSet<QString> types = {
+        "auto", "bool", "char", "char8_t", "char16_t", "char32_t", "double", "float", "int", "long",
+        "short", "signed", "unsigned", "void", "wchar_t", "size_t", "int8_t", "int16_t", "int32_t",
+        "int64_t", "uint8_t", "uint16_t", "uint32_t", "uint64_t", "qint64", "quint64", "quint32",
+        "qint32", "uchar", "uint", "qreal"
+    };
+    return types;
+}
+
+const QSet<QString> &pythonKeywords()
+{
+    static const QSet<QString> keywords = {
+        "False", "None", "True", "and", "as", "assert", "async", "await", "break", "class",
+        "continue", "def", "del", "elif", "else", "except", "finally", "for", "from", "global",
+        "if", "import", "in", "is", "lambda", "nonlocal", "not", "or", "pass", "raise", "return",
+        "try", "while", "with", "yield", "match", "case", "self"
+    };
+    return keywords;
+}
+
+const QSet<QString> &pythonTypes()
+{
+    static const QSet<QString> types = {
+        "bool", "bytes", "dict", "float", "frozenset", "int", "list", "object", "set", "str", "tuple"
+    };
+    return types;
+}
+
+bool isIdentifierStart(QChar c)
+{
+    return c.isLetter() || c == '_';
+}
+
+bool isIdentifierPart(QChar c)
+{
+    return c.isLetterOrNumber() || c == '_';
+}
+
+void addToken(SyntaxLineTokens &tokens, int start, int end, int kind)
+{
+    if (end > start) {
+        tokens.append({start, end - start, kind});
+    }
+}
+
+}
+
+SyntaxTokenizer::Language SyntaxTokenizer::languageForPath(const QString &filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == "cpp" || suffix == "cc" || suffix == "cxx" || suffix == "c" || suffix == "h"
+        || suffix == "hpp" || suffix == "hh" || suffix == "hxx" || suffix == "inl") {
+        return Cpp;
+    }
+    if (suffix == "py" || suffix == "pyw" || suffix == "pyi") {
+        return Python;
+    }
+    if (suffix == "json") {
+        return Json;
+    }
+    if (suffix == "yml" || suffix == "yaml") {
+        return Yaml;
+    }
+    return PlainText;
+}
+
+SyntaxLineTokens SyntaxTokenizer::tokenizeLine(Language language, const QString &line, int &state)
+{
+    SyntaxLineTokens tokens;
+    
+    switch (language) {
+    case Cpp:
+        tokenizeCpp(line, state, tokens);
+        break;
+    case Python:
+        tokenizePython(line, state, tokens);
+        break;
+    case Json:
+        tokenizeJson(line, tokens);
+        state = Normal;
+        break;
+    case Yaml:
+        tokenizeYaml(line, tokens);
+        state = Normal;
+        break;
+    default:
+        state = Normal;
+        break;
+    }
+    
+    return tokens;
+}
+
+QColor SyntaxTokenizer::color(int kind)
+{
+    switch (kind) {
+    case Keyword:
+        return QColor(0, 0, 160);
+    case Type:
+        return QColor(128, 0, 128);
+    case String:
+        return QColor(0, 128, 0);
+    case Number:
+        return QColor(0, 110, 150);
+    case Comment:
+        return QColor(128, 128, 128);
+    case Preprocessor:
+        return QColor(150, 90, 0);
+    case Key:
+        return QColor(160, 30, 30);
+    default:
+        return QColor();
+    }
+}
+
+void SyntaxTokenizer::tokenizeCpp(const QString &line, int &state, SyntaxLineTokens &tokens)
+{
+    const int length = line.size();
+    int pos = 0;
+    
+    if (state == BlockComment) {
+        const int end = line.indexOf("*/");
+        if (end < 0) {
+            addToken(tokens, 0, length, Comment);
+            return;
+        }
+        addToken(tokens, 0, end + 2, Comment);
+        pos = end + 2;
+        state = Normal;
+    }
+    
+    int firstNonSpace = pos;
+    while (firstNonSpace < length && line.at(firstNonSpace).isSpace()) {
+        ++firstNonSpace;
+    }
+    if (pos == 0 && firstNonSpace < length && line.at(firstNonSpace) == '#') {
+        int end = firstNonSpace + 1;
+        while (end < length && line.at(end).isSpace()) {
+            ++end;
+        }
+        end = scanIdentifier(line, end);
+        addToken(tokens, firstNonSpace, end, Preprocessor);
+        pos = end;
+    }
+    
+    while (pos < length) {
+        const QChar c = line.at(pos);
+        
+        if (c == '/' && pos + 1 < length && line.at(pos + 1) == '/') {
+            addToken(tokens, pos, length, Comment);
+            return;
+        }
+        if (c == '/' && pos + 1 < length && line.at(pos + 1) == '*') {
+            const int end = line.indexOf("*/", pos + 2);
+            if (end < 0) {
+                addToken(tokens, pos, length, Comment);
+                state = BlockComment;
+                return;
+            }
+            addToken(tokens, pos, end + 2, Comment);
+            pos = end + 2;
+        } else if (c == '"' || c == '\'') {
+            const int end = scanString(line, pos, c);
+            addToken(tokens, pos, end, String);
+            pos = end;
+        } else if (c.isDigit()) {
+            const int end = scanNumber(line, pos);
+            addToken(tokens, pos, end, Number);
+            pos = end;
+        } else if (isIdentifierStart(c)) {
+            const int end = scanIdentifier(line, pos);
+            const QString word = line.mid(pos, end - pos);
+            if (cppKeywords().contains(word)) {
+                addToken(tokens, pos, end, Keyword);
+            } else if (cppTypes().contains(word)) {
+                addToken(tokens, pos, end, Type);
+            }
+            pos = end;
+        } else {
+            ++pos;
+        }
+    }
+}
+
+void SyntaxTokenizer::tokenizePython(const QString &line, int &state, SyntaxLineTokens &tokens)
+{
+    const int length = line.size();
+    int pos = 0;
+    
+    if (state == TripleSingleQuote || state == TripleDoubleQuote) {
+        const QString delimiter = state == TripleSingleQuote ? "'''" : "\"\"\"";
+        const int end = line.indexOf(delimiter);
+        if (end < 0) {
+            addToken(tokens, 0, length, String);
+            return;
+        }
+        addToken(tokens, 0, end + 3, String);
+        pos = end + 3;
+        state = Normal;
+    }
+    
+    while (pos < length) {
+        const QChar c = line.at(pos);
+        
+        if (c == '#') {
+            addToken(tokens, pos, length, Comment);
+            return;
+        }
+        
+        int quote = pos;
+        while (quote < length && quote - pos < 2 && QString("rRbBfFuU").contains(line.at(quote))) {
+            ++quote;
+        }
+        if (quote < length && (line.at(quote) == '"' || line.at(quote) == '\'')
+            && (quote == pos || !isIdentifierPart(pos > 0 ? line.at(pos - 1) : QChar(' ')))) {
+            const QChar q = line.at(quote);
+            const QString delimiter = QString(3, q);
+            if (line.mid(quote, 3) == delimiter) {
+                const int end = line.indexOf(delimiter, quote + 3);
+                if (end < 0) {
+                    addToken(tokens, pos, length, String);
+                    state = q == '\'' ? TripleSingleQuote : TripleDoubleQuote;
+                    return;
+                }
+                addToken(tokens, pos, end + 3, String);
+                pos = end + 3;
+            } else {
+                const int end = scanString(line, quote, q);
+                addToken(tokens, pos, end, String);
+                pos = end;
+            }
+            continue;
+        }
+        
+        if (c == '@' && line.left(pos).trimmed().isEmpty()) {
+            int end = pos + 1;
+            while (end < length && (isIdentifierPart(line.at(end)) || line.at(end) == '.')) {
+                ++end;
+            }
+            addToken(tokens, pos, end, Preprocessor);
+            pos = end;
+        } else if (c.isDigit()) {
+            const int end = scanNumber(line, pos);
+            addToken(tokens, pos, end, Number);
+            pos = end;
+        } else if (isIdentifierStart(c)) {
+            const int end = scanIdentifier(line, pos);
+            const QString word = line.mid(pos, end - pos);
+            if (pythonKeywords().contains(word)) {
+                addToken(tokens, pos, end, Keyword);
+            } else if (pythonTypes().contains(word)) {
+                addToken(tokens, pos, end, Type);
+            }
+            pos = end;
+        } else {
+            ++pos;
+        }
+    }
+}
+
+void SyntaxTokenizer::tokenizeJson(const QString &line, SyntaxLineTokens &tokens)
+{
+    const int length = line.size();
+    int pos = 0;
+    
+    while (pos < length) {
+        const QChar c = line.at(pos);
+        
+        if (c == '"') {
+            const int end = scanString(line, pos, c);
+            int next = end;
+            while (next < length && line.at(next).isSpace()) {
+                ++next;
+            }
+            addToken(tokens, pos, end, next < length && line.at(next) == ':' ? Key : String);
+            pos = end;
+        } else if (c.isDigit() || (c == '-' && pos + 1 < length && line.at(pos + 1).isDigit())) {
+            const int end = scanNumber(line, pos + 1);
+            addToken(tokens, pos, end, Number);
+            pos = end;
+        } else if (isIdentifierStart(c)) {
+            const int end = scanIdentifier(line, pos);
+            const QString word = line.mid(pos, end - pos);
+            if (word == "true" || word == "false" || word == "null") {
+                addToken(tokens, pos, end, Keyword);
+            }
+            pos = end;
+        } else {
+            ++pos;
+        }
+    }
+}
+
+void SyntaxTokenizer::tokenizeYaml(const QString &line, SyntaxLineTokens &tokens)
+{
+    const int length = line.size();
+    int pos = 0;
+    
+    while (pos < length && line.at(pos).isSpace()) {
+        ++pos;
+    }
+    if (line.mid(pos, 3) == "---" || line.mid(pos, 3) == "...") {
+        addToken(tokens, pos, pos + 3, Preprocessor);
+        pos += 3;
+    }
+    while (pos + 1 < length && line.at(pos) == '-' && line.at(pos + 1).isSpace()) {
+        pos += 2;
+        while (pos < length && line.at(pos).isSpace()) {
+            ++pos;
+        }
+    }
+    
+    if (pos < length && line.at(pos) != '#' && line.at(pos) != '"' && line.at(pos) != '\'') {
+        int colon = pos;
+        while (colon < length && line.at(colon) != ':' && line.at(colon) != '#') {
+            ++colon;
+        }
+        if (colon < length && line.at(colon) == ':' && (colon + 1 == length || line.at(colon + 1).isSpace())) {
+            addToken(tokens, pos, colon, Key);
+            pos = colon + 1;
+        }
+    }
+    
+    while (pos < length) {
+        const QChar c = line.at(pos);
+        
+        if (c == '#' && (pos == 0 || line.at(pos - 1).isSpace())) {
+            addToken(tokens, pos, length, Comment);
+            return;
+        }
+        if (c == '"' || c == '\'') {
+            const int end = scanString(line, pos, c);
+            addToken(tokens, pos, end, String);
+            pos = end;
+        } else if ((c == '&' || c == '*' || c == '!') && pos + 1 < length && !line.at(pos + 1).isSpace()) {
+            int end = pos + 1;
+            while (end < length && !line.at(end).isSpace()) {
+                ++end;
+            }
+            addToken(tokens, pos, end, Type);
+            pos = end;
+        } else if (c.isDigit() || ((c == '-' || c == '.') && pos + 1 < length && line.at(pos + 1).isDigit())) {
+            const int end = scanNumber(line, pos + 1);
+            const bool standalone = (pos == 0 || !isIdentifierPart(line.at(pos - 1)))
+                && (end == length || line.at(end).isSpace() || line.at(end) == ',' || line.at(end) == ']' || line.at(end) == '}');
+            if (standalone) {
+                addToken(tokens, pos, end, Number);
+            }
+            pos = end;
+        } else if (isIdentifierStart(c) || c == '~') {
+            const int end = c == '~' ? pos + 1 : scanIdentifier(line, pos);
+            const QString word = line.mid(pos, end - pos).toLower();
+            if (word == "true" || word == "false" || word == "null" || word == "yes" || word == "no" || word == "~") {
+                addToken(tokens, pos, end, Keyword);
+            }
+            pos = end;
+        } else {
+            ++pos;
+        }
+    }
+}
+
+int SyntaxTokenizer::scanString(const QString &line, int start, QChar quote)
+{
+    int pos = start + 1;
+    while (pos < line.size()) {
+        const QChar c = line.at(pos);
+        if (c == '\\') {
+            pos += 2;
+        } else if (c == quote) {
+            return pos + 1;
+        } else {
+            ++pos;
+        }
+    }
+    return line.size();
+}
+
+int SyntaxTokenizer::scanNumber(const QString &line, int start)
+{
+    int pos = start;
+    while (pos < line.size() && (line.at(pos).isLetterOrNumber() || line.at(pos) == '.' || line.at(pos) == '\'')) {
+        ++pos;
+    }
+    return pos;
+}
+
+int SyntaxTokenizer::scanIdentifier(const QString &line, int start)
+{
+    int pos = start;
+    while (pos < line.size() && isIdentifierPart(line.at(pos))) {
+        ++pos;
+    }
+    return pos;
+}
\ No newline at end of file
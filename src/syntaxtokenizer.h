@@ -0,0 +1,58 @@
+#ifndef SYNTAXTOKENIZER_H
+#define SYNTAXTOKENIZER_H
+
+#include <QString>
+#include <QVector>
+#include <QColor>
+
+struct SyntaxToken {
+    int start;
+    int length;
+    int kind;
+};
+
+typedef QVector<SyntaxToken> SyntaxLineTokens;
+
+class SyntaxTokenizer
+{
+public:
+    enum Language {
+        PlainText,
+        Cpp,
+        Python,
+        Json,
+        Yaml
+    };
+    
+    enum TokenKind {
+        Keyword,
+        Type,
+        String,
+        Number,
+        Comment,
+        Preprocessor,
+        Key
+    };
+    
+    enum State {
+        Normal = 0,
+        BlockComment,
+        TripleSingleQuote,
+        TripleDoubleQuote
+    };
+    
+    static Language languageForPath(const QString &filePath);
+    static SyntaxLineTokens tokenizeLine(Language language, const QString &line, int &state);
+    static QColor color(int kind);
+
+private:
+    static void tokenizeCpp(const QString &line, int &state, SyntaxLineTokens &tokens);
+    static void tokenizePython(const QString &line, int &state, SyntaxLineTokens &tokens);
+    static void tokenizeJson(const QString &line, SyntaxLineTokens &tokens);
+    static void tokenizeYaml(const QString &line, SyntaxLineTokens &tokens);
+    static int scanString(const QString &line, int start, QChar quote);
+    static int scanNumber(const QString &line, int start);
+    static int scanIdentifier(const QString &line, int start);
+};
+
+#endif // SYNTAXTOKENIZER_H
\ No newline at end of file
@@ -0,0 +1,279 @@
+#include "taglistmodel.h"
+#include "gitmanager.h"
+#include "gittracer.h"
+#include <QBrush>
+#include <QColor>
+#include <QDateTime>
+
+TagListModel::TagListModel(GitManager *gitManager, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_gitManager(gitManager)
+    , m_sortOrder(TagQuery::VersionDescending)
+    , m_hasMore(false)
+    , m_loading(false)
+    , m_generation(0)
+{
+    m_detailsTimer.setSingleShot(true);
+    m_detailsTimer.setInterval(30);
+    connect(&m_detailsTimer, &QTimer::timeout, this, &TagListModel::requestQueuedDetails);
+}
+
+void TagListModel::setQuery(const QString &prefix, int sortOrder)
+{
+    m_prefix = prefix;
+    m_sortOrder = sortOrder;
+    reload();
+}
+
+void TagListModel::reload()
+{
+    clear();
+    if (m_gitManager->isRepositoryOpen()) {
+        m_hasMore = true;
+        requestPage();
+    }
+}
+
+void TagListModel::clear()
+{
+    beginResetModel();
+    ++m_generation;
+    m_tags.clear();
+    m_rowByName.clear();
+    m_requested.clear();
+    m_queued.clear();
+    m_detailsTimer.stop();
+    m_hasMore = false;
+    endResetModel();
+    setLoading(false);
+}
+
+const GitTagRef &TagListModel::tagAt(int row) const
+{
+    return m_tags.at(row);
+}
+
+bool TagListModel::isLoading() const
+{
+    return m_loading;
+}
+
+bool TagListModel::hasMore() const
+{
+    return m_hasMore;
+}
+
+int TagListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_tags.size();
+}
+
+int TagListModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant TagListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_tags.size()) {
+        return QVariant();
+    }
+    
+    const GitTagRef &tag = m_tags.at(index.row());
+    
+    switch (role) {
+    case TagNameRole:
+        return tag.name;
+    case DetailsLoadedRole:
+        return tag.detailsLoaded;
+    case Qt::ForegroundRole:
+        if (tag.detailsLoaded && !tag.isAnnotated() && index.column() != NameColumn) {
+            return QBrush(QColor(100, 100, 100));
+        }
+        return QVariant();
+    case Qt::ToolTipRole:
+        if (!tag.detailsLoaded) {
+            return tag.name;
+        }
+        return QString("%1\n%2 %3\n%4").arg(tag.name, tag.targetType, tag.targetId, tag.subject);
+    case Qt::DisplayRole:
+        break;
+    default:
+        return QVariant();
+    }
+    
+    if (index.column() == NameColumn) {
+        return tag.name;
+    }
+    
+    if (!tag.detailsLoaded) {
+        queueDetails(tag.name);
+        return index.column() == TargetColumn ? QVariant("...") : QVariant();
+    }
+    
+    switch (index.column()) {
+    case TargetColumn:
+        return tag.targetId.left(10);
+    case TaggerColumn:
+        return tag.tagger;
+    case DateColumn:
+        return tag.time > 0 ? QDateTime::fromSecsSinceEpoch(tag.time).toString("yyyy-MM-dd HH:mm") : QString();
+    case SubjectColumn:
+        return tag.subject;
+    default:
+        return QVariant();
+    }
+}
+
+QVariant TagListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    
+    switch (section) {
+    case NameColumn:
+        return "Tag";
+    case TargetColumn:
+        return "Target";
+    case TaggerColumn:
+        return "Tagger";
+    case DateColumn:
+        return "Date";
+    case SubjectColumn:
+        return "Message";
+    default:
+        return QVariant();
+    }
+}
+
+bool TagListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_hasMore && !m_loading;
+}
+
+void TagListModel::fetchMore(const QModelIndex &parent)
+{
+    if (canFetchMore(parent)) {
+        requestPage();
+    }
+}
+
+void TagListModel::requestPage()
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        return;
+    }
+    
+    setLoading(true);
+    const quint64 generation = m_generation;
+    m_gitManager->requestTagPage(m_prefix, m_sortOrder, m_tags.size(), TagQuery::DefaultPageSize, this,
+        [this, generation](const GitTagPage &page) {
+            onPageLoaded(generation, page);
+        });
+}
+
+void TagListModel::onPageLoaded(quint64 generation, const GitTagPage &page)
+{
+    if (generation != m_generation || page.offset != m_tags.size()) {
+        return;
+    }
+    
+    setLoading(false);
+    if (!page.success) {
+        m_hasMore = false;
+        emit loadFailed(page.error);
+        return;
+    }
+    
+    GitTraceSpan span("model", "TagListModel::onPageLoaded");
+    span.setItemCount(page.tags.size());
+    
+    m_hasMore = page.hasMore;
+    if (page.tags.isEmpty()) {
+        return;
+    }
+    
+    beginInsertRows(QModelIndex(), m_tags.size(), m_tags.size() + page.tags.size() - 1);
+    for (const GitTagRef &tag : page.tags) {
+        m_rowByName.insert(tag.name, m_tags.size());
+        m_tags.append(tag);
+    }
+    endInsertRows();
+}
+
+void TagListModel::queueDetails(const QString &name) const
+{
+    if (m_requested.contains(name)) {
+        return;
+    }
+    
+    m_requested.insert(name);
+    m_queued.append(name);
+    if (!m_detailsTimer.isActive()) {
+        m_detailsTimer.start();
+    }
+}
+
+void TagListModel::requestQueuedDetails()
+{
+    while (!m_queued.isEmpty()) {
+        const QStringList names = m_queued.mid(0, TagQuery::MaxDetailsBatch);
+        m_queued.remove(0, names.size());
+        
+        const quint64 generation = m_generation;
+        m_gitManager->requestTagDetails(names, this, [this, generation, names](bool success, const QList<GitTagRef> &tags) {
+            onDetailsLoaded(generation, names, success, tags);
+        });
+    }
+}
+
+void TagListModel::onDetailsLoaded(quint64 generation, const QStringList &requested, bool success, const QList<GitTagRef> &tags)
+{
+    if (generation != m_generation) {
+        return;
+    }
+    
+    if (!success) {
+        for (const QString &name : requested) {
+            m_requested.remove(name);
+        }
+        return;
+    }
+    
+    int firstRow = m_tags.size();
+    int lastRow = -1;
+    auto markLoaded = [&](int row) {
+        firstRow = qMin(firstRow, row);
+        lastRow = qMax(lastRow, row);
+    };
+    
+    for (const GitTagRef &tag : tags) {
+        auto it = m_rowByName.constFind(tag.name);
+        if (it == m_rowByName.constEnd()) {
+            continue;
+        }
+        m_tags[it.value()] = tag;
+        markLoaded(it.value());
+    }
+    
+    for (const QString &name : requested) {
+        auto it = m_rowByName.constFind(name);
+        if (it != m_rowByName.constEnd() && !m_tags[it.value()].detailsLoaded) {
+            m_tags[it.value()].detailsLoaded = true;
+            markLoaded(it.value());
+        }
+    }
+    
+    if (lastRow >= 0) {
+        emit dataChanged(index(firstRow, 0), index(lastRow, ColumnCount - 1));
+    }
+}
+
+void TagListModel::setLoading(bool loading)
+{
+    if (m_loading != loading) {
+        m_loading = loading;
+        emit loadingChanged(loading);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef TAGLISTMODEL_H
+#define TAGLISTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include "tagquery.h"
+
+class GitManager;
+
+class TagListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        NameColumn,
+        TargetColumn,
+        TaggerColumn,
+        DateColumn,
+        SubjectColumn,
+        ColumnCount
+    };
+    
+    enum Role {
+        TagNameRole = Qt::UserRole,
+        DetailsLoadedRole
+    };
+    
+    explicit TagListModel(GitManager *gitManager, QObject *parent = nullptr);
+    
+    void setQuery(const QString &prefix, int sortOrder);
+    void reload();
+    void clear();
+    const GitTagRef &tagAt(int row) const;
+    bool isLoading() const;
+    bool hasMore() const;
+    
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void loadingChanged(bool loading);
+    void loadFailed(const QString &error);
+
+private slots:
+    void requestQueuedDetails();
+
+private:
+    void requestPage();
+    void onPageLoaded(quint64 generation, const GitTagPage &page);
+    void onDetailsLoaded(quint64 generation, const QStringList &requested, bool success, const QList<GitTagRef> &tags);
+    void queueDetails(const QString &name) const;
+    void setLoading(bool loading);
+    
+    GitManager *m_gitManager;
+    QString m_prefix;
+    int m_sortOrder;
+    QList<GitTagRef> m_tags;
+    QHash<QString, int> m_rowByName;
+    bool m_hasMore;
+    bool m_loading;
+    quint64 m_generation;
+    mutable QSet<QString> m_requested;
+    mutable QStringList m_queued;
+    mutable QTimer m_detailsTimer;
+};
+
+#endif // TAGLISTMODEL_H
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include "tagpanel.h"
+#include "gitmanager.h"
+#include "taglistmodel.h"
+#include <QDateTime>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLocale>
+#include <QSplitter>
+#include <QVBoxLayout>
+
+TagPanel::TagPanel(GitManager *gitManager, QWidget *parent)
+    : QWidget(parent)
+    , m_gitManager(gitManager)
+    , m_model(nullptr)
+    , m_filterEdit(nullptr)
+    , m_sortCombo(nullptr)
+    , m_refreshButton(nullptr)
+    , m_tagView(nullptr)
+    , m_detailsView(nullptr)
+    , m_statusLabel(nullptr)
+    , m_stale(true)
+{
+    setupUI();
+    
+    m_filterTimer.setSingleShot(true);
+    m_filterTimer.setInterval(200);
+    connect(&m_filterTimer, &QTimer::timeout, this, &TagPanel::applyQuery);
+    
+    connect(m_gitManager, &GitManager::repositoryChanged, this, &TagPanel::refresh);
+    connect(m_gitManager, &GitManager::tagsChanged, this, &TagPanel::refresh);
+}
+
+void TagPanel::setupUI()
+{
+    setWindowTitle("Tags");
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    QHBoxLayout *headerLayout = new QHBoxLayout;
+    m_filterEdit = new QLineEdit;
+    m_filterEdit->setPlaceholderText("Filter by prefix (e.g. v2.)");
+    m_filterEdit->setClearButtonEnabled(true);
+    m_sortCombo = new QComboBox;
+    m_sortCombo->addItem("Version (newest first)", TagQuery::VersionDescending);
+    m_sortCombo->addItem("Version (oldest first)", TagQuery::VersionAscending);
+    m_sortCombo->addItem("Name", TagQuery::NameAscending);
+    m_sortCombo->addItem("Date (newest first)", TagQuery::DateDescending);
+    m_refreshButton = new QPushButton("Refresh");
+    m_refreshButton->setMaximumWidth(80);
+    
+    headerLayout->addWidget(m_filterEdit, 1);
+    headerLayout->addWidget(m_sortCombo);
+    headerLayout->addWidget(m_refreshButton);
+    
+    m_model = new TagListModel(m_gitManager, this);
+    
+    m_tagView = new QTreeView;
+    m_tagView->setModel(m_model);
+    m_tagView->setRootIsDecorated(false);
+    m_tagView->setUniformRowHeights(true);
+    m_tagView->setAlternatingRowColors(true);
+    m_tagView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_tagView->header()->setSectionResizeMode(TagListModel::SubjectColumn, QHeaderView::Stretch);
+    m_tagView->setColumnWidth(TagListModel::NameColumn, 200);
+    
+    m_detailsView = new QTextEdit;
+    m_detailsView->setReadOnly(true);
+    m_detailsView->setFont(QFont("Courier New", 9));
+    
+    QSplitter *splitter = new QSplitter(Qt::Vertical);
+    splitter->addWidget(m_tagView);
+    splitter->addWidget(m_detailsView);
+    splitter->setSizes({300, 100});
+    
+    m_statusLabel = new QLabel;
+    
+    layout->addLayout(headerLayout);
+    layout->addWidget(splitter);
+    layout->addWidget(m_statusLabel);
+    
+    connect(m_filterEdit, &QLineEdit::textChanged, this, [this]() {
+        m_filterTimer.start();
+    });
+    connect(m_sortCombo, &QComboBox::currentIndexChanged, this, &TagPanel::applyQuery);
+    connect(m_refreshButton, &QPushButton::clicked, this, &TagPanel::applyQuery);
+    connect(m_model, &TagListModel::loadingChanged, this, &TagPanel::updateStatus);
+    connect(m_model, &TagListModel::rowsInserted, this, &TagPanel::updateStatus);
+    connect(m_model, &TagListModel::modelReset, this, &TagPanel::updateStatus);
+    connect(m_model, &TagListModel::loadFailed, this, &TagPanel::onLoadFailed);
+    connect(m_model, &TagListModel::dataChanged, this, &TagPanel::showCurrentTag);
+    connect(m_tagView->selectionModel(), &QItemSelectionModel::currentRowChanged, this, &TagPanel::showCurrentTag);
+}
+
+void TagPanel::refresh()
+{
+    if (!isVisible()) {
+        m_stale = true;
+        return;
+    }
+    
+    m_stale = false;
+    applyQuery();
+}
+
+void TagPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    if (m_stale) {
+        refresh();
+    }
+}
+
+void TagPanel::applyQuery()
+{
+    m_filterTimer.stop();
+    m_detailsView->clear();
+    
+    if (!m_gitManager->isRepositoryOpen()) {
+        m_model->clear();
+        return;
+    }
+    
+    m_model->setQuery(m_filterEdit->text().trimmed(), m_sortCombo->currentData().toInt());
+}
+
+void TagPanel::updateStatus()
+{
+    if (!m_gitManager->isRepositoryOpen()) {
+        m_statusLabel->setText("No repository opened");
+        return;
+    }
+    
+    const QString count = QLocale().toString(m_model->rowCount());
+    if (m_model->isLoading()) {
+        m_statusLabel->setText(QString("Loading tags... (%1 shown)").arg(count));
+    } else if (m_model->hasMore()) {
+        m_statusLabel->setText(QString("%1 tags shown, scroll for more").arg(count));
+    } else {
+        m_statusLabel->setText(QString("%1 tags").arg(count));
+    }
+}
+
+void TagPanel::showCurrentTag()
+{
+    const QModelIndex current = m_tagView->currentIndex();
+    if (!current.isValid()) {
+        m_detailsView->clear();
+        return;
+    }
+    
+    const GitTagRef &tag = m_model->tagAt(current.row());
+    if (!tag.detailsLoaded) {
+        m_detailsView->setPlainText(tag.name + "\n\nLoading...");
+        return;
+    }
+    
+    QString text = QString("Tag:     %1\n").arg(tag.name);
+    if (tag.isAnnotated()) {
+        text += QString("Object:  %1\n").arg(tag.objectId);
+    }
+    text += QString("Target:  %1 %2\n").arg(tag.targetType, tag.targetId);
+    if (!tag.tagger.isEmpty()) {
+        text += QString("%1 %2\n").arg(tag.isAnnotated() ? "Tagger: " : "Author: ", tag.tagger);
+    }
+    if (tag.time > 0) {
+        text += QString("Date:    %1\n").arg(QDateTime::fromSecsSinceEpoch(tag.time).toString("yyyy-MM-dd HH:mm:ss"));
+    }
+    text += "\n" + tag.message;
+    m_detailsView->setPlainText(text);
+}
+
+void TagPanel::onLoadFailed(const QString &error)
+{
+    m_statusLabel->setText("Failed to list tags: " + error.trimmed());
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#ifndef TAGPANEL_H
+#define TAGPANEL_H
+
+#include <QWidget>
+#include <QComboBox>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QTextEdit>
+#include <QTimer>
+#include <QTreeView>
+
+class GitManager;
+class TagListModel;
+
+class TagPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TagPanel(GitManager *gitManager, QWidget *parent = nullptr);
+
+public slots:
+    void refresh();
+
+protected:
+    void showEvent(QShowEvent *event) override;
+
+private slots:
+    void applyQuery();
+    void updateStatus();
+    void showCurrentTag();
+    void onLoadFailed(const QString &error);
+
+private:
+    void setupUI();
+    
+    GitManager *m_gitManager;
+    TagListModel *m_model;
+    QLineEdit *m_filterEdit;
+    QComboBox *m_sortCombo;
+    QPushButton *m_refreshButton;
+    QTreeView *m_tagView;
+    QTextEdit *m_detailsView;
+    QLabel *m_statusLabel;
+    QTimer m_filterTimer;
+    bool m_stale;
+};
+
+#endif // TAGPANEL_H
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "tagquery.h"
+
+namespace {
+
+const char *TagsPrefix = "refs/tags/";
+const QChar RecordSeparator(0x1e);
+const QChar FieldSeparator(0x1f);
+
+QString escapePattern(const QString &text)
+{
+    QString escaped;
+    escaped.reserve(text.size());
+    for (const QChar c : text) {
+        if (c == '*' || c == '?' || c == '[' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+QString tagName(const QString &refName)
+{
+    return refName.startsWith(TagsPrefix) ? refName.mid(int(qstrlen(TagsPrefix))) : refName;
+}
+
+}
+
+GitTagRef::GitTagRef()
+    : time(0)
+    , detailsLoaded(false)
+{
+}
+
+bool GitTagRef::isAnnotated() const
+{
+    return objectType == "tag";
+}
+
+GitTagPage::GitTagPage()
+    : sortOrder(TagQuery::VersionDescending)
+    , offset(0)
+    , hasMore(false)
+    , success(false)
+{
+}
+
+QStringList TagQuery::patterns(const QString &prefix)
+{
+    if (prefix.isEmpty()) {
+        return {"refs/tags"};
+    }
+    
+    const QString pattern = TagsPrefix + escapePattern(prefix) + "*";
+    return {pattern, pattern + "/**"};
+}
+
+QStringList TagQuery::listArguments(const QString &prefix, SortOrder order)
+{
+    QStringList args;
+    args << "for-each-ref";
+    
+    switch (order) {
+    case VersionDescending:
+        args << "--sort=-version:refname";
+        break;
+    case VersionAscending:
+        args << "--sort=version:refname";
+        break;
+    case NameAscending:
+        args << "--sort=refname";
+        break;
+    case DateDescending:
+        args << "--sort=-creatordate";
+        break;
+    }
+    
+    args << "--format=%(refname:lstrip=2)";
+    args << patterns(prefix);
+    return args;
+}
+
+QStringList TagQuery::detailsArguments(const QStringList &names)
+{
+    QStringList args;
+    args << "for-each-ref"
+         << "--format=%(refname)%1f%(objectname)%1f%(objecttype)%1f%(*objectname)%1f%(*objecttype)"
+            "%1f%(taggername)%1f%(authorname)%1f%(creatordate:unix)%1f%(contents)%1e";
+    for (const QString &name : names) {
+        args << TagsPrefix + escapePattern(name);
+    }
+    return args;
+}
+
+QStringList TagQuery::parseList(const QString &output)
+{
+    return output.split('\n', Qt::SkipEmptyParts);
+}
+
+void TagQuery::slicePage(const QStringList &names, int offset, int limit, GitTagPage &page)
+{
+    page.offset = offset;
+    page.tags.clear();
+    
+    const int end = qMin(names.size(), offset + limit);
+    page.tags.reserve(qMax(0, end - offset));
+    for (int i = offset; i < end; ++i) {
+        GitTagRef tag;
+        tag.name = names.at(i);
+        page.tags.append(tag);
+    }
+    
+    page.hasMore = end < names.size();
+    page.success = true;
+}
+
+QList<GitTagRef> TagQuery::parseDetails(const QString &output)
+{
+    QList<GitTagRef> tags;
+    
+    for (const QString &record : output.split(RecordSeparator, Qt::SkipEmptyParts)) {
+        const QStringList fields = record.split(FieldSeparator);
+        if (fields.size() < 9) {
+            continue;
+        }
+        
+        GitTagRef tag;
+        tag.name = tagName(fields[0].trimmed());
+        tag.objectId = fields[1];
+        tag.objectType = fields[2];
+        tag.targetId = fields[3].isEmpty() ? fields[1] : fields[3];
+        tag.targetType = fields[4].isEmpty() ? fields[2] : fields[4];
+        tag.tagger = fields[5].isEmpty() ? fields[6] : fields[5];
+        tag.time = fields[7].toLongLong();
+        tag.message = fields.mid(8).join(FieldSeparator).trimmed();
+        tag.subject = tag.message.section('\n', 0, 0).trimmed();
+        tag.detailsLoaded = true;
+        tags.append(tag);
+    }
+    
+    return tags;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef TAGQUERY_H
+#define TAGQUERY_H
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+struct GitTagRef {
+    QString name;
+    QString objectId;
+    QString objectType;
+    QString targetId;
+    QString targetType;
+    QString tagger;
+    qint64 time;
+    QString subject;
+    QString message;
+    bool detailsLoaded;
+    
+    GitTagRef();
+    bool isAnnotated() const;
+};
+
+struct GitTagPage {
+    QString prefix;
+    int sortOrder;
+    int offset;
+    QList<GitTagRef> tags;
+    bool hasMore;
+    bool success;
+    QString error;
+    
+    GitTagPage();
+};
+
+class TagQuery
+{
+public:
+    enum SortOrder {
+        VersionDescending,
+        VersionAscending,
+        NameAscending,
+        DateDescending
+    };
+    
+    static const int DefaultPageSize = 200;
+    static const int MaxDetailsBatch = 200;
+    
+    static QStringList patterns(const QString &prefix);
+    static QStringList listArguments(const QString &prefix, SortOrder order);
+    static QStringList detailsArguments(const QStringList &names);
+    
+    static QStringList parseList(const QString &output);
+    static void slicePage(const QStringList &names, int offset, int limit, GitTagPage &page);
+    static QList<GitTagRef> parseDetails(const QString &output);
+};
+
+#endif // TAGQUERY_H
\ No newline at end of file
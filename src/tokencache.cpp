@@ -0,0 +1,64 @@
+#include "tokencache.h"
+#include <QMutexLocker>
+#include <QStringList>
+
+const int TokenCache::ChunkLines;
+
+TokenChunk::TokenChunk()
+    : startState(SyntaxTokenizer::Normal)
+    , endState(SyntaxTokenizer::Normal)
+{
+}
+
+TokenCache::TokenCache()
+{
+    m_cache.setMaxCost(CacheBudget);
+}
+
+TokenCache *TokenCache::instance()
+{
+    static TokenCache cache;
+    return &cache;
+}
+
+bool TokenCache::lookup(const QString &blobKey, int chunk, TokenChunk &result) const
+{
+    QMutexLocker locker(&m_mutex);
+    const TokenChunk *cached = m_cache.object(blobKey + '#' + QString::number(chunk));
+    if (!cached) {
+        return false;
+    }
+    result = *cached;
+    return true;
+}
+
+void TokenCache::insert(const QString &blobKey, int chunk, const TokenChunk &tokens)
+{
+    int cost = tokens.lines.size();
+    for (const SyntaxLineTokens &line : tokens.lines) {
+        cost += line.size();
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(blobKey + '#' + QString::number(chunk), new TokenChunk(tokens), qMax(1, cost));
+}
+
+void TokenCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+TokenChunk TokenCache::tokenize(SyntaxTokenizer::Language language, const QStringList &lines, int startState)
+{
+    TokenChunk chunk;
+    chunk.startState = startState;
+    chunk.lines.reserve(lines.size());
+    
+    int state = startState;
+    for (const QString &line : lines) {
+        chunk.lines.append(SyntaxTokenizer::tokenizeLine(language, line, state));
+    }
+    chunk.endState = state;
+    return chunk;
+}
\ No newline at end of file
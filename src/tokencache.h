@@ -0,0 +1,41 @@
+#ifndef TOKENCACHE_H
+#define TOKENCACHE_H
+
+#include <QCache>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "syntaxtokenizer.h"
+
+struct TokenChunk {
+    QVector<SyntaxLineTokens> lines;
+    int startState;
+    int endState;
+    
+    TokenChunk();
+};
+
+class TokenCache
+{
+public:
+    static const int ChunkLines = 256;
+    
+    static TokenCache *instance();
+    
+    bool lookup(const QString &blobKey, int chunk, TokenChunk &result) const;
+    void insert(const QString &blobKey, int chunk, const TokenChunk &tokens);
+    void clear();
+    
+    static TokenChunk tokenize(SyntaxTokenizer::Language language, const QStringList &lines, int startState);
+
+private:
+    TokenCache();
+    
+    static const int CacheBudget = 4 * 1024 * 1024;
+    
+    mutable QMutex m_mutex;
+    QCache<QString, TokenChunk> m_cache;
+};
+
+#endif // TOKENCACHE_H
\ No newline at end of file
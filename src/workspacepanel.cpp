@@ -0,0 +1,277 @@
+#include "workspacepanel.h"
+#include "gittracer.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QDir>
+#include <QFont>
+#include <QMessageBox>
+#include <QSettings>
+#include <QBrush>
+#include <QColor>
+
+namespace {
+
+const int MinimumPollIntervalMs = 5000;
+const int MaximumPollIntervalMs = 5 * 60 * 1000;
+
+}
+
+WorkspacePanel::WorkspacePanel(GitCommandScheduler *scheduler, QWidget *parent)
+    : QWidget(parent)
+    , m_listView(nullptr)
+    , m_model(nullptr)
+    , m_titleLabel(nullptr)
+    , m_addButton(nullptr)
+    , m_removeButton(nullptr)
+    , m_scheduler(scheduler)
+{
+    setupUI();
+    loadRepositories();
+    
+    connect(&m_pollTimer, &QTimer::timeout, this, &WorkspacePanel::pollDueRepositories);
+    m_pollTimer.start(1000);
+}
+
+void WorkspacePanel::setupUI()
+{
+    setWindowTitle("Workspace");
+    
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    
+    QHBoxLayout *headerLayout = new QHBoxLayout;
+    m_titleLabel = new QLabel("Repositories");
+    m_titleLabel->setStyleSheet("font-weight: bold; font-size: 12px; padding: 5px;");
+    
+    m_addButton = new QPushButton("Add");
+    m_addButton->setMaximumWidth(60);
+    m_removeButton = new QPushButton("Remove");
+    m_removeButton->setMaximumWidth(70);
+    
+    headerLayout->addWidget(m_titleLabel);
+    headerLayout->addStretch();
+    headerLayout->addWidget(m_addButton);
+    headerLayout->addWidget(m_removeButton);
+    
+    m_listView = new QListView;
+    m_model = new QStandardItemModel(this);
+    m_listView->setModel(m_model);
+    m_listView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_listView->setAlternatingRowColors(true);
+    
+    layout->addLayout(headerLayout);
+    layout->addWidget(m_listView);
+    
+    connect(m_addButton, &QPushButton::clicked, this, &WorkspacePanel::addRepositoryFromDialog);
+    connect(m_removeButton, &QPushButton::clicked, this, &WorkspacePanel::removeSelectedRepository);
+    connect(m_listView, &QListView::activated, this, &WorkspacePanel::onItemActivated);
+    connect(m_listView, &QListView::doubleClicked, this, &WorkspacePanel::onItemActivated);
+}
+
+void WorkspacePanel::loadRepositories()
+{
+    QSettings settings;
+    const QStringList paths = settings.value("workspace/repositories").toStringList();
+    for (const QString &path : paths) {
+        addRepository(path);
+    }
+}
+
+void WorkspacePanel::saveRepositories() const
+{
+    QSettings settings;
+    settings.setValue("workspace/repositories", repositories());
+}
+
+QStringList WorkspacePanel::repositories() const
+{
+    QStringList paths;
+    for (int row = 0; row < m_model->rowCount(); ++row) {
+        paths.append(m_model->item(row)->data(Qt::UserRole).toString());
+    }
+    return paths;
+}
+
+void WorkspacePanel::addRepository(const QString &path)
+{
+    const QString canonical = QDir(path).absolutePath();
+    if (canonical.isEmpty() || m_repositories.contains(canonical)) {
+        return;
+    }
+    
+    QStandardItem *item = new QStandardItem(QFileInfo(canonical).fileName());
+    item->setData(canonical, Qt::UserRole);
+    item->setToolTip(canonical);
+    m_model->appendRow(item);
+    
+    RepositoryState state;
+    state.item = item;
+    state.hasSummary = false;
+    state.polling = false;
+    state.failed = false;
+    state.intervalMs = MinimumPollIntervalMs;
+    state.nextPoll = QDateTime::currentDateTimeUtc();
+    m_repositories.insert(canonical, state);
+    
+    updateItem(canonical);
+    saveRepositories();
+}
+
+void WorkspacePanel::removeRepository(const QString &path)
+{
+    auto it = m_repositories.find(path);
+    if (it == m_repositories.end()) {
+        return;
+    }
+    
+    m_model->removeRow(it->item->row());
+    m_repositories.erase(it);
+    saveRepositories();
+}
+
+void WorkspacePanel::setActiveRepository(const QString &path)
+{
+    m_activeRepository = QDir(path).absolutePath();
+    addRepository(m_activeRepository);
+    
+    for (auto it = m_repositories.begin(); it != m_repositories.end(); ++it) {
+        updateItem(it.key());
+    }
+    pollNow(m_activeRepository);
+}
+
+void WorkspacePanel::pollNow(const QString &path)
+{
+    auto it = m_repositories.find(path);
+    if (it == m_repositories.end()) {
+        return;
+    }
+    
+    it->intervalMs = MinimumPollIntervalMs;
+    it->nextPoll = QDateTime::currentDateTimeUtc();
+    pollDueRepositories();
+}
+
+void WorkspacePanel::addRepositoryFromDialog()
+{
+    QString dir = QFileDialog::getExistingDirectory(this, "Add Repository to Workspace", QString(), QFileDialog::ShowDirsOnly);
+    if (dir.isEmpty()) {
+        return;
+    }
+    
+    if (!QDir(dir).exists(".git")) {
+        QMessageBox::warning(this, "Error", "Not a valid Git repository.");
+        return;
+    }
+    
+    addRepository(dir);
+}
+
+void WorkspacePanel::removeSelectedRepository()
+{
+    const QModelIndex index = m_listView->currentIndex();
+    if (index.isValid()) {
+        removeRepository(index.data(Qt::UserRole).toString());
+    }
+}
+
+void WorkspacePanel::onItemActivated(const QModelIndex &index)
+{
+    if (index.isValid()) {
+        const QString path = index.data(Qt::UserRole).toString();
+        if (path != m_activeRepository) {
+            emit repositoryActivated(path);
+        }
+    }
+}
+
+void WorkspacePanel::pollDueRepositories()
+{
+    GitTraceAction action("Workspace poll");
+    
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    
+    for (auto it = m_repositories.begin(); it != m_repositories.end(); ++it) {
+        if (!it->polling && it->nextPoll <= now) {
+            schedulePoll(it.key());
+        }
+    }
+}
+
+void WorkspacePanel::schedulePoll(const QString &path)
+{
+    RepositoryState &state = m_repositories[path];
+    state.polling = true;
+    
+    m_scheduler->submit(path, GitManager::repositorySummaryArguments(), GitCommandScheduler::Background, this,
+        [this, path](const GitCommandResult &result) {
+            onSummaryReady(path, result.success, GitManager::parseRepositorySummary(QString::fromUtf8(result.output)));
+        });
+}
+
+void WorkspacePanel::onSummaryReady(const QString &path, bool success, const GitRepositorySummary &summary)
+{
+    auto it = m_repositories.find(path);
+    if (it == m_repositories.end()) {
+        return;
+    }
+    
+    it->polling = false;
+    
+    const bool changed = success
+        ? !it->hasSummary || it->summary != summary || it->failed
+        : !it->failed;
+    if (changed && success) {
+        it->intervalMs = MinimumPollIntervalMs;
+    } else {
+        it->intervalMs = qMin(it->intervalMs * 2, MaximumPollIntervalMs);
+    }
+    it->nextPoll = QDateTime::currentDateTimeUtc().addMSecs(it->intervalMs);
+    it->failed = !success;
+    
+    if (success) {
+        it->summary = summary;
+        it->hasSummary = true;
+    }
+    
+    if (changed) {
+        updateItem(path);
+    }
+}
+
+void WorkspacePanel::updateItem(const QString &path)
+{
+    auto it = m_repositories.find(path);
+    if (it == m_repositories.end()) {
+        return;
+    }
+    
+    QString text = QFileInfo(path).fileName();
+    
+    if (it->failed) {
+        text += "  (unavailable)";
+    } else if (it->hasSummary) {
+        const GitRepositorySummary &summary = it->summary;
+        text += QString("  [%1]").arg(summary.branch);
+        if (summary.changedFiles > 0) {
+            text += QString("  * %1 changed").arg(summary.changedFiles);
+        }
+        if (summary.ahead > 0 || summary.behind > 0) {
+            text += QString("  +%1 -%2").arg(summary.ahead).arg(summary.behind);
+        }
+    }
+    
+    it->item->setText(text);
+    
+    QFont font = it->item->font();
+    font.setBold(path == m_activeRepository);
+    it->item->setFont(font);
+    
+    if (it->hasSummary && it->summary.changedFiles > 0) {
+        it->item->setForeground(QBrush(QColor(180, 120, 0)));
+    } else {
+        it->item->setForeground(QBrush());
+    }
+}
\ No newline at end of file
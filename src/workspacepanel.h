@@ -0,0 +1,67 @@
+#ifndef WORKSPACEPANEL_H
+#define WORKSPACEPANEL_H
+
+#include <QWidget>
+#include <QListView>
+#include <QStandardItemModel>
+#include <QPushButton>
+#include <QLabel>
+#include <QTimer>
+#include <QHash>
+#include <QDateTime>
+#include "gitmanager.h"
+
+class WorkspacePanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit WorkspacePanel(GitCommandScheduler *scheduler, QWidget *parent = nullptr);
+    
+    void addRepository(const QString &path);
+    void removeRepository(const QString &path);
+    QStringList repositories() const;
+    
+    void setActiveRepository(const QString &path);
+    void pollNow(const QString &path);
+
+signals:
+    void repositoryActivated(const QString &path);
+
+private slots:
+    void addRepositoryFromDialog();
+    void removeSelectedRepository();
+    void onItemActivated(const QModelIndex &index);
+    void pollDueRepositories();
+
+private:
+    struct RepositoryState {
+        QStandardItem *item;
+        GitRepositorySummary summary;
+        bool hasSummary;
+        bool polling;
+        bool failed;
+        int intervalMs;
+        QDateTime nextPoll;
+    };
+    
+    void setupUI();
+    void loadRepositories();
+    void saveRepositories() const;
+    void updateItem(const QString &path);
+    void schedulePoll(const QString &path);
+    void onSummaryReady(const QString &path, bool success, const GitRepositorySummary &summary);
+    
+    QListView *m_listView;
+    QStandardItemModel *m_model;
+    QLabel *m_titleLabel;
+    QPushButton *m_addButton;
+    QPushButton *m_removeButton;
+    
+    QHash<QString, RepositoryState> m_repositories;
+    QString m_activeRepository;
+    QTimer m_pollTimer;
+    GitCommandScheduler *m_scheduler;
+};
+
+#endif // WORKSPACEPANEL_H
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include <QHash>
+#include <QProcess>
+#include <QProcessEnvironment>
+#include <QTemporaryDir>
+#include <QtTest>
+#include "commitgraph.h"
+#include "gitmanager.h"
+
+namespace {
+
+struct LogEntry {
+    QByteArray tree;
+    QList<QByteArray> parents;
+    qint64 commitTime;
+};
+
+}
+
+class CommitGraphTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void singleFile();
+    void splitChain();
+    void historyFromGraph();
+
+private:
+    bool git(const QStringList &args, QByteArray *output = nullptr);
+    bool commit(qint64 time, const QString &subject);
+    void buildHistory();
+    void compareWithLog();
+    
+    QTemporaryDir m_dir;
+};
+
+bool CommitGraphTest::git(const QStringList &args, QByteArray *output)
+{
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    environment.insert("GIT_AUTHOR_NAME", "Test");
+    environment.insert("GIT_AUTHOR_EMAIL", "test@example.com");
+    environment.insert("GIT_COMMITTER_NAME", "Test");
+    environment.insert("GIT_COMMITTER_EMAIL", "test@example.com");
+    environment.insert("GIT_CONFIG_NOSYSTEM", "1");
+    environment.insert("HOME", m_dir.path());
+    
+    QProcess process;
+    process.setProcessEnvironment(environment);
+    process.setWorkingDirectory(m_dir.path());
+    process.start("git", args);
+    if (!process.waitForFinished(30000) || process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0) {
+        qWarning() << "git" << args << process.readAllStandardError();
+        return false;
+    }
+    
+    if (output) {
+        *output = process.readAllStandardOutput();
+    }
+    return true;
+}
+
+bool CommitGraphTest::commit(qint64 time, const QString &subject)
+{
+    const QString date = QString("@%1 +0000").arg(time);
+    qputenv("GIT_AUTHOR_DATE", date.toLatin1());
+    qputenv("GIT_COMMITTER_DATE", date.toLatin1());
+    const bool ok = git({"commit", "-q", "--allow-empty", "-m", subject});
+    qunsetenv("GIT_AUTHOR_DATE");
+    qunsetenv("GIT_COMMITTER_DATE");
+    return ok;
+}
+
+void CommitGraphTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    QVERIFY(git({"init", "-q", "-b", "main"}));
+    QVERIFY(git({"config", "commitGraph.generationVersion", "2"}));
+    buildHistory();
+}
+
+void CommitGraphTest::buildHistory()
+{
+    QVERIFY(commit(1600000000, "root"));
+    QVERIFY(git({"branch", "left"}));
+    QVERIFY(git({"branch", "right"}));
+    QVERIFY(commit(1600000100, "main"));
+    QVERIFY(git({"checkout", "-q", "left"}));
+    QVERIFY(commit(1600000200, "left"));
+    QVERIFY(git({"checkout", "-q", "right"}));
+    QVERIFY(commit(1600000300, "right"));
+    QVERIFY(git({"checkout", "-q", "main"}));
+    
+    // Three parents force the EDGE chunk.
+    qputenv("GIT_COMMITTER_DATE", "@1600000400 +0000");
+    QVERIFY(git({"merge", "-q", "--no-edit", "left", "right"}));
+    qunsetenv("GIT_COMMITTER_DATE");
+    
+    // A child dated far before its parent needs a corrected date offset
+    // above 2^31, which git stores in the GDO2 chunk.
+    QVERIFY(commit(2208988800, "future"));
+    QVERIFY(commit(100000, "past"));
+}
+
+void CommitGraphTest::compareWithLog()
+{
+    QByteArray output;
+    QVERIFY(git({"log", "--all", "--topo-order", "--reverse", "--format=%H %T %ct %P"}, &output));
+    
+    QHash<QByteArray, LogEntry> entries;
+    QList<QByteArray> order;
+    for (const QByteArray &line : output.split('\n')) {
+        const QList<QByteArray> fields = line.trimmed().split(' ');
+        if (fields.size() < 3) {
+            continue;
+        }
+        LogEntry entry;
+        entry.tree = QByteArray::fromHex(fields[1]);
+        entry.commitTime = fields[2].toLongLong();
+        for (int i = 3; i < fields.size(); ++i) {
+            entry.parents.append(QByteArray::fromHex(fields[i]));
+        }
+        const QByteArray id = QByteArray::fromHex(fields[0]);
+        entries.insert(id, entry);
+        order.append(id);
+    }
+    QVERIFY(!order.isEmpty());
+    
+    CommitGraph graph;
+    QVERIFY(graph.load(m_dir.filePath(".git/objects")));
+    QCOMPARE(graph.commitCount(), quint32(order.size()));
+    QVERIFY(graph.hasCorrectedDates());
+    
+    QHash<QByteArray, quint64> correctedDates;
+    for (const QByteArray &id : order) {
+        const LogEntry &entry = entries.value(id);
+        const quint32 position = graph.findCommit(id);
+        QVERIFY(position != CommitGraph::InvalidPosition);
+        QCOMPARE(graph.commitId(position), id);
+        QCOMPARE(graph.rootTree(position), entry.tree);
+        QCOMPARE(graph.commitTime(position), entry.commitTime);
+        
+        const QVector<quint32> parents = graph.parents(position);
+        QCOMPARE(parents.size(), entry.parents.size());
+        quint64 corrected = quint64(entry.commitTime);
+        for (int i = 0; i < parents.size(); ++i) {
+            QCOMPARE(graph.commitId(parents[i]), entry.parents[i]);
+            corrected = qMax(corrected, correctedDates.value(entry.parents[i]) + 1);
+        }
+        correctedDates.insert(id, corrected);
+        QCOMPARE(graph.generation(position), corrected);
+    }
+    
+    const quint32 head = graph.findCommit(order.last());
+    const QVector<quint32> walked = graph.walk({head});
+    QCOMPARE(walked.size(), order.size());
+    QHash<quint32, int> walkIndex;
+    for (int i = 0; i < walked.size(); ++i) {
+        walkIndex.insert(walked[i], i);
+    }
+    for (quint32 position : walked) {
+        for (quint32 parent : graph.parents(position)) {
+            QVERIFY(walkIndex.value(parent) > walkIndex.value(position));
+        }
+    }
+}
+
+void CommitGraphTest::singleFile()
+{
+    QVERIFY(git({"commit-graph", "write", "--reachable"}));
+    QVERIFY(QFile::exists(m_dir.filePath(".git/objects/info/commit-graph")));
+    compareWithLog();
+}
+
+void CommitGraphTest::splitChain()
+{
+    QVERIFY(commit(1600001000, "second layer"));
+    QVERIFY(commit(1600001100, "second layer tip"));
+    QVERIFY(git({"commit-graph", "write", "--reachable", "--split=no-merge"}));
+    
+    QFile chain(m_dir.filePath(".git/objects/info/commit-graphs/commit-graph-chain"));
+    QVERIFY(chain.open(QIODevice::ReadOnly));
+    QVERIFY(chain.readAll().trimmed().split('\n').size() >= 2);
+    compareWithLog();
+}
+
+void CommitGraphTest::historyFromGraph()
+{
+    QByteArray expected;
+    QVERIFY(git({"rev-list", "HEAD"}, &expected));
+    
+    GitManager gitManager;
+    QVERIFY(gitManager.openRepository(m_dir.path()));
+    const QList<GitCommit> commits = gitManager.getCommitHistory(1000);
+    
+    QStringList hashes;
+    for (const GitCommit &commit : commits) {
+        hashes.append(commit.hash);
+    }
+    QStringList expectedHashes = QString::fromLatin1(expected).split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(hashes.size(), expectedHashes.size());
+    hashes.sort();
+    expectedHashes.sort();
+    QCOMPARE(hashes, expectedHashes);
+}
+
+QTEST_GUILESS_MAIN(CommitGraphTest)
+
+#include "commitgraphtest.moc"
\ No newline at end of file